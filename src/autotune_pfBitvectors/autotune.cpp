@@ -0,0 +1,432 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <nanobench.h>
+#include <optional>
+#include <pfBitvectors/pfBitvectors.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* Auto tuning: benchmarks a grid of configurations (l1/l0 sizes, Align, shift_and_count, paired, interleaved, word
+ * based bitsets) on a sample of the user's data and queries and recommends the fastest one, optionally
+ * within a space budget. The result is written as json profile and/or as header with a type alias.
+ *
+ *   autotune_pfBitvectors bitvector|string --data <file> [options]
+ *
+ *   --data <file>        sample of the data
+ *                          bitvector: one entry per byte, 0/'0' or 1/'1', whitespace is ignored
+ *                          string:    one symbol per byte, line breaks are ignored, at most 255 distinct symbols
+ *   --queries <file>     sample of the queries, one per line (default: uniform random rank queries)
+ *                          rank <pos> [<symb>]
+ *                          prefix_rank <pos> <symb>   (strings only)
+ *                          all_ranks <pos>            (strings only)
+ *                          symbol <pos>
+ *                        <symb> is a single character or the byte value of the symbol
+ *   --random <n>         number of random rank queries, if no query file is given (default 1'000'000)
+ *   --max-bits <x>       only recommend configurations with at most x bits per entry
+ *   --repeats <n>        measurements per configuration, the median is used (default 5)
+ *   --json <file>        write all measurements and the recommendation as json
+ *   --header <file>      write a header with the recommended configuration
+ *   --alias <name>       name of the alias in the header (default Bitvector or String)
+ */
+
+namespace {
+
+enum class Op : uint8_t { Rank, PrefixRank, AllRanks, Symbol };
+
+struct Query {
+    Op       op;
+    uint8_t  symb;
+    uint64_t pos;
+};
+
+struct Result {
+    std::string type;
+    double      nsPerQuery;
+    double      bitsPerEntry;
+};
+
+struct Options {
+    bool                  isString{};
+    std::filesystem::path data;
+    std::filesystem::path queries;
+    size_t                random{1'000'000};
+    std::optional<double> maxBits;
+    size_t                repeats{5};
+    std::filesystem::path json;
+    std::filesystem::path header;
+    std::string           alias;
+};
+
+auto readFile(std::filesystem::path const& path) -> std::string {
+    auto ifs = std::ifstream{path, std::ios::binary};
+    if (!ifs) {
+        throw std::runtime_error{"can not open " + path.string()};
+    }
+    return {std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+}
+
+// entries of the sample, strings are mapped to 0...k-1 (in order of their byte value)
+struct Sample {
+    std::vector<uint8_t>  text;
+    std::array<int, 256>  rankOf;   // mapped symbol of each byte, -1 if it does not occur
+    size_t                sigma{};  // number of distinct symbols
+};
+
+auto loadSample(Options const& opt) -> Sample {
+    auto content = readFile(opt.data);
+    auto s = Sample{};
+    s.rankOf.fill(-1);
+    if (!opt.isString) {
+        for (unsigned char c : content) {
+            if (c == 0 || c == '0')      s.text.push_back(0);
+            else if (c == 1 || c == '1') s.text.push_back(1);
+            else if (!std::isspace(c)) {
+                throw std::runtime_error{fmt::format("unexpected byte {} in bit vector data", int(c))};
+            }
+        }
+        s.rankOf[0] = s.rankOf['0'] = 0;
+        s.rankOf[1] = s.rankOf['1'] = 1;
+        s.sigma = 2;
+        return s;
+    }
+    auto occurs = std::array<bool, 256>{};
+    for (unsigned char c : content) {
+        if (c != '\n' && c != '\r') occurs[c] = true;
+    }
+    for (size_t c{0}; c < occurs.size(); ++c) {
+        if (occurs[c]) s.rankOf[c] = s.sigma++;
+    }
+    if (s.sigma > 255) {
+        throw std::runtime_error{"strings with more than 255 distinct symbols are not supported"};
+    }
+    s.text.reserve(content.size());
+    for (unsigned char c : content) {
+        if (c != '\n' && c != '\r') s.text.push_back(s.rankOf[c]);
+    }
+    return s;
+}
+
+auto loadQueries(Options const& opt, Sample const& sample) -> std::vector<Query> {
+    auto n = sample.text.size();
+    auto r = std::vector<Query>{};
+    if (opt.queries.empty()) {
+        auto rng = ankerl::nanobench::Rng{};
+        for (size_t i{0}; i < opt.random; ++i) {
+            r.push_back({Op::Rank, uint8_t(rng.bounded(sample.sigma)), rng.bounded(n+1)});
+        }
+        return r;
+    }
+
+    auto ifs  = std::ifstream{opt.queries};
+    if (!ifs) {
+        throw std::runtime_error{"can not open " + opt.queries.string()};
+    }
+    auto line = std::string{};
+    for (size_t lineNr{1}; std::getline(ifs, line); ++lineNr) {
+        auto fail = [&](std::string const& msg) {
+            return std::runtime_error{fmt::format("{}:{}: {}", opt.queries.string(), lineNr, msg)};
+        };
+        auto ss   = std::stringstream{line};
+        auto name = std::string{};
+        auto q    = Query{};
+        if (!(ss >> name)) continue; // empty line
+        if      (name == "rank")        q.op = Op::Rank;
+        else if (name == "prefix_rank") q.op = Op::PrefixRank;
+        else if (name == "all_ranks")   q.op = Op::AllRanks;
+        else if (name == "symbol")      q.op = Op::Symbol;
+        else throw fail("unknown query " + name);
+
+        if (!opt.isString && (q.op == Op::PrefixRank || q.op == Op::AllRanks)) {
+            throw fail(name + " is only supported by strings");
+        }
+        if (!(ss >> q.pos)) throw fail("missing position");
+        if (q.pos > n || (q.op == Op::Symbol && q.pos == n)) throw fail("position out of range");
+
+        if (opt.isString && (q.op == Op::Rank || q.op == Op::PrefixRank)) {
+            auto symb = std::string{};
+            if (!(ss >> symb)) throw fail("missing symbol");
+            auto byte = (symb.size() == 1) ? static_cast<unsigned char>(symb[0]) : std::stoul(symb);
+            if (byte > 255 || sample.rankOf[byte] < 0) throw fail("symbol does not occur in the data");
+            q.symb = sample.rankOf[byte];
+        }
+        r.push_back(q);
+    }
+    if (r.empty()) {
+        throw std::runtime_error{"no queries in " + opt.queries.string()};
+    }
+    return r;
+}
+
+template <typename T>
+auto runQueries(T const& v, std::vector<Query> const& queries) -> uint64_t {
+    constexpr bool isString = requires() { T::Sigma; };
+    uint64_t checksum{};
+    for (auto const& q : queries) {
+        switch (q.op) {
+        case Op::Rank:
+            if constexpr (isString) checksum += v.rank(q.pos, q.symb);
+            else                    checksum += v.rank(q.pos);
+            break;
+        case Op::PrefixRank:
+            if constexpr (isString) checksum += v.prefix_rank(q.pos, q.symb);
+            break;
+        case Op::AllRanks:
+            // every entry, so none of the ranks can be optimized away
+            if constexpr (isString) {
+                for (auto r : v.all_ranks(q.pos)) {
+                    checksum += r;
+                }
+            }
+            break;
+        case Op::Symbol:
+            checksum += v.symbol(q.pos);
+            break;
+        }
+    }
+    return checksum;
+}
+
+// median ns per query of `repeats` measurements, each running the queries for at least 50ms
+template <typename T>
+auto evaluate(std::string type, Sample const& sample, std::vector<Query> const& queries, size_t repeats) -> Result {
+    using Clock = std::chrono::steady_clock;
+    auto v = T{sample.text};
+    ankerl::nanobench::doNotOptimizeAway(runQueries(v, queries)); // warm up
+
+    auto times = std::vector<double>{};
+    for (size_t r{0}; r < repeats; ++r) {
+        size_t ct{0};
+        auto start = Clock::now();
+        auto now   = start;
+        do {
+            ankerl::nanobench::doNotOptimizeAway(runQueries(v, queries));
+            ct += queries.size();
+            now = Clock::now();
+        } while (now - start < std::chrono::milliseconds{50});
+        times.push_back(std::chrono::duration<double, std::nano>(now - start).count() / ct);
+    }
+    std::ranges::nth_element(times, times.begin() + times.size() / 2);
+
+    auto result = Result{std::move(type), times[times.size() / 2], v.space_usage() * 8. / sample.text.size()};
+    fmt::print(stderr, "{:>10.2f} ns/query {:>8.3f} bits/entry  {}\n", result.nsPerQuery, result.bitsPerEntry, result.type);
+    return result;
+}
+
+/* registers a candidate, the spelled type is used for the generated header
+ * (the grids are macros as well, so l1 is substituted before it is spelled)
+ */
+#define PFB_CANDIDATE(...) results.push_back(evaluate<__VA_ARGS__>(#__VA_ARGS__, sample, queries, opt.repeats))
+
+//                                                         l1, l0,    shift_and_count, Align
+#define PFB_BITVECTOR_GRID(L1)                                                            \
+    PFB_CANDIDATE(seqan::pfb::Bitvector2L<L1, 65536, false, true>);                      \
+    PFB_CANDIDATE(seqan::pfb::Bitvector2L<L1, 65536, true, true>);                       \
+    PFB_CANDIDATE(seqan::pfb::Bitvector2L<L1, 65536, false, false>);                     \
+    /*                                      l1, l0,    Align, ShiftAndCount */            \
+    PFB_CANDIDATE(seqan::pfb::PairedBitvector2L<L1, 65536, true, false>);                \
+    PFB_CANDIDATE(seqan::pfb::PairedBitvector2L<L1, 65536, true, true>)
+
+#define PFB_STRING_GRID(L1)                                                               \
+    PFB_CANDIDATE(seqan::pfb::FlattenedBitvectors2L<Sigma, L1, 65536>);                  \
+    PFB_CANDIDATE(seqan::pfb::PairedFlattenedBitvectors2L<Sigma, L1, 65536>)
+
+auto tuneBitvectors(Options const& opt, Sample const& sample, std::vector<Query> const& queries) -> std::vector<Result> {
+    auto results = std::vector<Result>{};
+    PFB_BITVECTOR_GRID(64);
+    PFB_BITVECTOR_GRID(128);
+    PFB_BITVECTOR_GRID(256);
+    PFB_BITVECTOR_GRID(512);
+    PFB_BITVECTOR_GRID(1024);
+    PFB_BITVECTOR_GRID(2048);
+    PFB_CANDIDATE(seqan::pfb::Bitvector2LWord<64, 65536>);
+    PFB_CANDIDATE(seqan::pfb::Bitvector2LWord<512, 65536>);
+    PFB_CANDIDATE(seqan::pfb::PairedBitvector2LWord<512, 65536>);
+    PFB_CANDIDATE(seqan::pfb::Bitvector2L<64, 256>);
+    PFB_CANDIDATE(seqan::pfb::Bitvector2L<512, 4096>);
+    return results;
+}
+
+// the spelled types keep Sigma as template parameter
+template <size_t Sigma>
+auto tuneStrings(Options const& opt, Sample const& sample, std::vector<Query> const& queries) -> std::vector<Result> {
+    auto results = std::vector<Result>{};
+    PFB_STRING_GRID(64);
+    PFB_STRING_GRID(128);
+    PFB_STRING_GRID(256);
+    PFB_STRING_GRID(512);
+    PFB_STRING_GRID(1024);
+    PFB_CANDIDATE(seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536, false>);
+    PFB_CANDIDATE(seqan::pfb::FlattenedBitvectors2LWord<Sigma, 512, 65536>);
+    PFB_CANDIDATE(seqan::pfb::PairedFlattenedBitvectors2LWord<Sigma, 512, 65536>);
+    PFB_CANDIDATE(seqan::pfb::InterleavedFlattenedBitvectors2L<Sigma, 512, 65536>);
+    PFB_CANDIDATE(seqan::pfb::InterleavedFlattenedBitvectors2L<Sigma, 1024, 65536>);
+    PFB_CANDIDATE(seqan::pfb::FlattenedBitvectors2L<Sigma, 64, 256>);
+    return results;
+}
+#undef PFB_STRING_GRID
+#undef PFB_BITVECTOR_GRID
+#undef PFB_CANDIDATE
+
+// replaces the template parameter Sigma by its value
+auto spellSigma(std::string type, size_t sigma) -> std::string {
+    for (auto pos = type.find("Sigma"); pos != std::string::npos; pos = type.find("Sigma", pos)) {
+        type.replace(pos, 5, std::to_string(sigma));
+    }
+    return type;
+}
+
+// fastest configuration within the space budget
+auto recommend(std::vector<Result> const& results, std::optional<double> maxBits) -> Result const& {
+    Result const* best{};
+    for (auto const& r : results) {
+        if (maxBits && r.bitsPerEntry > *maxBits) continue;
+        if (!best || r.nsPerQuery < best->nsPerQuery) {
+            best = &r;
+        }
+    }
+    if (!best) {
+        throw std::runtime_error{fmt::format("no configuration uses at most {} bits per entry", *maxBits)};
+    }
+    return *best;
+}
+
+void writeJson(Options const& opt, Sample const& sample, size_t sigma, size_t queries, std::vector<Result> results, Result const& best) {
+    auto ofs = std::ofstream{opt.json};
+    if (!ofs) {
+        throw std::runtime_error{"can not open " + opt.json.string()};
+    }
+    std::ranges::sort(results, {}, &Result::nsPerQuery);
+    auto entry = [&](Result const& r) {
+        return fmt::format("{{\"type\": \"{}\", \"ns_per_query\": {:.3f}, \"bits_per_entry\": {:.6f}}}",
+                           spellSigma(r.type, sigma), r.nsPerQuery, r.bitsPerEntry);
+    };
+    ofs << "{\n";
+    ofs << fmt::format("  \"kind\": \"{}\",\n", opt.isString ? "string" : "bitvector");
+    ofs << fmt::format("  \"sigma\": {},\n", opt.isString ? sigma : 2);
+    ofs << fmt::format("  \"entries\": {},\n", sample.text.size());
+    ofs << fmt::format("  \"queries\": {},\n", queries);
+    if (opt.maxBits) {
+        ofs << fmt::format("  \"max_bits_per_entry\": {},\n", *opt.maxBits);
+    }
+    ofs << fmt::format("  \"recommended\": {},\n", entry(best));
+    ofs << "  \"candidates\": [\n";
+    for (size_t i{0}; i < results.size(); ++i) {
+        ofs << "    " << entry(results[i]) << (i+1 < results.size() ? ",\n" : "\n");
+    }
+    ofs << "  ]\n";
+    ofs << "}\n";
+}
+
+void writeHeader(Options const& opt, Sample const& sample, size_t sigma, size_t queries, Result const& best) {
+    auto ofs = std::ofstream{opt.header};
+    if (!ofs) {
+        throw std::runtime_error{"can not open " + opt.header.string()};
+    }
+    ofs << "// generated by autotune_pfBitvectors\n";
+    ofs << fmt::format("// sample: {} entries of {}, {} queries{}\n", sample.text.size(),
+                       opt.isString ? fmt::format("alphabet size {}", sigma) : std::string{"a bit vector"},
+                       queries, opt.queries.empty() ? " (uniform random rank)" : "");
+    ofs << fmt::format("// measured: {:.2f} ns/query, {:.3f} bits/entry\n", best.nsPerQuery, best.bitsPerEntry);
+    ofs << "#pragma once\n\n";
+    ofs << "#include <cstddef>\n";
+    ofs << "#include <pfBitvectors/pfBitvectors.h>\n\n";
+    ofs << "namespace seqan::pfb::tuned {\n";
+    if (opt.isString) {
+        ofs << fmt::format("template <size_t Sigma>\nusing {} = {};\n", opt.alias.empty() ? "String" : opt.alias, best.type);
+    } else {
+        ofs << fmt::format("using {} = {};\n", opt.alias.empty() ? "Bitvector" : opt.alias, best.type);
+    }
+    ofs << "}\n";
+}
+
+auto parseOptions(int argc, char const* const* argv) -> Options {
+    auto usage = std::string{"usage: autotune_pfBitvectors bitvector|string --data <file> [--queries <file>] [--random <n>] "
+                             "[--max-bits <x>] [--repeats <n>] [--json <file>] [--header <file>] [--alias <name>]"};
+    if (argc < 2) {
+        throw std::runtime_error{usage};
+    }
+    auto opt  = Options{};
+    auto kind = std::string{argv[1]};
+    if      (kind == "bitvector") opt.isString = false;
+    else if (kind == "string")    opt.isString = true;
+    else throw std::runtime_error{usage};
+
+    for (int i{2}; i < argc; ++i) {
+        auto arg   = std::string{argv[i]};
+        if (i+1 == argc) {
+            throw std::runtime_error{"missing value of " + arg};
+        }
+        auto value = std::string{argv[++i]};
+        if      (arg == "--data")     opt.data     = value;
+        else if (arg == "--queries")  opt.queries  = value;
+        else if (arg == "--random")   opt.random   = std::stoull(value);
+        else if (arg == "--max-bits") opt.maxBits  = std::stod(value);
+        else if (arg == "--repeats")  opt.repeats  = std::max<size_t>(1, std::stoull(value));
+        else if (arg == "--json")     opt.json     = value;
+        else if (arg == "--header")   opt.header   = value;
+        else if (arg == "--alias")    opt.alias    = value;
+        else throw std::runtime_error{"unknown option " + arg + "\n" + usage};
+    }
+    if (opt.data.empty()) {
+        throw std::runtime_error{usage};
+    }
+    return opt;
+}
+}
+
+int main(int argc, char const* const* argv) {
+    try {
+        auto opt     = parseOptions(argc, argv);
+        auto sample  = loadSample(opt);
+        if (sample.text.empty()) {
+            throw std::runtime_error{"no entries in " + opt.data.string()};
+        }
+        auto queries = loadQueries(opt, sample);
+
+        // strings are benchmarked with the smallest supported alphabet that fits the sample
+        size_t sigma{2};
+        auto results = std::vector<Result>{};
+        if (!opt.isString) {
+            results = tuneBitvectors(opt, sample, queries);
+        } else if (sample.sigma <= 4) {
+            sigma = 4;   results = tuneStrings<4>(opt, sample, queries);
+        } else if (sample.sigma <= 5) {
+            sigma = 5;   results = tuneStrings<5>(opt, sample, queries);
+        } else if (sample.sigma <= 16) {
+            sigma = 16;  results = tuneStrings<16>(opt, sample, queries);
+        } else if (sample.sigma <= 21) {
+            sigma = 21;  results = tuneStrings<21>(opt, sample, queries);
+        } else {
+            sigma = 255; results = tuneStrings<255>(opt, sample, queries);
+        }
+
+        auto const& best = recommend(results, opt.maxBits);
+        fmt::print("recommended: {} ({:.2f} ns/query, {:.3f} bits/entry)\n", spellSigma(best.type, sigma), best.nsPerQuery, best.bitsPerEntry);
+        if (!opt.json.empty()) {
+            writeJson(opt, sample, sigma, queries.size(), results, best);
+        }
+        if (!opt.header.empty()) {
+            writeHeader(opt, sample, sigma, queries.size(), best);
+        }
+    } catch (std::exception const& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
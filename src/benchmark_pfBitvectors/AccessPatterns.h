@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <nanobench.h>
+#include <vector>
+
+/* Query generators that follow the access patterns of real workloads instead of uniform random positions
+ *
+ * Each pattern answers one step per call of operator() and returns a value to pass to doNotOptimizeAway.
+ * Strings are queried via rank(idx, symb) and symbol(idx); bit vectors are wrapped by BitvectorAsString.
+ * The strings are treated as a BWT: C[c] is the number of symbols smaller than c, LF(i) = C[s[i]] + rank(i, s[i]).
+ */
+namespace patterns {
+
+// views a bit vector as a string over {0, 1}
+template <typename Vector>
+struct BitvectorAsString {
+    Vector const& vec;
+
+    auto symbol(size_t idx) const -> uint8_t {
+        return vec.symbol(idx);
+    }
+
+    auto rank(size_t idx, uint8_t symb) const -> uint64_t {
+        auto r = vec.rank(idx);
+        return symb ? r : idx - r;
+    }
+};
+
+// C[c] = number of symbols smaller than c, C[Sigma] = size
+template <size_t Sigma, typename String>
+auto countSmaller(String const& str, size_t size) -> std::array<uint64_t, Sigma+1> {
+    auto C = std::array<uint64_t, Sigma+1>{};
+    for (size_t c{0}; c < Sigma; ++c) {
+        C[c+1] = C[c] + str.rank(size, c);
+    }
+    return C;
+}
+
+// uniform random positions and symbols, the usual benchmark baseline
+template <size_t Sigma, typename String>
+struct Uniform {
+    String const& str;
+    size_t size;
+    ankerl::nanobench::Rng rng{};
+
+    auto operator()() -> uint64_t {
+        return str.rank(rng.bounded(size+1), rng.bounded(Sigma));
+    }
+};
+
+/* LF walk: every step depends on the previous one (latency bound), like backtracking
+ * or locating a position via the sampled suffix array
+ */
+template <size_t Sigma, typename String>
+struct LFWalk {
+    String const& str;
+    size_t size;
+    std::array<uint64_t, Sigma+1> C = countSmaller<Sigma>(str, size);
+    uint64_t pos{size/2};
+
+    auto operator()() -> uint64_t {
+        auto c = str.symbol(pos);
+        pos = C[c] + str.rank(pos, c);
+        return pos;
+    }
+};
+
+/* Backward search of random patterns: two rank queries per step on the interval (l, r),
+ * which shrinks by about Sigma each step. An empty interval restarts the search
+ */
+template <size_t Sigma, typename String>
+struct BackwardSearch {
+    String const& str;
+    size_t size;
+    std::array<uint64_t, Sigma+1> C = countSmaller<Sigma>(str, size);
+    ankerl::nanobench::Rng rng{};
+    uint64_t l{0};
+    uint64_t r{size};
+
+    auto operator()() -> uint64_t {
+        auto c = rng.bounded(Sigma);
+        l = C[c] + str.rank(l, c);
+        r = C[c] + str.rank(r, c);
+        auto width = r - l;
+        if (width == 0) {
+            l = 0;
+            r = size;
+        }
+        return width;
+    }
+};
+
+// consecutive positions, like a scan over the whole text
+template <size_t Sigma, typename String>
+struct Sequential {
+    String const& str;
+    size_t size;
+    uint64_t pos{0};
+
+    auto operator()() -> uint64_t {
+        auto v = str.rank(pos, pos % Sigma);
+        pos = (pos == size) ? 0 : pos + 1;
+        return v;
+    }
+};
+
+/* Zipf distributed positions: the k-th most frequent position is drawn with probability ~ 1/k^s.
+ * The ranks are scattered over the text by a multiplicative hash. The positions are drawn ahead of time,
+ * reading them back is a sequential scan
+ */
+template <size_t Sigma, typename String>
+struct Zipf {
+    String const& str;
+    size_t size;
+    double s{1.};
+    size_t count{1<<20};
+    std::vector<uint64_t> positions = generate(size, s, count);
+    size_t next{0};
+
+    auto operator()() -> uint64_t {
+        auto pos = positions[next];
+        next = (next+1 == positions.size()) ? 0 : next+1;
+        return str.rank(pos, pos % Sigma);
+    }
+
+    // inverse transform sampling of the continuous approximation
+    static auto generate(size_t size, double s, size_t count) -> std::vector<uint64_t> {
+        auto rng = ankerl::nanobench::Rng{};
+        auto n = double(size+1);
+        auto r = std::vector<uint64_t>(count);
+        for (auto& p : r) {
+            auto u = rng.uniform01();
+            auto x = (std::abs(s - 1.) < 1e-9)
+                ? std::pow(n, u)
+                : std::pow((std::pow(n, 1.-s) - 1.) * u + 1., 1./(1.-s));
+            auto k = std::min<uint64_t>(uint64_t(x) - 1, size);
+            p = (k * 0x9E3779B97F4A7C15ull) % (size+1);
+        }
+        return r;
+    }
+};
+}
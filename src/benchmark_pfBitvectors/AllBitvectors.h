@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_externalLibsAdapter/all.h>
+#include <variant>
+
+// bit vectors of the '[bitvector]' benchmarks and the size sweep
+using AllBitvectors = std::variant<
+#ifdef PFBITVECTORS_USE_PASTA
+    seqan::pfb::FlatRank,
+    seqan::pfb::WideRank,
+#endif
+#ifdef PFBITVECTORS_USE_SDSL
+    seqan::pfb::SDSL_V,
+    seqan::pfb::SDSL_V5,
+#endif
+#ifdef PFBITVECTORS_USE_SUX
+    seqan::pfb::Rank9,
+#endif
+// Single layer bitvectors
+//    seqan::pfb::Bitvector<  64>,
+//    seqan::pfb::Bitvector< 128>,
+//    seqan::pfb::Bitvector< 256>,
+//    seqan::pfb::Bitvector< 512>,
+//    seqan::pfb::Bitvector<1024>,
+//    seqan::pfb::Bitvector<2048>,
+//    seqan::pfb::PairedBitvector<  64>,
+//    seqan::pfb::PairedBitvector< 128>,
+//    seqan::pfb::PairedBitvector< 256>,
+//    seqan::pfb::PairedBitvector< 512>,
+//    seqan::pfb::PairedBitvector<1024>,
+//    seqan::pfb::PairedBitvector<2048>,
+
+// Two layer bitvectors
+    seqan::pfb::Bitvector<  64, 65536>,
+//    seqan::pfb::Bitvector< 128, 65536>,
+//    seqan::pfb::Bitvector< 256, 65536>,
+    seqan::pfb::Bitvector< 512, 65536>,
+//    seqan::pfb::Bitvector<1024, 65536>,
+//    seqan::pfb::Bitvector<2048, 65536>,
+    seqan::pfb::PairedBitvector2LShift<  64, 65536>,
+//    seqan::pfb::PairedBitvector2LShift< 128, 65536>,
+//    seqan::pfb::PairedBitvector2LShift< 256, 65536>,
+    seqan::pfb::PairedBitvector2LShift< 512, 65536>,
+//    seqan::pfb::PairedBitvector2LShift<1024, 65536>,
+//    seqan::pfb::PairedBitvector2LShift<2048, 65536>,
+
+    seqan::pfb::PairedBitvector<  64, 65536>,
+//    seqan::pfb::PairedBitvector< 128, 65536>,
+//    seqan::pfb::PairedBitvector< 256, 65536>,
+    seqan::pfb::PairedBitvector< 512, 65536>,
+//    seqan::pfb::PairedBitvector<1024, 65536>,
+//    seqan::pfb::PairedBitvector<2048, 65536>,
+
+// Two layer bitvectors, stored as plain uint64_t words
+    seqan::pfb::Bitvector2LWord<  64, 65536>,
+    seqan::pfb::Bitvector2LWord< 512, 65536>,
+    seqan::pfb::PairedBitvector2LWord<  64, 65536>,
+    seqan::pfb::PairedBitvector2LWord< 512, 65536>,
+
+// Two layer bitvectors, narrower counters (uint8_t l1, uint32_t l0)
+    seqan::pfb::Bitvector2L<  64,   256>,
+    seqan::pfb::Bitvector2L32< 512, 65536>,
+    std::monostate /*delimiter, is ignored*/
+>;
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_externalLibsAdapter/all.h>
+#include <pfBitvectors_test_utils/utils.h>
+
+// strings of the '[string][5]' benchmarks and the size sweep
+using AllStrings = Variant<
+    seqan::pfb::MultiBitvectorFixed,
+#ifdef PFBITVECTORS_USE_AWFMINDEX
+    seqan::pfb::AWFMIndex,
+#endif
+#ifdef PFBITVECTORS_USE_SDSL
+    seqan::pfb::Sdsl_wt_bldc,
+    seqan::pfb::Sdsl_wt_epr,
+#endif
+//    Instance<seqan::pfb::FlattenedBitvectors2L,   64,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  128,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  256,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  512,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 1024,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 2048,  4096>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L,   64, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  128, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  256, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L,  512, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 1024, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 2048, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L,   64, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  128, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  256, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  512, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 1024, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 2048, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,  512, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L, 1024, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2LWord,        512, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2LWord,  512, 65536>::Type,
+// narrower counters, uint8_t l1 (64/256) and uint32_t l0 (...32)
+    Instance<seqan::pfb::FlattenedBitvectors2L,             64,   256>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L32,          512, 65536>::Type,
+    Delimiter /*delimiter, is ignored*/
+>;
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include "BenchUtils.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/format.h>
+#include <limits>
+#include <nanobench.h>
+#include <string>
+#include <vector>
+
+/* Per query latencies for tail latency (percentile) benchmarks
+ *
+ * Each query is timed on its own, with rdtsc on x86-64 (fenced by lfence, so the query is not overlapped
+ * with the time stamps) and std::chrono::steady_clock elsewhere. The overhead of an empty measurement
+ * is subtracted. The latencies are kept in a log-linear histogram (like HdrHistogram) with a relative error below 1/32.
+ */
+namespace latency {
+
+struct Timer {
+    // time stamp in ticks
+    static auto now() -> uint64_t {
+        #if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_ia32_lfence();
+            auto t = __builtin_ia32_rdtsc();
+            __builtin_ia32_lfence();
+            return t;
+        #else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        #endif
+    }
+
+    // length of a tick, measured against steady_clock once
+    static auto nsPerTick() -> double {
+        static double ns = [] {
+            auto t0 = std::chrono::steady_clock::now();
+            auto c0 = now();
+            while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds{20}) {}
+            auto c1 = now();
+            auto t1 = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(c1 - c0);
+        }();
+        return ns;
+    }
+
+    // smallest number of ticks between two time stamps
+    static auto overhead() -> uint64_t {
+        static uint64_t ticks = [] {
+            auto r = std::numeric_limits<uint64_t>::max();
+            for (size_t i{0}; i < 10'000; ++i) {
+                auto t0 = now();
+                auto t1 = now();
+                r = std::min(r, t1 - t0);
+            }
+            return r;
+        }();
+        return ticks;
+    }
+};
+
+class Histogram {
+    static constexpr size_t subBits    = 5;
+    static constexpr size_t subBuckets = size_t{1} << subBits;
+
+    std::array<uint64_t, (64 - subBits + 1) * subBuckets> counts{};
+    uint64_t total{};
+    uint64_t sum{};
+    uint64_t maxValue{};
+
+    // values below 32 have their own bucket, above each power of two is split into 32 buckets
+    static auto index(uint64_t v) -> size_t {
+        if (v < subBuckets) return v;
+        auto shift = std::bit_width(v) - 1 - subBits;
+        return (shift + 1) * subBuckets + ((v >> shift) - subBuckets);
+    }
+
+    // largest value of bucket i
+    static auto upperBound(size_t i) -> uint64_t {
+        if (i < subBuckets) return i;
+        auto shift = i / subBuckets - 1;
+        auto lower = (uint64_t(i % subBuckets) + subBuckets) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+public:
+    void add(uint64_t v) {
+        counts[index(v)] += 1;
+        total    += 1;
+        sum      += v;
+        maxValue  = std::max(maxValue, v);
+    }
+
+    auto size() const -> uint64_t {
+        return total;
+    }
+
+    auto mean() const -> double {
+        return total ? double(sum) / total : 0.;
+    }
+
+    auto max() const -> uint64_t {
+        return maxValue;
+    }
+
+    // smallest value that is larger or equal than a fraction p of all values (up to the bucket width)
+    auto percentile(double p) const -> uint64_t {
+        auto target = std::max<uint64_t>(1, std::ceil(p * total));
+        uint64_t c{};
+        for (size_t i{0}; i < counts.size(); ++i) {
+            c += counts[i];
+            if (c >= target) {
+                return std::min(upperBound(i), maxValue);
+            }
+        }
+        return maxValue;
+    }
+};
+
+/* Times `queries` calls of `query(pos)`, pos uniformly random in [0, size), the positions are drawn outside of the
+ * timed region. Returns the latencies in ticks
+ */
+template <typename Query>
+auto measure(size_t size, size_t queries, Query query) -> Histogram {
+    auto rng      = ankerl::nanobench::Rng{};
+    auto overhead = Timer::overhead();
+
+    // warm up caches, TLB and frequency
+    for (size_t i{0}; i < queries / 10; ++i) {
+        ankerl::nanobench::doNotOptimizeAway(query(rng.bounded(size)));
+    }
+
+    auto hist = Histogram{};
+    for (size_t i{0}; i < queries; ++i) {
+        auto pos = rng.bounded(size);
+        auto t0 = Timer::now();
+        ankerl::nanobench::doNotOptimizeAway(query(pos));
+        auto t1 = Timer::now();
+        auto d  = t1 - t0;
+        hist.add(d > overhead ? d - overhead : 0);
+    }
+    return hist;
+}
+}
+
+// Prints percentiles of the latencies (in ns) as a table
+struct BenchLatency {
+    std::vector<std::array<std::string, 8>> entries {
+        {"queries", "mean", "p50", "p90", "p99", "p99.9", "max", "name"}
+    };
+
+    void addEntry(std::string name, latency::Histogram const& hist) {
+        auto ns = [](double ticks) {
+            return fmt::format("{:.1f}", ticks * latency::Timer::nsPerTick());
+        };
+        entries.push_back({
+            fmt::format("{}", hist.size()),
+            ns(hist.mean()),
+            ns(hist.percentile(0.5)),
+            ns(hist.percentile(0.9)),
+            ns(hist.percentile(0.99)),
+            ns(hist.percentile(0.999)),
+            ns(hist.max()),
+            std::move(name)
+        });
+    }
+
+    ~BenchLatency() {
+        printTable(entries);
+    }
+};
@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <fstream>
+#include <limits>
+#include <nanobench.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* Opt-in hardware performance counters for the benchmarks
+ *
+ * With the environment variable PERFCOUNTERS=1 every BenchPerf::run() additionally enables the counters of nanobench
+ * and counts cycles, instructions, branch misses, cache misses, LLC loads, LLC load misses and dTLB load misses
+ * via perf_event_open (Linux only). The values per query are printed after each run and written to
+ * <PERFCOUNTERS_OUTPUT>.csv and .json (default "perfcounters"), the files are rewritten after each run.
+ * Events the machine does not support (e.g. inside VMs) are reported as nan.
+ * Without PERFCOUNTERS BenchPerf::run() is the same as bench.run().
+ */
+struct BenchPerf {
+    static constexpr auto eventNames = std::array<std::string_view, 7>{
+        "cycles", "instructions", "branch_misses", "cache_misses", "llc_loads", "llc_load_misses", "dtlb_load_misses"
+    };
+    using Values = std::array<double, eventNames.size()>;
+
+    static auto enabled() -> bool {
+        static bool e = [] {
+            auto ptr = std::getenv("PERFCOUNTERS");
+            return ptr && std::string_view{ptr} != "0";
+        }();
+        return e;
+    }
+
+    template <typename Op>
+    static auto run(ankerl::nanobench::Bench& bench, std::string const& name, Op&& op) -> ankerl::nanobench::Bench& {
+        if (!enabled()) {
+            return bench.run(name, op);
+        }
+        auto& self = instance();
+        bench.performanceCounters(true);
+
+        uint64_t calls{};
+        self.events.start();
+        bench.run(name, [&]() {
+            ++calls;
+            op();
+        });
+        auto values = self.events.stop();
+
+        // nanobench reports per batch entry, so do the counters
+        auto perQuery = calls * bench.batch();
+        for (auto& v : values) {
+            v /= perQuery;
+        }
+        auto ns = bench.results().back().median(ankerl::nanobench::Result::Measure::elapsed) / bench.batch() * 1e9;
+        self.add(bench.title(), name, ns, values);
+        return bench;
+    }
+
+private:
+    struct Entry {
+        std::string title;
+        std::string name;
+        double      ns;
+        Values      values;
+    };
+
+    struct Events {
+        std::array<int, eventNames.size()> fds;
+
+        Events() {
+            fds.fill(-1);
+            #if defined(__linux__)
+                auto cache = [](uint64_t id, uint64_t op, uint64_t result) {
+                    return id | (op << 8) | (result << 16);
+                };
+                auto configs = std::array<std::pair<uint32_t, uint64_t>, eventNames.size()>{{
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                    {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL,   PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS)},
+                    {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL,   PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+                    {PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+                }};
+                // each event on its own (not as group), the kernel multiplexes them if there are too few counters
+                for (size_t i{0}; i < fds.size(); ++i) {
+                    auto attr = perf_event_attr{};
+                    std::memset(&attr, 0, sizeof(attr));
+                    attr.size           = sizeof(attr);
+                    attr.type           = configs[i].first;
+                    attr.config         = configs[i].second;
+                    attr.disabled       = 1;
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv     = 1;
+                    attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+                    fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                }
+            #endif
+        }
+        Events(Events const&) = delete;
+        auto operator=(Events const&) -> Events& = delete;
+
+        ~Events() {
+            #if defined(__linux__)
+                for (auto fd : fds) {
+                    if (fd >= 0) ::close(fd);
+                }
+            #endif
+        }
+
+        void start() {
+            #if defined(__linux__)
+                for (auto fd : fds) {
+                    if (fd < 0) continue;
+                    ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            #endif
+        }
+
+        // counted events, scaled if they were multiplexed
+        auto stop() -> Values {
+            auto values = Values{};
+            values.fill(std::numeric_limits<double>::quiet_NaN());
+            #if defined(__linux__)
+                for (size_t i{0}; i < fds.size(); ++i) {
+                    if (fds[i] < 0) continue;
+                    ::ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                    uint64_t data[3]{}; // value, time enabled, time running
+                    if (::read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+                    values[i] = double(data[0]) * double(data[1]) / double(data[2]);
+                }
+            #endif
+            return values;
+        }
+    };
+
+    Events             events;
+    std::vector<Entry> entries;
+
+    static auto instance() -> BenchPerf& {
+        static auto perf = BenchPerf{};
+        return perf;
+    }
+
+    void add(std::string title, std::string name, double ns, Values const& values) {
+        auto line = fmt::format("perf counters per query - {:.2f} ns", ns);
+        for (size_t i{0}; i < values.size(); ++i) {
+            line += fmt::format(", {} {:.3f}", eventNames[i], values[i]);
+        }
+        fmt::print("{} - {}\n", line, name);
+        entries.push_back({std::move(title), std::move(name), ns, values});
+        write();
+    }
+
+    void write() const {
+        auto prefix = std::string{"perfcounters"};
+        if (auto ptr = std::getenv("PERFCOUNTERS_OUTPUT")) {
+            prefix = ptr;
+        }
+        // json has no nan
+        auto number = [](double v) {
+            return std::isnan(v) ? std::string{"null"} : fmt::format("{:.4f}", v);
+        };
+        {
+            auto ofs = std::ofstream{prefix + ".csv"};
+            ofs << "title,name,ns_per_query";
+            for (auto n : eventNames) {
+                ofs << ',' << n;
+            }
+            ofs << '\n';
+            for (auto const& e : entries) {
+                // names contain commas (template arguments), but never quotes
+                ofs << fmt::format("\"{}\",\"{}\",{:.3f}", e.title, e.name, e.ns);
+                for (auto v : e.values) {
+                    ofs << fmt::format(",{:.4f}", v);
+                }
+                ofs << '\n';
+            }
+        }
+        {
+            auto ofs = std::ofstream{prefix + ".json"};
+            ofs << "[\n";
+            for (size_t i{0}; i < entries.size(); ++i) {
+                auto const& e = entries[i];
+                ofs << fmt::format("  {{\"title\": \"{}\", \"name\": \"{}\", \"ns_per_query\": {:.3f}", e.title, e.name, e.ns);
+                for (size_t j{0}; j < e.values.size(); ++j) {
+                    ofs << fmt::format(", \"{}\": {}", eventNames[j], number(e.values[j]));
+                }
+                ofs << (i+1 < entries.size() ? "},\n" : "}\n");
+            }
+            ofs << "]\n";
+        }
+    }
+};
@@ -3,19 +3,26 @@
 #pragma once
 
 #include <array>
+#include <cereal/archives/binary.hpp>
 #include <fmt/format.h>
 #include <iostream>
+#include <locale>
+#include <pfBitvectors/SpaceUsage.h>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 struct BenchSize {
-    // # 4 columns:
+    // # 11 columns:
     // - relative
-    // - total size (in bits)
+    // - total size (in bytes)
     // - bits per entry
+    // - overhead
+    // - l0, l1, bits, tables, slack, other (in bits per entry, see seqan::pfb::SpaceUsage)
     // - name
-    std::vector<std::array<std::string, 5>> entries {
-        {"relative", "size", "bits/bit", "overhead %", "name"}
+    std::vector<std::array<std::string, 11>> entries {
+        {"relative", "size", "bits/bit", "overhead %", "l0", "l1", "bits", "tables", "slack", "other", "name"}
     };
 
     double baseSize{0};
@@ -26,21 +33,63 @@ struct BenchSize {
         size_t      text_size;
         double      bits_per_char;
         double      relative{};
+        seqan::pfb::SpaceUsage breakdown{};
     };
     size_t firstEntrySize{};
 
+    /* Size of a structure, uses space_breakdown() or space_usage() if available,
+     * otherwise the size of its serialization. Sizes without breakdown are reported as other.
+     */
+    template <typename T>
+    static auto measure(T const& obj) -> seqan::pfb::SpaceUsage {
+        if constexpr (requires() { { obj.space_breakdown() } -> std::same_as<seqan::pfb::SpaceUsage>; }) {
+            return obj.space_breakdown();
+        } else if constexpr (requires() { { obj.space_usage() } -> std::convertible_to<size_t>; }) {
+            return {.other = obj.space_usage()};
+        } else {
+            auto ofs     = std::stringstream{};
+            auto archive = cereal::BinaryOutputArchive{ofs};
+            archive(obj);
+            return {.other = ofs.str().size()};
+        }
+    }
+
+    template <typename T>
+    void addEntry(std::string name, T const& obj, size_t text_size) {
+        auto usage = measure(obj);
+        addEntry({
+            .name = std::move(name),
+            .size = usage.total(),
+            .text_size = text_size,
+            .bits_per_char = (usage.total()*8)/double(text_size),
+            .breakdown = usage,
+        });
+    }
+
     void addEntry(Entry e) {
         if (entries.size() == 1) {
             firstEntrySize = e.size;
         }
+        if (e.breakdown.total() == 0) {
+            e.breakdown.other = e.size;
+        }
 
         double overheadInPercent = (e.bits_per_char - baseSize) / baseSize * 100.;
+        auto perEntry = [&](size_t bytes) {
+            return fmt::format("{:.3f}", (bytes*8)/double(e.text_size));
+        };
 
         entries.push_back({
             fmt::format("{:.1f}%", double(e.size) / firstEntrySize*100.),
-            fmt::format(std::locale("en_US.UTF-8"), "{:L}", e.size),
+            fmt::format(locale(), "{:L}", e.size),
             fmt::format("{:.3f}", e.bits_per_char),
             fmt::format("{:.3f}%", overheadInPercent),
+            perEntry(e.breakdown.l0),
+            perEntry(e.breakdown.l1),
+            perEntry(e.breakdown.bits),
+            perEntry(e.breakdown.tables),
+            perEntry(e.breakdown.slack),
+            perEntry(e.breakdown.other),
             fmt::format("{}", e.name)
         });
     }
@@ -49,7 +98,7 @@ struct BenchSize {
         if (entries.size() < 2) return;
         fmt::print("\n");
 
-        auto sizesPerColumn = std::array<size_t, 5>{};
+        auto sizesPerColumn = std::array<size_t, 11>{};
 
         auto& c = sizesPerColumn;
         for (auto const& e : entries) {
@@ -62,10 +111,26 @@ struct BenchSize {
             auto const& e = entries[i];
             auto const& sc = sizesPerColumn;
             if (i == 1) {
-                fmt::print("|-{0:->{1}}-|-{0:->{2}}-|-{0:->{3}}-|-{0:-<{4}}-|-{0:-<{5}}\n", "", sc[0], sc[1], sc[2], sc[3], sc[4]);
+                for (size_t j{0}; j+1 < sc.size(); ++j) {
+                    fmt::print("|-{0:->{1}}-", "", sc[j]);
+                }
+                fmt::print("|-{0:-<{1}}\n", "", sc.back());
+            }
+
+            for (size_t j{0}; j+1 < sc.size(); ++j) {
+                fmt::print("| {: >{}} ", e[j], sc[j]);
             }
+            fmt::print("| {: <{}} |\n", e.back(), sc.back());
+        }
+    }
 
-            fmt::print("| {: >{}} | {: >{}} | {: >{}} | {: >{}} | {: <{}} |\n", e[0], sc[0], e[1], sc[1], e[2], sc[2], e[3], sc[3], e[4], sc[4]);
+private:
+    // thousands separators, if the locale is installed
+    static auto locale() -> std::locale {
+        try {
+            return std::locale("en_US.UTF-8");
+        } catch (std::runtime_error const&) {
+            return std::locale::classic();
         }
     }
 };
@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include "BenchUtils.h"
+
+#include <array>
+#include <fmt/format.h>
+#include <pfBitvectors/Stats.h>
+#include <string>
+#include <vector>
+
+/* Prints the query counters (see pfBitvectors/Stats.h) as a table
+ * all values are per query, the reuse columns give the fraction of block reads
+ * whose reuse distance is below the given number of block reads
+ */
+struct BenchStats {
+    std::vector<std::array<std::string, 11>> entries {
+        {"queries", "l0", "l1", "blocks", "tables", "d = 0", "d < 64", "d < 4k", "d < 1M", "cold", "name"}
+    };
+
+    void addEntry(std::string name, seqan::pfb::stats::Counters const& c) {
+        auto perQuery = [&](uint64_t v) {
+            return fmt::format("{:.2f}", c.queries ? double(v) / c.queries : 0.);
+        };
+        auto percent = [&](double v) {
+            return fmt::format("{:.1f}%", v * 100.);
+        };
+        entries.push_back({
+            fmt::format("{}", c.queries),
+            perQuery(c.l0),
+            perQuery(c.l1),
+            perQuery(c.blocks),
+            perQuery(c.tables),
+            percent(c.reuseBelow(0)),
+            percent(c.reuseBelow(6)),
+            percent(c.reuseBelow(12)),
+            percent(c.reuseBelow(20)),
+            percent(c.blocks ? double(c.coldBlocks) / c.blocks : 0.),
+            std::move(name)
+        });
+    }
+
+    ~BenchStats() {
+        printTable(entries);
+    }
+};
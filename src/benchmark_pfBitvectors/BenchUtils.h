@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+#pragma once
+
+#include "BenchPerf.h"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <limits>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <vector>
+
+// helpers shared by the benchmarks
+
+// value of the environment variable `name`, or `defaultValue`, which is capped at `debugLimit` in debug builds
+inline auto envOr(char const* name, size_t defaultValue, size_t debugLimit = std::numeric_limits<size_t>::max()) -> size_t {
+    auto ptr = std::getenv(name);
+    if (ptr) {
+        return std::stoull(ptr);
+    }
+    #ifdef NDEBUG
+        (void)debugLimit;
+        return defaultValue;
+    #else
+        return std::min(defaultValue, debugLimit);
+    #endif
+}
+
+/* Prints rows of strings as a markdown table, the first row is the header
+ * all columns are right aligned except the last one (the name)
+ */
+template <typename Rows>
+void printTable(Rows const& entries) {
+    if (entries.size() < 2) return;
+    fmt::print("\n");
+
+    auto c = std::vector<size_t>(entries[0].size());
+    for (auto const& e : entries) {
+        for (size_t i{0}; i < c.size(); ++i) {
+            c[i] = std::max(c[i], e[i].size());
+        }
+    }
+    for (size_t i{0}; i < entries.size(); ++i) {
+        auto const& e = entries[i];
+        if (i == 1) {
+            for (size_t j{0}; j+1 < c.size(); ++j) {
+                fmt::print("|-{0:->{1}}-", "", c[j]);
+            }
+            fmt::print("|-{0:-<{1}}\n", "", c.back());
+        }
+        for (size_t j{0}; j+1 < c.size(); ++j) {
+            fmt::print("| {: >{}} ", e[j], c[j]);
+        }
+        fmt::print("| {: <{}} |\n", e.back(), c.back());
+    }
+}
+
+// largest number of entries the l0 counter type of T can count (see pfBitvectors/Counter.h)
+template <typename T>
+constexpr auto maxEntries() -> uint64_t {
+    if constexpr (requires() { typename T::L0Counter; }) {
+        return std::numeric_limits<typename T::L0Counter>::max();
+    } else if constexpr (requires() { typename T::BlockL0::value_type; }) {
+        return std::numeric_limits<typename T::BlockL0::value_type>::max();
+    } else {
+        return std::numeric_limits<uint64_t>::max();
+    }
+}
+
+// true if T can not be built with `size` entries (e.g. uint32_t l0 counters and 2^32 entries), prints that it is skipped
+template <typename T>
+auto skipTooLong(size_t size, std::string const& name) -> bool {
+    if (size <= maxEntries<T>()) return false;
+    fmt::print("skipping {}: {} entries exceed its l0 counter\n", name, size);
+    return true;
+}
+
+// sum of every entry of all_ranks(), so none of the ranks can be optimized away
+template <typename Ranks>
+auto sumOfRanks(Ranks const& ranks) -> uint64_t {
+    uint64_t sum{};
+    for (auto r : ranks) {
+        sum += r;
+    }
+    return sum;
+}
+
+/* Random DNA (symbols 1-4, 0 is the sentinel) where a tenth of the genome consists of
+ * copies of earlier segments with 1% substitutions, so some patterns occur more than once
+ */
+inline auto generateGenome(size_t size) -> std::vector<uint8_t> {
+    auto rng    = ankerl::nanobench::Rng{};
+    auto genome = std::vector<uint8_t>{};
+    genome.reserve(size);
+    while (genome.size() < size) {
+        if (genome.size() > 10'000 && rng.bounded(10) == 0) {
+            auto len   = std::min<size_t>(1 + rng.bounded(5'000), size - genome.size());
+            auto start = rng.bounded(genome.size() - len);
+            for (size_t i{0}; i < len; ++i) {
+                auto c = genome[start + i];
+                genome.push_back(rng.bounded(100) == 0 ? 1 + rng.bounded(4) : c);
+            }
+        } else {
+            for (size_t i{0}; i < 1'000 && genome.size() < size; ++i) {
+                genome.push_back(1 + rng.bounded(4));
+            }
+        }
+    }
+    return genome;
+}
+
+/* `ct` reads of the genome, each gets `substitutions(rng)` random substitutions
+ * (positions may repeat, a substitution always changes the symbol)
+ */
+template <typename Substitutions>
+auto sampleReads(std::vector<uint8_t> const& genome, size_t ct, size_t length, Substitutions substitutions) -> std::vector<std::vector<uint8_t>> {
+    auto rng   = ankerl::nanobench::Rng{};
+    auto reads = std::vector<std::vector<uint8_t>>{};
+    length = std::min(length, genome.size());
+    for (size_t i{0}; i < ct; ++i) {
+        auto start = rng.bounded(genome.size() - length + 1);
+        auto read  = std::vector<uint8_t>(genome.begin() + start, genome.begin() + start + length);
+        auto e = substitutions(rng);
+        for (size_t j{0}; j < e; ++j) {
+            auto& c = read[rng.bounded(length)];
+            c = 1 + (c + rng.bounded(3)) % 4;
+        }
+        reads.push_back(std::move(read));
+    }
+    return reads;
+}
+
+/* rank() with a runtime symbol vs. a compile-time symbol (dispatch_symbol, rank<Symb>, bind<Symb>) on strings of the given alphabet
+ * No configuration uses the simd kernels (only l1 = 512 with 2 or 3 bit planes, see simd.h), these take the
+ * same code path for runtime and compile-time symbols.
+ */
+template <size_t Sigma>
+void benchStaticRank(std::vector<uint8_t> const& text) {
+    using StaticStrings = Variant<
+        Instance<seqan::pfb::FlattenedBitvectors2L,             64, 65536>::Type,
+        Instance<seqan::pfb::FlattenedBitvectors2L,            256, 65536>::Type,
+        Instance<seqan::pfb::PairedFlattenedBitvectors2L,       64, 65536>::Type,
+        Instance<seqan::pfb::PairedFlattenedBitvectors2L,      256, 65536>::Type,
+        Instance<seqan::pfb::InterleavedFlattenedBitvectors2L, 512, 65536>::Type,
+        Delimiter /*delimiter, is ignored*/
+    >;
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("rank() runtime vs compile-time symbol")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto str = String{text};
+
+            auto rng = ankerl::nanobench::Rng{};
+            BenchPerf::run(bench, name + " - runtime symbol", [&]() {
+                auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+            BenchPerf::run(bench, name + " - dispatch_symbol", [&]() {
+                auto idx = rng.bounded(text.size()+1);
+                auto v = seqan::pfb::dispatch_symbol<Sigma>(rng.bounded(Sigma), [&]<size_t Symb>() {
+                    return str.template rank<Symb>(idx);
+                });
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+            auto bound = str.template bind<1>();
+            BenchPerf::run(bench, name + " - bind<1>()", [&]() {
+                auto v = bound.rank(rng.bounded(text.size()+1));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+        }, StaticStrings{});
+    }
+}
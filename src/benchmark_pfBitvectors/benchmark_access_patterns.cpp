@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "AccessPatterns.h"
+#include "AllBitvectors.h"
+#include "AllStrings5.h"
+#include "BenchPerf.h"
+#include "BenchUtils.h"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <nanobench.h>
+#include <string>
+#include <vector>
+
+/* Run times of all bit vectors and strings (alphabet 5) under the access patterns of AccessPatterns.h:
+ * uniform random (baseline), dependent LF walks, backward search interval pairs, sequential scans and Zipf skewed positions
+ */
+
+namespace {
+// length given by the environment variable `name`, small default for debug builds
+auto textSize(char const* name, size_t defaultValue) -> size_t {
+    auto ptr = std::getenv(name);
+    if (ptr) {
+        return std::stoull(ptr);
+    }
+    #ifdef NDEBUG
+        return defaultValue;
+    #else
+        return std::min<size_t>(defaultValue, 100'000);
+    #endif
+}
+
+/* Benchmarks every pattern for each structure, `forEach(f)` calls `f.template operator()<Sigma>(name, str, size)`
+ * for every structure
+ */
+template <typename ForEach>
+void benchmarkPatterns(std::string const& kind, ForEach forEach) {
+    auto run = [&](std::string const& title, auto makePattern) {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title(kind + " - " + title)
+             .relative(true);
+        bench.epochs(20);
+        bench.minEpochTime(std::chrono::milliseconds{10});
+        forEach([&]<size_t Sigma>(std::string const& name, auto const& str, size_t size) {
+            INFO(name);
+            auto pattern = makePattern.template operator()<Sigma>(str, size);
+            BenchPerf::run(bench, name, [&]() {
+                ankerl::nanobench::doNotOptimizeAway(pattern());
+            });
+        });
+    };
+
+    run("uniform", []<size_t Sigma, typename String>(String const& str, size_t size) {
+        return patterns::Uniform<Sigma, String>{str, size};
+    });
+    run("LF walk", []<size_t Sigma, typename String>(String const& str, size_t size) {
+        return patterns::LFWalk<Sigma, String>{str, size};
+    });
+    run("backward search", []<size_t Sigma, typename String>(String const& str, size_t size) {
+        return patterns::BackwardSearch<Sigma, String>{str, size};
+    });
+    run("sequential", []<size_t Sigma, typename String>(String const& str, size_t size) {
+        return patterns::Sequential<Sigma, String>{str, size};
+    });
+    run("zipf", []<size_t Sigma, typename String>(String const& str, size_t size) {
+        return patterns::Zipf<Sigma, String>{str, size};
+    });
+}
+}
+
+TEST_CASE("benchmark bit vectors with realistic access patterns", "[bitvector][time][pattern]") {
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<bool>(textSize("BITVECTORSIZE", 10'000'000));
+        for (size_t i{0}; i < text.size(); ++i) {
+            text[i] = rng.bounded(4) == 0;
+        }
+        return text;
+    }();
+
+    benchmarkPatterns("bit vectors", [&](auto f) {
+        call_with_templates([&]<typename Vector>() {
+            if (skipTooLong<Vector>(text.size(), getName<Vector>())) return;
+            auto vec = Vector{text};
+            auto str = patterns::BitvectorAsString<Vector>{vec};
+            f.template operator()<2>(getName<Vector>(), str, text.size());
+        }, AllBitvectors{});
+    });
+}
+
+TEST_CASE("benchmark strings with realistic access patterns - 5 alphabet", "[string][5][time][pattern]") {
+    constexpr size_t Sigma = 5;
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<uint8_t>(textSize("STRINGSIZE", 1'000'000));
+        for (auto& c : text) {
+            c = rng.bounded(Sigma);
+        }
+        return text;
+    }();
+
+    benchmarkPatterns("strings 5", [&](auto f) {
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            if (skipTooLong<String>(text.size(), getName<String>())) return;
+            auto str = String{text};
+            f.template operator()<Sigma>(getName<String>(), str, text.size());
+        }, AllStrings{});
+    });
+}
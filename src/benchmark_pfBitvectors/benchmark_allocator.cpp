@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "BenchPerf.h"
+
+#include <pfBitvectors/pfBitvectors.h>
+
+#if defined(__linux__) && defined(__cpp_lib_memory_resource)
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <nanobench.h>
+#include <optional>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+/* Random rank() latency of a bit vector placed in memory backed by
+ * 4KB pages, 2MB huge pages or 1GB huge pages. Large bit vectors (BITVECTORSIZE=16'000'000'000)
+ * cause a TLB miss on almost every query with 4KB pages.
+ *
+ * Huge pages must be reserved beforehand, e.g.:
+ *   echo 2048 > /sys/kernel/mm/hugepages/hugepages-2048kB/nr_hugepages
+ *   echo 4 > /sys/kernel/mm/hugepages/hugepages-1048576kB/nr_hugepages
+ * Page sizes that can not be mapped are skipped.
+ */
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace {
+auto bitvectorSize() -> size_t {
+    auto ptr = std::getenv("BITVECTORSIZE");
+    if (ptr) {
+        return std::stoull(ptr);
+    }
+    #ifdef NDEBUG
+        return 1'000'000'000;
+    #else
+        return 100'000;
+    #endif
+}
+
+// anonymous mapping with a fixed page size, all allocations are served by a monotonic_buffer_resource
+class Arena {
+    void*  _data{MAP_FAILED};
+    size_t _size{};
+    std::optional<std::pmr::monotonic_buffer_resource> _resource;
+
+public:
+    Arena(size_t size, size_t pageSize, int flags)
+        : _size{(size + pageSize - 1) / pageSize * pageSize}
+    {
+        _data = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        if (_data != MAP_FAILED) {
+            _resource.emplace(_data, _size, std::pmr::null_memory_resource());
+        }
+    }
+    Arena(Arena const&) = delete;
+    auto operator=(Arena const&) -> Arena& = delete;
+    ~Arena() {
+        _resource.reset();
+        if (_data != MAP_FAILED) {
+            ::munmap(_data, _size);
+        }
+    }
+
+    bool valid() const {
+        return _resource.has_value();
+    }
+
+    auto allocator() -> seqan::pfb::pmr::allocator {
+        return {&*_resource};
+    }
+};
+}
+
+TEST_CASE("benchmark bit vectors rank run times on huge pages", "[bitvector][time][allocator]") {
+    using Vector = seqan::pfb::pmr::Bitvector2L<512, 65536>;
+
+    auto rng = ankerl::nanobench::Rng{};
+    auto text = std::vector<bool>(bitvectorSize());
+    for (size_t i{0}; i < text.size(); ++i) {
+        text[i] = rng.bounded(4) == 0;
+    }
+    auto source = Vector{text};
+    text = {};
+
+    // bulk archive size plus padding of each container
+    auto bytes = [&]() {
+        auto archive = seqan::pfb::BulkOutputArchive{};
+        archive(source);
+        return archive.size() + 4096;
+    }();
+
+    auto bench_rank = ankerl::nanobench::Bench{};
+    bench_rank.title("rank() - page size")
+              .relative(true);
+    bench_rank.epochs(20);
+    bench_rank.minEpochTime(std::chrono::milliseconds{10});
+    bench_rank.minEpochIterations(1'000'000);
+
+    struct Placement {
+        std::string name;
+        size_t      pageSize;
+        int         flags;
+    };
+    for (auto const& [name, pageSize, flags] : {
+        Placement{"4KB pages", 4096, 0},
+        Placement{"2MB pages", size_t{1} << 21, MAP_HUGETLB | MAP_HUGE_2MB},
+        Placement{"1GB pages", size_t{1} << 30, MAP_HUGETLB | MAP_HUGE_1GB},
+    }) {
+        auto arena = Arena{bytes, pageSize, flags};
+        if (!arena.valid()) {
+            WARN("skipping " << name << ", no huge pages of this size reserved");
+            continue;
+        }
+        auto vec = Vector{source, arena.allocator()};
+
+        BenchPerf::run(bench_rank, getName<Vector>() + " - " + name, [&]() {
+            auto v = vec.rank(rng.bounded(vec.size()));
+            ankerl::nanobench::doNotOptimizeAway(v);
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "BenchPerf.h"
+#include "BenchUtils.h"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* Overhead of runtime selected configurations (AnyBitvector/AnyString) compared to the template types
+ *
+ * Each configuration answers the same random rank queries
+ *  - direct:       the template type
+ *  - any - single: AnyBitvector/AnyString, dispatching on every query
+ *  - any - batch:  AnyBitvector/AnyString, dispatching once per batch
+ *
+ * Environment variables:
+ *  - BITVECTORSIZE, STRINGSIZE: length of the bit vectors and strings
+ *  - BATCHSIZE: queries per batch (default 1024)
+ */
+
+namespace {
+// random positions in [0, size], the benchmarks walk through them in batches, so they do not stay in cache
+struct Positions {
+    std::vector<uint64_t> pos;
+    std::vector<uint64_t> symb;
+    size_t batchSize;
+    size_t offset{};
+
+    Positions(size_t size, size_t sigma, size_t _batchSize)
+        : batchSize{std::max<size_t>(1, _batchSize)}
+    {
+        auto rng = ankerl::nanobench::Rng{};
+        auto ct  = std::max<size_t>(1 << 20, batchSize) / batchSize * batchSize;
+        for (size_t i{0}; i < ct; ++i) {
+            pos.push_back(rng.bounded(size+1));
+            symb.push_back(rng.bounded(sigma));
+        }
+    }
+
+    // next batch of positions and symbols
+    auto next() -> std::pair<std::span<uint64_t const>, std::span<uint64_t const>> {
+        auto r = std::pair{std::span{pos}.subspan(offset, batchSize), std::span{symb}.subspan(offset, batchSize)};
+        offset = (offset + batchSize) % pos.size();
+        return r;
+    }
+};
+}
+
+TEST_CASE("benchmark overhead of runtime selected bit vectors", "[bitvector][time][any]") {
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<bool>(envOr("BITVECTORSIZE", 10'000'000, 100'000));
+        for (size_t i{0}; i < text.size(); ++i) {
+            text[i] = rng.bounded(4) == 0;
+        }
+        return text;
+    }();
+    auto positions = Positions{text.size(), 2, envOr("BATCHSIZE", 1024)};
+    auto out       = std::vector<uint64_t>(positions.batchSize);
+
+    auto test = [&]<typename Vector>(std::string_view config) {
+        auto name = getName<Vector>();
+        INFO(name);
+
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("rank() - " + name)
+             .relative(true)
+             .batch(positions.batchSize);
+
+        auto direct = Vector{text};
+        auto any    = seqan::pfb::AnyBitvector{config, text};
+        BenchPerf::run(bench, "direct", [&]() {
+            auto [pos, _] = positions.next();
+            uint64_t checksum{};
+            for (auto p : pos) {
+                checksum += direct.rank(p);
+            }
+            ankerl::nanobench::doNotOptimizeAway(checksum);
+        });
+        BenchPerf::run(bench, "any - single", [&]() {
+            auto [pos, _] = positions.next();
+            uint64_t checksum{};
+            for (auto p : pos) {
+                checksum += any.rank(p);
+            }
+            ankerl::nanobench::doNotOptimizeAway(checksum);
+        });
+        BenchPerf::run(bench, "any - batch", [&]() {
+            auto [pos, _] = positions.next();
+            any.rank_batch(pos, out);
+            ankerl::nanobench::doNotOptimizeAway(out.data());
+        });
+    };
+    test.template operator()<seqan::pfb::Bitvector2L<64, 65536>>("Bitvector2L<64, 65536>");
+    test.template operator()<seqan::pfb::Bitvector2L<512, 65536>>("Bitvector2L<512, 65536>");
+    test.template operator()<seqan::pfb::PairedBitvector2L<512, 65536>>("PairedBitvector2L<512, 65536>");
+}
+
+TEST_CASE("benchmark overhead of runtime selected strings - 5 alphabet", "[string][5][time][any]") {
+    constexpr size_t Sigma = 5;
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<uint8_t>(envOr("STRINGSIZE", 10'000'000, 100'000));
+        for (auto& c : text) {
+            c = rng.bounded(Sigma);
+        }
+        return text;
+    }();
+    auto positions = Positions{text.size(), Sigma, envOr("BATCHSIZE", 1024)};
+    auto out       = std::vector<uint64_t>(positions.batchSize);
+
+    auto test = [&]<typename String>(std::string_view config) {
+        auto name = getName<String>();
+        INFO(name);
+
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("rank() - " + name)
+             .relative(true)
+             .batch(positions.batchSize);
+
+        auto direct = String{text};
+        auto any    = seqan::pfb::AnyString<Sigma>{config, text};
+        BenchPerf::run(bench, "direct", [&]() {
+            auto [pos, symb] = positions.next();
+            uint64_t checksum{};
+            for (size_t i{0}; i < pos.size(); ++i) {
+                checksum += direct.rank(pos[i], symb[i]);
+            }
+            ankerl::nanobench::doNotOptimizeAway(checksum);
+        });
+        BenchPerf::run(bench, "any - single", [&]() {
+            auto [pos, symb] = positions.next();
+            uint64_t checksum{};
+            for (size_t i{0}; i < pos.size(); ++i) {
+                checksum += any.rank(pos[i], symb[i]);
+            }
+            ankerl::nanobench::doNotOptimizeAway(checksum);
+        });
+        BenchPerf::run(bench, "any - batch", [&]() {
+            auto [pos, symb] = positions.next();
+            any.rank_batch(pos, symb, out);
+            ankerl::nanobench::doNotOptimizeAway(out.data());
+        });
+    };
+    test.template operator()<seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>>("FlattenedBitvectors2L<512, 65536>");
+    test.template operator()<seqan::pfb::PairedFlattenedBitvectors2L<Sigma, 512, 65536>>("PairedFlattenedBitvectors2L<512, 65536>");
+    test.template operator()<seqan::pfb::InterleavedFlattenedBitvectors2L<Sigma, 512, 65536>>("InterleavedFlattenedBitvectors2L<512, 65536>");
+}
@@ -2,7 +2,10 @@
 // SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: CC0-1.0
 
+#include "AllBitvectors.h"
+#include "BenchPerf.h"
 #include "BenchSize.h"
+#include "BenchUtils.h"
 
 #include <catch2/catch_all.hpp>
 #include <cereal/archives/binary.hpp>
@@ -13,55 +16,6 @@
 #include <fstream>
 #include <nanobench.h>
 
-using AllBitvectors = std::variant<
-#ifdef PFBITVECTORS_USE_PASTA
-    seqan::pfb::FlatRank,
-    seqan::pfb::WideRank,
-#endif
-#ifdef PFBITVECTORS_USE_SDSL
-    seqan::pfb::SDSL_V,
-    seqan::pfb::SDSL_V5,
-#endif
-#ifdef PFBITVECTORS_USE_SUX
-    seqan::pfb::Rank9,
-#endif
-// Single layer bitvectors
-//    seqan::pfb::Bitvector<  64>,
-//    seqan::pfb::Bitvector< 128>,
-//    seqan::pfb::Bitvector< 256>,
-//    seqan::pfb::Bitvector< 512>,
-//    seqan::pfb::Bitvector<1024>,
-//    seqan::pfb::Bitvector<2048>,
-//    seqan::pfb::PairedBitvector<  64>,
-//    seqan::pfb::PairedBitvector< 128>,
-//    seqan::pfb::PairedBitvector< 256>,
-//    seqan::pfb::PairedBitvector< 512>,
-//    seqan::pfb::PairedBitvector<1024>,
-//    seqan::pfb::PairedBitvector<2048>,
-
-// Two layer bitvectors
-    seqan::pfb::Bitvector<  64, 65536>,
-//    seqan::pfb::Bitvector< 128, 65536>,
-//    seqan::pfb::Bitvector< 256, 65536>,
-    seqan::pfb::Bitvector< 512, 65536>,
-//    seqan::pfb::Bitvector<1024, 65536>,
-//    seqan::pfb::Bitvector<2048, 65536>,
-    seqan::pfb::PairedBitvector2LShift<  64, 65536>,
-//    seqan::pfb::PairedBitvector2LShift< 128, 65536>,
-//    seqan::pfb::PairedBitvector2LShift< 256, 65536>,
-    seqan::pfb::PairedBitvector2LShift< 512, 65536>,
-//    seqan::pfb::PairedBitvector2LShift<1024, 65536>,
-//    seqan::pfb::PairedBitvector2LShift<2048, 65536>,
-
-    seqan::pfb::PairedBitvector<  64, 65536>,
-//    seqan::pfb::PairedBitvector< 128, 65536>,
-//    seqan::pfb::PairedBitvector< 256, 65536>,
-    seqan::pfb::PairedBitvector< 512, 65536>,
-//    seqan::pfb::PairedBitvector<1024, 65536>,
-//    seqan::pfb::PairedBitvector<2048, 65536>,
-    std::monostate /*delimiter, is ignored*/
->;
-
 namespace {
 auto generateText() -> std::vector<bool> const& {
     static auto text = []() -> std::vector<bool> {
@@ -95,14 +49,16 @@ TEST_CASE("benchmark bit vectors ctor run times", "[bitvector][time][ctor]") {
               .relative(true);
 
     auto& text = generateText();
+    bench_ctor.batch(text.size());
 
     SECTION("benchmarking") {
         call_with_templates([&]<typename Vector>() {
 
             auto vector_name = getName<Vector>();
             INFO(vector_name);
+            if (skipTooLong<Vector>(text.size(), vector_name)) return;
 
-            bench_ctor.batch(text.size()).run(vector_name, [&]() {
+            BenchPerf::run(bench_ctor, vector_name, [&]() {
                 auto vec = Vector{text};
                 ankerl::nanobench::doNotOptimizeAway(vec.rank(0));
             });
@@ -125,12 +81,13 @@ TEST_CASE("benchmark bit vectors rank and symbol run times", "[bitvector][time][
 
             auto vector_name = getName<Vector>();
             INFO(vector_name);
+            if (skipTooLong<Vector>(text.size(), vector_name)) return;
 
             auto rng = ankerl::nanobench::Rng{};
 
             auto vec = Vector{text};
 
-            bench_symbol.run(vector_name, [&]() {
+            BenchPerf::run(bench_symbol, vector_name, [&]() {
                 auto v = vec.symbol(rng.bounded(text.size()));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -155,12 +112,13 @@ TEST_CASE("benchmark bit vectors rank and symbol run times", "[bitvector][time][
 
             auto vector_name = getName<Vector>();
             INFO(vector_name);
+            if (skipTooLong<Vector>(text.size(), vector_name)) return;
 
             auto rng = ankerl::nanobench::Rng{};
 
             auto vec = Vector{text};
 
-            bench_rank.run(vector_name, [&]() {
+            BenchPerf::run(bench_rank, vector_name, [&]() {
                 auto v = vec.rank(rng.bounded(text.size()));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -179,28 +137,10 @@ TEST_CASE("benchmark bit vectors memory consumption", "[bitvector][size]") {
             INFO(vector_name);
 
             auto& text = generateText();
+            if (skipTooLong<Vector>(text.size(), vector_name)) return;
 
             auto vec = Vector{text};
-            if constexpr (requires() { vec.space_usage(); }) {
-                auto s = vec.space_usage();
-                benchSize.addEntry({
-                    .name = vector_name,
-                    .size = s,
-                    .text_size = text.size(),
-                    .bits_per_char = (s*8)/double(text.size())
-                });
-            } else {
-                auto ofs     = std::stringstream{};
-                auto archive = cereal::BinaryOutputArchive{ofs};
-                archive(vec);
-                auto s = ofs.str().size();
-                benchSize.addEntry({
-                    .name = vector_name,
-                    .size = s,
-                    .text_size = text.size(),
-                    .bits_per_char = (s*8)/double(text.size())
-                });
-            }
+            benchSize.addEntry(vector_name, vec, text.size());
         }, AllBitvectors{});
     }
 }
@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "BenchUtils.h"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cereal/archives/binary.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* Cold start: time from an index on disk to full query speed
+ *
+ * Each structure is saved to disk, evicted from the page cache (posix_fadvise, Linux only) and then
+ *  - loaded via cereal, bulk binary loading (loadBinary) or mapped (Mapped* views, see MappedFile.h)
+ *  - queried once (first query latency)
+ *  - queried in batches, until the batches are as fast as the steady state (the median of the last half of all batches)
+ *
+ * Environment variables:
+ *  - SERIALIZATIONSIZE: number of bits/symbols of each structure
+ *  - QUERIES:           total number of queries after loading, answered in batches of 10'000
+ */
+
+namespace {
+// evicts the file from the page cache, returns false if this is not supported
+auto dropPageCache(std::filesystem::path const& path) -> bool {
+    #if defined(__linux__)
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        // only clean pages can be dropped
+        ::fdatasync(fd);
+        auto r = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        ::close(fd);
+        return r;
+    #else
+        (void)path;
+        return false;
+    #endif
+}
+
+struct Table {
+    std::vector<std::vector<std::string>> entries {
+        {"path", "cache dropped", "load ms", "first query us", "steady after ms", "steady ns/q", "name"}
+    };
+
+    ~Table() {
+        printTable(entries);
+    }
+};
+
+template <typename T>
+auto generate(size_t size) -> T {
+    auto rng  = ankerl::nanobench::Rng{};
+    auto text = std::vector<uint8_t>(size);
+    for (auto& c : text) {
+        if constexpr (requires() { T::Sigma; }) {
+            c = rng.bounded(T::Sigma);
+        } else {
+            c = rng.bounded(4) == 0;
+        }
+    }
+    return T{text};
+}
+
+// a random rank query, the same for the structure and its mapped view
+template <typename T>
+auto query(T const& v, size_t size, ankerl::nanobench::Rng& rng) -> uint64_t {
+    if constexpr (requires() { T::Sigma; }) {
+        return v.rank(rng.bounded(size+1), rng.bounded(T::Sigma));
+    } else {
+        return v.rank(rng.bounded(size+1));
+    }
+}
+
+/* Measures the cold start of `load()`, which returns the loaded structure.
+ * The file must have been evicted from the page cache before
+ */
+template <typename Load>
+void measureColdStart(Table& table, std::string const& path, bool dropped, std::string const& name, size_t size, Load load) {
+    using Clock = std::chrono::steady_clock;
+    auto ms = [](Clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    auto rng    = ankerl::nanobench::Rng{};
+    auto start  = Clock::now();
+    auto v      = load();
+    auto loaded = Clock::now();
+    ankerl::nanobench::doNotOptimizeAway(query(v, size, rng));
+    auto firstQuery = Clock::now();
+
+    constexpr size_t batchSize = 10'000;
+    auto batches = std::max<size_t>(2, envOr("QUERIES", 10'000'000, 1'000'000) / batchSize);
+    auto ends    = std::vector<Clock::time_point>{};
+    auto times   = std::vector<double>{};
+    auto last    = firstQuery;
+    for (size_t b{0}; b < batches; ++b) {
+        uint64_t checksum{};
+        for (size_t i{0}; i < batchSize; ++i) {
+            checksum += query(v, size, rng);
+        }
+        ankerl::nanobench::doNotOptimizeAway(checksum);
+        auto now = Clock::now();
+        times.push_back(ms(now - last));
+        ends.push_back(now);
+        last = now;
+    }
+
+    // steady state: median of the second half, reached by the first batch within 10% of it
+    auto secondHalf = std::vector<double>(times.begin() + times.size() / 2, times.end());
+    std::ranges::nth_element(secondHalf, secondHalf.begin() + secondHalf.size() / 2);
+    auto steady = secondHalf[secondHalf.size() / 2];
+    size_t reached{0};
+    while (reached + 1 < times.size() && times[reached] > steady * 1.1) {
+        ++reached;
+    }
+
+    table.entries.push_back({
+        path,
+        dropped ? "yes" : "no",
+        fmt::format("{:.2f}", ms(loaded - start)),
+        fmt::format("{:.1f}", ms(firstQuery - loaded) * 1000.),
+        fmt::format("{:.2f}", ms(ends[reached] - start)),
+        fmt::format("{:.1f}", steady * 1e6 / batchSize),
+        name
+    });
+}
+}
+
+TEST_CASE("benchmark cold start of cereal, bulk and mapped loading", "[serialization][time][coldstart]") {
+    auto size       = envOr("SERIALIZATIONSIZE", 500'000'000, 1'000'000);
+    auto cerealPath = std::filesystem::temp_directory_path() / "pfBitvectors_benchmark_coldstart.cereal";
+    auto bulkPath   = std::filesystem::temp_directory_path() / "pfBitvectors_benchmark_coldstart.bin";
+
+    auto table = Table{};
+    // Mapped is void if the structure has no mapped view
+    auto test = [&]<typename T, typename Mapped>() {
+        auto name = getName<T>();
+        INFO(name);
+        {
+            auto v = generate<T>(size);
+            {
+                auto ofs     = std::ofstream{cerealPath, std::ios::binary};
+                auto archive = cereal::BinaryOutputArchive{ofs};
+                archive(v);
+            }
+            seqan::pfb::saveBinary(v, bulkPath);
+        }
+
+        measureColdStart(table, "cereal", dropPageCache(cerealPath), name, size, [&]() {
+            auto w       = T{};
+            auto ifs     = std::ifstream{cerealPath, std::ios::binary};
+            auto archive = cereal::BinaryInputArchive{ifs};
+            archive(w);
+            return w;
+        });
+        measureColdStart(table, "bulk", dropPageCache(bulkPath), name, size, [&]() {
+            auto w = T{};
+            seqan::pfb::loadBinary(w, bulkPath);
+            return w;
+        });
+        if constexpr (!std::is_void_v<Mapped>) {
+            measureColdStart(table, "mmap", dropPageCache(bulkPath), name, size, [&]() {
+                return Mapped{bulkPath};
+            });
+        }
+        std::filesystem::remove(cerealPath);
+        std::filesystem::remove(bulkPath);
+    };
+
+    test.template operator()<seqan::pfb::Bitvector<512, 65536>,                         seqan::pfb::MappedBitvector<512, 65536>>();
+    test.template operator()<seqan::pfb::Bitvector2LWord<512, 65536>,                   seqan::pfb::MappedBitvector2LWord<512, 65536>>();
+    test.template operator()<seqan::pfb::PairedBitvector<512, 65536>,                   void>();
+    test.template operator()<seqan::pfb::FlattenedBitvectors2L<5, 512, 65536>,          seqan::pfb::MappedFlattenedBitvectors2L<5, 512, 65536>>();
+    test.template operator()<seqan::pfb::PairedFlattenedBitvectors2L<5, 512, 65536>,    seqan::pfb::MappedPairedFlattenedBitvectors2L<5, 512, 65536>>();
+    test.template operator()<seqan::pfb::InterleavedFlattenedBitvectors2L<5, 512, 65536>, void>();
+    test.template operator()<seqan::pfb::FlattenedBitvectors2L<21, 512, 65536>,         seqan::pfb::MappedFlattenedBitvectors2L<21, 512, 65536>>();
+}
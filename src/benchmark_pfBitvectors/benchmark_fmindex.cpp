@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "AllStrings5.h"
+#include "BenchPerf.h"
+#include "BenchUtils.h"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <nanobench.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* End to end FM index search (see pfBitvectors/fmindex/FMIndex.h) on a synthetic genome with every string type
+ * of AllStrings as occurrence table
+ *
+ *  - count():           exact backward search of reads sampled from the genome (rank per step)
+ *  - extend_left_all(): enumerates all k-mers of the genome by a depth first search (all_ranks per step)
+ *
+ * Environment variables:
+ *  - GENOMESIZE:  length of the genome (default 10'000'000)
+ *  - READLENGTH:  length of the reads (default 100)
+ *  - ERRORRATE:   per mille of reads with one substitution, these mostly end early (default 0)
+ *  - KMERLENGTH:  depth of the k-mer enumeration (default 8)
+ */
+
+namespace {
+// number of k-mers (with at least one occurrence) of length depth
+template <typename Index>
+auto enumerate(Index const& index, seqan::pfb::SAInterval interval, size_t depth) -> uint64_t {
+    if (depth == 0) return 1;
+    uint64_t ct{};
+    auto next = index.extend_left_all(interval);
+    for (size_t s{1}; s < next.size(); ++s) {
+        if (!next[s].empty()) {
+            ct += enumerate(index, next[s], depth-1);
+        }
+    }
+    return ct;
+}
+}
+
+TEST_CASE("benchmark fm index search on a synthetic genome", "[string][5][time][fmindex]") {
+    constexpr size_t Sigma = 5;
+    auto genome = generateGenome(envOr("GENOMESIZE", 10'000'000, 100'000));
+    auto bwt    = seqan::pfb::bwt_from_text(genome);
+    auto length = envOr("READLENGTH", 100);
+    auto reads  = sampleReads(genome, 100'000, length, [errorRate = envOr("ERRORRATE", 0)](auto& rng) -> size_t {
+        return rng.bounded(1000) < errorRate;
+    });
+    auto depth  = envOr("KMERLENGTH", 8);
+
+    auto benchCount = ankerl::nanobench::Bench{};
+    benchCount.title("count() - reads of length " + std::to_string(length))
+              .relative(true);
+
+    auto benchKmers = ankerl::nanobench::Bench{};
+    benchKmers.title("extend_left_all() - all " + std::to_string(depth) + "-mers")
+              .relative(true);
+
+    SECTION("benchmarking") {
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+            if (skipTooLong<String>(bwt.size(), name)) return;
+
+            auto index = seqan::pfb::FMIndex<String>{seqan::pfb::from_bwt, bwt};
+
+            size_t i{0};
+            BenchPerf::run(benchCount, name, [&]() {
+                auto ct = index.count(reads[i]);
+                i = (i + 1) % reads.size();
+                ankerl::nanobench::doNotOptimizeAway(ct);
+            });
+            BenchPerf::run(benchKmers, name, [&]() {
+                auto ct = enumerate(index, index.all(), depth);
+                ankerl::nanobench::doNotOptimizeAway(ct);
+            });
+        }, AllStrings{});
+    }
+}
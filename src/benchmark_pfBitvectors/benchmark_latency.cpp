@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "AllBitvectors.h"
+#include "AllStrings5.h"
+#include "BenchLatency.h"
+#include "BenchUtils.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <nanobench.h>
+#include <string>
+#include <vector>
+
+/* Tail latencies (p50/p90/p99/p99.9/max) of single queries at uniformly random positions
+ * for all bit vectors and strings (alphabet 5), see BenchLatency.h
+ *
+ * Environment variables:
+ *  - BITVECTORSIZE, STRINGSIZE: length of the bit vectors and strings
+ *  - QUERIES: timed queries per structure and operation
+ */
+
+TEST_CASE("benchmark tail latencies of bit vectors", "[bitvector][time][latency]") {
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<bool>(envOr("BITVECTORSIZE", 10'000'000, 10'000));
+        for (size_t i{0}; i < text.size(); ++i) {
+            text[i] = rng.bounded(4) == 0;
+        }
+        return text;
+    }();
+    auto queries = envOr("QUERIES", 10'000'000, 10'000);
+
+    auto table = BenchLatency{};
+    call_with_templates([&]<typename Vector>() {
+        auto name = getName<Vector>();
+        INFO(name);
+        if (skipTooLong<Vector>(text.size(), name)) return;
+
+        auto vec = Vector{text};
+        table.addEntry(name + " - rank", latency::measure(text.size(), queries, [&](size_t pos) {
+            return vec.rank(pos);
+        }));
+        table.addEntry(name + " - symbol", latency::measure(text.size(), queries, [&](size_t pos) {
+            return vec.symbol(pos);
+        }));
+    }, AllBitvectors{});
+}
+
+TEST_CASE("benchmark tail latencies of strings - 5 alphabet", "[string][5][time][latency]") {
+    constexpr size_t Sigma = 5;
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<uint8_t>(envOr("STRINGSIZE", 1'000'000, 10'000));
+        for (auto& c : text) {
+            c = rng.bounded(Sigma);
+        }
+        return text;
+    }();
+    auto queries = envOr("QUERIES", 10'000'000, 10'000);
+
+    auto table = BenchLatency{};
+    call_with_templates([&]<template <size_t> class _String>() {
+        using String = _String<Sigma>;
+        auto name = getName<String>();
+        INFO(name);
+        if (skipTooLong<String>(text.size(), name)) return;
+
+        auto str = String{text};
+        // the symbol is derived from the position, a cheap modulo instead of a second random number
+        table.addEntry(name + " - rank", latency::measure(text.size(), queries, [&](size_t pos) {
+            return str.rank(pos, pos % Sigma);
+        }));
+        table.addEntry(name + " - symbol", latency::measure(text.size(), queries, [&](size_t pos) {
+            return str.symbol(pos);
+        }));
+        table.addEntry(name + " - prefix_rank", latency::measure(text.size(), queries, [&](size_t pos) {
+            return str.prefix_rank(pos, pos % Sigma);
+        }));
+        table.addEntry(name + " - all_ranks", latency::measure(text.size(), queries, [&](size_t pos) {
+            return sumOfRanks(str.all_ranks(pos));
+        }));
+    }, AllStrings{});
+}
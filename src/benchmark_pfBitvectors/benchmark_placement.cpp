@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include <pfBitvectors/pfBitvectors.h>
+
+#if defined(__linux__) && defined(__cpp_lib_memory_resource)
+
+#include "BenchUtils.h"
+
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <nanobench.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Rank throughput of multiple threads, pinned to the cpus of each NUMA node,
+ * for different placements of the same bit vector:
+ *  - default:       std::pmr::new_delete_resource, 4KB pages, placed where it was first touched
+ *  - huge pages:    2MB aligned with madvise(MADV_HUGEPAGE) (hugePageResource)
+ *  - NUMA replicas: one copy in huge pages per node, every thread queries the copy of its node
+ * Rows are marked if threads could not be pinned or replicas could not be bound to their node.
+ */
+
+namespace {
+auto bitvectorSize() -> size_t {
+    #ifdef NDEBUG
+        return envOr("BITVECTORSIZE", 1'000'000'000);
+    #else
+        return envOr("BITVECTORSIZE", 100'000);
+    #endif
+}
+
+struct Table {
+    std::vector<std::vector<std::string>> entries;
+
+    ~Table() {
+        if (entries.size() < 2) return;
+        auto c = std::vector<size_t>(entries[0].size());
+        for (auto const& e : entries) {
+            for (size_t i{0}; i < c.size(); ++i) {
+                c[i] = std::max(c[i], e[i].size());
+            }
+        }
+        fmt::print("\n");
+        for (auto const& e : entries) {
+            for (size_t i{0}; i+1 < c.size(); ++i) {
+                fmt::print("| {: >{}} ", e[i], c[i]);
+            }
+            fmt::print("| {: <{}} |\n", e.back(), c.back());
+        }
+    }
+};
+
+struct Throughput {
+    std::vector<double> perNode; // queries/s
+    bool pinned{true};           // all threads were restricted to the cpus of their node
+};
+
+/* Runs `threadsPerNode` threads on each node, every thread answers `queries` random rank queries
+ * on the bit vector returned by select() (called on the pinned thread). Returns the throughput of each node
+ */
+template <typename Select>
+auto runPinned(size_t threadsPerNode, size_t queries, Select select) -> Throughput {
+    auto& topology = seqan::pfb::NumaTopology::get();
+    auto nodes     = topology.nodes();
+    auto seconds   = std::vector<double>(nodes * threadsPerNode);
+    auto ready     = std::atomic<size_t>{0};
+    auto unpinned  = std::atomic<size_t>{0};
+    auto threads   = std::vector<std::thread>{};
+    for (size_t node{0}; node < nodes; ++node) {
+        for (size_t i{0}; i < threadsPerNode; ++i) {
+            threads.emplace_back([&, node, i]() {
+                if (!topology.bindCurrentThread(node)) {
+                    unpinned.fetch_add(1);
+                }
+                auto const& vec = select();
+                auto rng = ankerl::nanobench::Rng{node * threadsPerNode + i};
+                // start all threads at the same time
+                ready.fetch_add(1);
+                while (ready.load() < seconds.size()) {}
+                auto start = std::chrono::steady_clock::now();
+                uint64_t checksum{};
+                for (size_t q{0}; q < queries; ++q) {
+                    checksum += vec.rank(rng.bounded(vec.size()));
+                }
+                ankerl::nanobench::doNotOptimizeAway(checksum);
+                seconds[node * threadsPerNode + i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            });
+        }
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto throughput = Throughput{std::vector<double>(nodes), unpinned.load() == 0};
+    for (size_t node{0}; node < nodes; ++node) {
+        for (size_t i{0}; i < threadsPerNode; ++i) {
+            throughput.perNode[node] += queries / seconds[node * threadsPerNode + i];
+        }
+    }
+    return throughput;
+}
+}
+
+TEST_CASE("benchmark rank throughput for huge page and NUMA placement", "[bitvector][time][placement]") {
+    using Vector = seqan::pfb::pmr::Bitvector2L<512, 65536>;
+
+    auto& topology = seqan::pfb::NumaTopology::get();
+    auto threadsPerNode = envOr("THREADS", topology.cpus[0].size());
+    auto queries        = envOr("QUERIES", 10'000'000);
+
+    auto source = [&]() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<bool>(bitvectorSize());
+        for (size_t i{0}; i < text.size(); ++i) {
+            text[i] = rng.bounded(4) == 0;
+        }
+        return Vector{text};
+    }();
+
+    auto table = Table{};
+    table.entries.push_back({"threads"});
+    for (size_t node{0}; node < topology.nodes(); ++node) {
+        table.entries[0].push_back(fmt::format("node {} Mrank/s", topology.ids[node]));
+    }
+    table.entries[0].push_back("total Mrank/s");
+    table.entries[0].push_back("name");
+
+    auto addEntry = [&](std::string name, Throughput const& throughput) {
+        if (!throughput.pinned) {
+            name += " (threads not pinned)";
+        }
+        auto e = std::vector<std::string>{fmt::format("{}", threadsPerNode * topology.nodes())};
+        double total{};
+        for (auto t : throughput.perNode) {
+            e.push_back(fmt::format("{:.2f}", t / 1e6));
+            total += t;
+        }
+        e.push_back(fmt::format("{:.2f}", total / 1e6));
+        e.push_back(getName<Vector>() + " - " + name);
+        table.entries.push_back(e);
+    };
+
+    {
+        auto vec = Vector{source, seqan::pfb::pmr::allocator{std::pmr::new_delete_resource()}};
+        addEntry("default", runPinned(threadsPerNode, queries, [&]() -> Vector const& { return vec; }));
+    }
+    {
+        auto vec = Vector{source, seqan::pfb::pmr::allocator{seqan::pfb::hugePageResource()}};
+        addEntry("huge pages", runPinned(threadsPerNode, queries, [&]() -> Vector const& { return vec; }));
+    }
+    {
+        auto replicas = seqan::pfb::NumaReplicated<Vector>{source};
+        auto name     = std::string{"huge pages + NUMA replicas"};
+        if (!replicas.bound()) {
+            name += " (replicas not bound to their node)";
+        }
+        addEntry(name, runPinned(threadsPerNode, queries, [&]() -> Vector const& { return replicas.local(); }));
+    }
+}
+
+#endif
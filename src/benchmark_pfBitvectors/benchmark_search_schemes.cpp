@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "AllStrings5.h"
+#include "BenchPerf.h"
+#include "BenchUtils.h"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <nanobench.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Approximate search (Hamming distance) with a bidirectional FM index (see pfBitvectors/fmindex/SearchScheme.h)
+ * on a synthetic genome, with every string type of AllStrings for the forward and the reverse BWT
+ *
+ *  - kucherov:     optimal search schemes of Kucherov et al. (k+1 parts)
+ *  - pigeonhole:   one error free part, one search per part
+ *  - backtracking: single search from right to left, no bounds on the errors
+ * Every step extends by all symbols with all_ranks_and_prefix_ranks, except where no errors are left.
+ *
+ * Environment variables:
+ *  - GENOMESIZE:  length of the genome (default 10'000'000)
+ *  - READLENGTH:  length of the reads (default 100)
+ *  - ERRORS:      number of allowed substitutions k, each read has up to k substitutions (default 2)
+ */
+
+TEST_CASE("benchmark approximate search with search schemes on a synthetic genome", "[string][5][time][searchscheme]") {
+    constexpr size_t Sigma = 5;
+    auto genome  = generateGenome(envOr("GENOMESIZE", 10'000'000, 100'000));
+    auto bwt     = seqan::pfb::bwt_from_text(genome);
+    auto bwtRev  = seqan::pfb::bwt_from_text(std::vector<uint8_t>(genome.rbegin(), genome.rend()));
+    auto length  = envOr("READLENGTH", 100);
+    auto k       = envOr("ERRORS", 2);
+    auto reads   = sampleReads(genome, 10'000, length, [k](auto& rng) -> size_t {
+        // 0...k substitutions, uniformly distributed
+        return rng.bounded(k + 1);
+    });
+
+    auto schemes = std::vector<std::pair<std::string, seqan::pfb::SearchScheme>>{
+        {"kucherov",     seqan::pfb::kucherov_scheme(k)},
+        {"pigeonhole",   seqan::pfb::pigeonhole_scheme(k)},
+        {"backtracking", seqan::pfb::backtracking_scheme(k)},
+    };
+
+    auto benches = std::vector<ankerl::nanobench::Bench>(schemes.size());
+    for (size_t i{0}; i < schemes.size(); ++i) {
+        benches[i].title("search_hamming() - " + schemes[i].first + " - k=" + std::to_string(k) + " - reads of length " + std::to_string(length))
+                  .relative(true);
+    }
+
+    SECTION("benchmarking") {
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+            if (skipTooLong<String>(bwt.size(), name)) return;
+
+            auto index = seqan::pfb::BiFMIndex<String>{seqan::pfb::from_bwt, bwt, bwtRev};
+
+            for (size_t j{0}; j < schemes.size(); ++j) {
+                auto const& scheme = schemes[j].second;
+                size_t i{0};
+                BenchPerf::run(benches[j], name, [&]() {
+                    uint64_t ct{};
+                    seqan::pfb::search_hamming(index, reads[i], scheme, [&](seqan::pfb::BiSAInterval interval, size_t) {
+                        ct += interval.size();
+                    });
+                    i = (i + 1) % reads.size();
+                    ankerl::nanobench::doNotOptimizeAway(ct);
+                });
+            }
+        }, AllStrings{});
+    }
+}
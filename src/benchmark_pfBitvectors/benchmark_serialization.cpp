@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "BenchPerf.h"
+
+#include <catch2/catch_all.hpp>
+#include <cereal/archives/binary.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using SerializationStructures = std::variant<
+    seqan::pfb::Bitvector<512, 65536>,
+    seqan::pfb::PairedBitvector<512, 65536>,
+    seqan::pfb::FlattenedBitvectors2L<4, 512, 65536>,
+    seqan::pfb::FlattenedBitvectors2L<21, 512, 65536>,
+    seqan::pfb::InterleavedFlattenedBitvectors2L<21, 512, 65536>,
+    std::monostate /*delimiter, is ignored*/
+>;
+
+namespace {
+// number of bits/symbols of each structure
+auto structureSize() -> size_t {
+    auto ptr = std::getenv("SERIALIZATIONSIZE");
+    if (ptr) {
+        return std::stoull(ptr);
+    }
+    #ifdef NDEBUG
+        return 500'000'000;
+    #else
+        return 1'000'000;
+    #endif
+}
+
+template <typename T>
+auto generate() -> T {
+    auto rng = ankerl::nanobench::Rng{};
+    if constexpr (requires() { T::Sigma; }) {
+        auto text = std::vector<uint8_t>(structureSize());
+        for (auto& c : text) {
+            c = rng.bounded(T::Sigma);
+        }
+        return T{text};
+    } else {
+        auto text = std::vector<uint8_t>(structureSize());
+        for (auto& c : text) {
+            c = rng.bounded(4) == 0;
+        }
+        return T{text};
+    }
+}
+}
+
+TEST_CASE("benchmark save/load throughput", "[serialization][time]") {
+    auto path = std::filesystem::temp_directory_path() / "pfBitvectors_benchmark_bulk.bin";
+    auto threadCt = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    auto benchSave = ankerl::nanobench::Bench{};
+    benchSave.title("save throughput")
+             .unit("byte")
+             .epochs(3)
+             .epochIterations(1)
+             .relative(true);
+    auto benchLoad = ankerl::nanobench::Bench{};
+    benchLoad.title("load throughput")
+             .unit("byte")
+             .epochs(3)
+             .epochIterations(1)
+             .relative(true);
+
+    call_with_templates([&]<typename T>() {
+        auto name = getName<T>();
+        INFO(name);
+        auto v = generate<T>();
+
+        // size of the bulk archive, used as byte count for all variants
+        auto bytes = [&]() {
+            auto archive = seqan::pfb::BulkOutputArchive{};
+            archive(v);
+            return archive.size();
+        }();
+        benchSave.batch(bytes);
+        benchLoad.batch(bytes);
+
+        auto cerealArchive = std::string{};
+        BenchPerf::run(benchSave, name + " - cereal", [&]() {
+            auto ss = std::stringstream{};
+            {
+                auto archive = cereal::BinaryOutputArchive{ss};
+                archive(v);
+            }
+            cerealArchive = ss.str();
+        });
+        BenchPerf::run(benchLoad, name + " - cereal", [&]() {
+            auto ss = std::stringstream{cerealArchive};
+            auto w = T{};
+            auto archive = cereal::BinaryInputArchive{ss};
+            archive(w);
+            ankerl::nanobench::doNotOptimizeAway(w);
+        });
+        cerealArchive = {};
+
+        auto bulkArchive = std::string{};
+        BenchPerf::run(benchSave, name + " - bulk stream", [&]() {
+            auto ss = std::stringstream{};
+            seqan::pfb::saveBinary(v, ss);
+            bulkArchive = ss.str();
+        });
+        BenchPerf::run(benchLoad, name + " - bulk stream", [&]() {
+            auto ss = std::stringstream{bulkArchive};
+            auto w = T{};
+            seqan::pfb::loadBinary(w, ss);
+            ankerl::nanobench::doNotOptimizeAway(w);
+        });
+        bulkArchive = {};
+
+        for (auto threads : {size_t{1}, threadCt}) {
+            auto suffix = " - bulk file, " + std::to_string(threads) + " thread(s)";
+            BenchPerf::run(benchSave, name + suffix, [&]() {
+                seqan::pfb::saveBinary(v, path, threads);
+            });
+            BenchPerf::run(benchLoad, name + suffix, [&]() {
+                auto w = T{};
+                seqan::pfb::loadBinary(w, path, threads);
+                ankerl::nanobench::doNotOptimizeAway(w);
+            });
+            if (threadCt == 1) break;
+        }
+        std::filesystem::remove(path);
+    }, SerializationStructures{});
+}
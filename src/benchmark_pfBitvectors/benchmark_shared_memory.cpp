@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include <pfBitvectors/pfBitvectors.h>
+
+#if PFBITVECTORS_SHM
+
+#include "BenchUtils.h"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <nanobench.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* Starts multiple processes that answer rank queries on the same structure,
+ * either each with a private copy (loaded via loadBinary) or all attached to
+ * one shared memory object. Reports the aggregated throughput and the resident memory
+ * per process (private: pages only mapped by this process, shared: pages also mapped by others)
+ */
+
+namespace {
+// number of bits/symbols of each structure
+auto structureSize() -> size_t {
+    #ifdef NDEBUG
+        return envOr("STRINGSIZE", 1'000'000'000);
+    #else
+        return envOr("STRINGSIZE", 1'000'000);
+    #endif
+}
+
+auto processCount() -> size_t {
+    return envOr("PROCESSES", std::max<size_t>(1, std::thread::hardware_concurrency()));
+}
+
+struct ProcessResult {
+    size_t queries{};
+    double seconds{};
+    size_t privateKB{};
+    size_t sharedKB{};
+    uint64_t checksum{};
+};
+
+// resident memory of this process, split into pages only used by this process and pages shared with others
+void readRss(ProcessResult& r) {
+    auto ifs = std::ifstream{"/proc/self/smaps_rollup"};
+    auto line = std::string{};
+    while (std::getline(ifs, line)) {
+        auto value = [&]() -> size_t {
+            return std::stoull(line.substr(line.find(':') + 1));
+        };
+        if (line.starts_with("Private_Clean:") || line.starts_with("Private_Dirty:")) r.privateKB += value();
+        if (line.starts_with("Shared_Clean:")  || line.starts_with("Shared_Dirty:"))  r.sharedKB  += value();
+    }
+    if (r.privateKB == 0 && r.sharedKB == 0) {
+        // no /proc (e.g. macOS), only the peak resident size is known
+        auto usage = rusage{};
+        getrusage(RUSAGE_SELF, &usage);
+        r.privateKB = static_cast<size_t>(usage.ru_maxrss);
+        #ifdef __APPLE__
+            r.privateKB /= 1024;
+        #endif
+    }
+}
+
+template <typename T>
+auto runQueries(T const& v, size_t queries, uint64_t seed) -> ProcessResult {
+    auto rng = ankerl::nanobench::Rng{seed};
+    auto r = ProcessResult{};
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i{0}; i < queries; ++i) {
+        auto idx = rng.bounded(v.size());
+        if constexpr (requires() { T::Sigma; }) {
+            r.checksum += v.rank(idx, rng.bounded(T::Sigma));
+        } else {
+            r.checksum += v.rank(idx);
+        }
+    }
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    r.queries = queries;
+    readRss(r);
+    return r;
+}
+
+// forks `processes` children, each calls job() and reports its result through a pipe
+template <typename Job>
+auto runProcesses(size_t processes, Job job) -> std::vector<ProcessResult> {
+    auto pipes = std::vector<std::array<int, 2>>(processes);
+    auto pids  = std::vector<pid_t>{};
+    for (size_t i{0}; i < processes; ++i) {
+        if (::pipe(pipes[i].data()) != 0) {
+            throw std::runtime_error{"can not create pipe"};
+        }
+        auto pid = ::fork();
+        if (pid == 0) {
+            ::close(pipes[i][0]);
+            auto r = ProcessResult{};
+            try {
+                r = job(i);
+            } catch (...) {
+                ::_exit(1);
+            }
+            auto written = ::write(pipes[i][1], &r, sizeof(r));
+            ::_exit(written == sizeof(r) ? 0 : 1);
+        }
+        ::close(pipes[i][1]);
+        pids.push_back(pid);
+    }
+    auto results = std::vector<ProcessResult>{};
+    for (size_t i{0}; i < processes; ++i) {
+        auto r = ProcessResult{};
+        if (::read(pipes[i][0], &r, sizeof(r)) == sizeof(r)) {
+            results.push_back(r);
+        }
+        ::close(pipes[i][0]);
+        int status{};
+        ::waitpid(pids[i], &status, 0);
+    }
+    return results;
+}
+
+struct Table {
+    std::vector<std::array<std::string, 6>> entries {
+        {"processes", "Mrank/s total", "Mrank/s per process", "private MB/process", "shared MB/process", "name"}
+    };
+
+    void addEntry(std::string name, std::vector<ProcessResult> const& results) {
+        double slowest{};
+        size_t queries{}, privateKB{}, sharedKB{};
+        for (auto const& r : results) {
+            slowest = std::max(slowest, r.seconds);
+            queries   += r.queries;
+            privateKB += r.privateKB;
+            sharedKB  += r.sharedKB;
+        }
+        auto n = std::max<size_t>(1, results.size());
+        entries.push_back({
+            fmt::format("{}", results.size()),
+            fmt::format("{:.2f}", queries / slowest / 1e6),
+            fmt::format("{:.2f}", queries / slowest / 1e6 / n),
+            fmt::format("{:.1f}", privateKB / 1024. / n),
+            fmt::format("{:.1f}", sharedKB / 1024. / n),
+            name,
+        });
+    }
+
+    ~Table() {
+        if (entries.size() < 2) return;
+        auto c = std::array<size_t, 6>{};
+        for (auto const& e : entries) {
+            for (size_t i{0}; i < c.size(); ++i) {
+                c[i] = std::max(c[i], e[i].size());
+            }
+        }
+        fmt::print("\n");
+        for (auto const& e : entries) {
+            fmt::print("| {: >{}} | {: >{}} | {: >{}} | {: >{}} | {: >{}} | {: <{}} |\n",
+                e[0], c[0], e[1], c[1], e[2], c[2], e[3], c[3], e[4], c[4], e[5], c[5]);
+        }
+    }
+};
+
+template <typename T>
+auto generate() -> T {
+    auto rng = ankerl::nanobench::Rng{};
+    auto text = std::vector<uint8_t>(structureSize());
+    for (auto& c : text) {
+        if constexpr (requires() { T::Sigma; }) {
+            c = rng.bounded(T::Sigma);
+        } else {
+            c = rng.bounded(2);
+        }
+    }
+    return T{text};
+}
+}
+
+TEST_CASE("benchmark multi-process rank throughput with shared memory", "[shm][time]") {
+    auto processes = processCount();
+    auto queries   = envOr("QUERIES", 10'000'000);
+    auto table     = Table{};
+
+    auto bench = [&]<typename T, typename View>() {
+        auto name = getName<T>();
+        auto path = std::filesystem::temp_directory_path() / "pfBitvectors_benchmark_shm.bin";
+        seqan::pfb::saveBinary(generate<T>(), path);
+
+        // private copies, every process loads the structure itself
+        // (nothing is allocated in the parent, so no pages are inherited)
+        table.addEntry(name + " - private copy", runProcesses(processes, [&](size_t i) {
+            auto w = T{};
+            seqan::pfb::loadBinary(w, path);
+            return runQueries(w, queries, i);
+        }));
+
+        // one shared memory object
+        auto shmName = "/pfBitvectors_benchmark_shm_" + std::to_string(::getpid());
+        auto owner = [&]() {
+            auto v = T{};
+            seqan::pfb::loadBinary(v, path);
+            return seqan::pfb::publishShared(v, shmName);
+        }();
+        std::filesystem::remove(path);
+        table.addEntry(name + " - shared memory", runProcesses(processes, [&](size_t i) {
+            auto view = View{seqan::pfb::attachShared(shmName)};
+            return runQueries(view, queries, i);
+        }));
+    };
+    bench.template operator()<seqan::pfb::Bitvector<512, 65536>,
+                              seqan::pfb::MappedBitvector<512, 65536>>();
+    bench.template operator()<seqan::pfb::FlattenedBitvectors2L<5, 512, 65536>,
+                              seqan::pfb::MappedFlattenedBitvectors2L<5, 512, 65536>>();
+}
+
+#endif
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+// compiled as its own executable with PFBITVECTORS_STATS=1
+#include "BenchStats.h"
+#include "BenchUtils.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <vector>
+
+static_assert(seqan::pfb::stats::enabled, "benchmark_stats must be compiled with PFBITVECTORS_STATS=1");
+
+/* Counts the l0/l1/block reads and the block reuse distance of rank queries
+ * for sequential, strided and uniform random positions
+ */
+
+namespace {
+auto textSize() -> size_t {
+    #ifdef NDEBUG
+        return envOr("TEXTSIZE", 100'000'000);
+    #else
+        return envOr("TEXTSIZE", 100'000);
+    #endif
+}
+
+// calls `query(pos)` for `queries` positions in [0, size) of each access pattern
+template <typename Query>
+void runPatterns(BenchStats& table, std::string const& name, size_t size, Query query) {
+    auto queries = envOr("QUERIES", 1'000'000);
+    auto run = [&](std::string pattern, auto next) {
+        seqan::pfb::stats::reset();
+        for (size_t i{0}; i < queries; ++i) {
+            ankerl::nanobench::doNotOptimizeAway(query(next(i)));
+        }
+        table.addEntry(name + " - " + pattern, seqan::pfb::stats::local());
+    };
+    run("sequential", [&](size_t i) { return i % size; });
+    run("stride 4099", [&](size_t i) { return (i * 4099) % size; });
+    auto rng = ankerl::nanobench::Rng{};
+    run("random", [&](size_t) { return rng.bounded(size); });
+}
+}
+
+TEST_CASE("count block accesses of bit vectors", "[bitvector][stats]") {
+    auto rng  = ankerl::nanobench::Rng{};
+    auto text = std::vector<uint8_t>(textSize());
+    for (auto& c : text) {
+        c = rng.bounded(4) == 0;
+    }
+
+    auto table = BenchStats{};
+    auto test = [&]<typename Vector>() {
+        auto vec = Vector{text};
+        runPatterns(table, getName<Vector>(), text.size(), [&](size_t idx) { return vec.rank(idx); });
+    };
+    test.template operator()<seqan::pfb::Bitvector1L<512>>();
+    test.template operator()<seqan::pfb::Bitvector2L<512, 65536>>();
+    test.template operator()<seqan::pfb::PairedBitvector2L<512, 65536>>();
+}
+
+TEST_CASE("count block accesses of strings", "[string][stats]") {
+    constexpr size_t Sigma = 5;
+    auto rng  = ankerl::nanobench::Rng{};
+    auto text = std::vector<uint8_t>(textSize());
+    for (auto& c : text) {
+        c = rng.bounded(Sigma);
+    }
+
+    auto table = BenchStats{};
+    auto test = [&]<typename String>() {
+        auto str = String{text};
+        runPatterns(table, getName<String>() + " - rank", text.size(), [&](size_t idx) { return str.rank(idx, text[idx]); });
+        runPatterns(table, getName<String>() + " - all_ranks", text.size(), [&](size_t idx) { return str.all_ranks(idx)[0]; });
+    };
+    test.template operator()<seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>>();
+    test.template operator()<seqan::pfb::PairedFlattenedBitvectors2L<Sigma, 512, 65536>>();
+    test.template operator()<seqan::pfb::InterleavedFlattenedBitvectors2L<Sigma, 512, 65536>>();
+    test.template operator()<seqan::pfb::WaveletMatrix<Sigma>>();
+}
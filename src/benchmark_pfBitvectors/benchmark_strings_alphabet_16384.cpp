@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: CC0-1.0
 
+#include "BenchPerf.h"
 #include "BenchSize.h"
 
 #include <catch2/catch_all.hpp>
@@ -92,7 +93,7 @@ TEST_CASE("benchmark strings c'tor operation - " SIGMA_STR " alphabet", "[string
             auto name = getName<String>();
             INFO(name);
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto str = String{text};
                 ankerl::nanobench::doNotOptimizeAway(const_cast<String const&>(str));
             });
@@ -117,7 +118,7 @@ TEST_CASE("benchmark vectors symbol() operations - " SIGMA_STR " alphabet", "[st
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.symbol(rng.bounded(text.size()));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -141,7 +142,7 @@ TEST_CASE("benchmark vectors rank() operations - " SIGMA_STR " alphabet", "[stri
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -165,7 +166,7 @@ TEST_CASE("benchmark vectors prefix_rank() operations - " SIGMA_STR " alphabet",
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.prefix_rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -190,7 +191,7 @@ TEST_CASE("benchmark vectors all_ranks() operations - " SIGMA_STR " alphabet", "
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.all_ranks(rng.bounded(text.size()+1));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -214,7 +215,7 @@ TEST_CASE("benchmark vectors all_ranks_and_prefix_ranks() operations - Sigma alp
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.all_ranks_and_prefix_ranks(rng.bounded(text.size()+1));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -229,7 +230,7 @@ TEST_CASE("benchmark vectors in size - alphabet " SIGMA_STR, "[string][" SIGMA_S
         BenchSize benchSize;
         benchSize.baseSize = std::ceil(std::log2(Sigma));
         benchSize.entries[0][2] = "bits/char";
-        benchSize.entries[0][4] = "alphabet " SIGMA_STR;
+        benchSize.entries[0].back() = "alphabet " SIGMA_STR;
 
         call_with_templates([&]<template <size_t> class _String>() {
             using String = _String<Sigma>;
@@ -237,18 +238,7 @@ TEST_CASE("benchmark vectors in size - alphabet " SIGMA_STR, "[string][" SIGMA_S
             INFO(name);
 
             auto str = String{text};
-            auto size = [&]() {
-                auto ofs     = std::stringstream{};
-                auto archive = cereal::BinaryOutputArchive{ofs};
-                archive(str);
-                return ofs.str().size();
-            }();
-            benchSize.addEntry({
-                .name = name,
-                .size = size,
-                .text_size = text.size(),
-                .bits_per_char = (size*8)/double(text.size())
-            });
+            benchSize.addEntry(name, str, text.size());
         }, AllStrings{});
     }
 }
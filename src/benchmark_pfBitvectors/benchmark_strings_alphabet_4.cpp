@@ -2,7 +2,9 @@
 // SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: CC0-1.0
 
+#include "BenchPerf.h"
 #include "BenchSize.h"
+#include "BenchUtils.h"
 
 #include <catch2/catch_all.hpp>
 #include <cereal/archives/binary.hpp>
@@ -45,6 +47,13 @@ using AllStrings = Variant<
     Instance<seqan::pfb::PairedFlattenedBitvectors2L,  512, 65536>::Type,
 //    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 1024, 65536>::Type,
 //    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 2048, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,  512, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L, 1024, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2LWord,        512, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2LWord,  512, 65536>::Type,
+// narrower counters, uint8_t l1 (64/256) and uint32_t l0 (...32)
+    Instance<seqan::pfb::FlattenedBitvectors2L,             64,   256>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L32,          512, 65536>::Type,
     Delimiter /*delimiter, is ignored*/
 >;
 
@@ -96,8 +105,9 @@ TEST_CASE("benchmark strings c'tor operation - " SIGMA_STR " alphabet", "[string
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto str = String{text};
                 ankerl::nanobench::doNotOptimizeAway(const_cast<String const&>(str));
             });
@@ -119,10 +129,11 @@ TEST_CASE("benchmark vectors symbol() operations - " SIGMA_STR " alphabet", "[st
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.symbol(rng.bounded(text.size()));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -143,10 +154,11 @@ TEST_CASE("benchmark vectors rank() operations - " SIGMA_STR " alphabet", "[stri
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -167,10 +179,11 @@ TEST_CASE("benchmark vectors prefix_rank() operations - " SIGMA_STR " alphabet",
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.prefix_rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -190,12 +203,13 @@ TEST_CASE("benchmark vectors all_ranks() operations - " SIGMA_STR " alphabet", "
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto rng = ankerl::nanobench::Rng{};
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.all_ranks(rng.bounded(text.size()+1));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -216,16 +230,71 @@ TEST_CASE("benchmark vectors all_ranks_and_prefix_ranks() operations - Sigma alp
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.all_ranks_and_prefix_ranks(rng.bounded(text.size()+1));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
         }, AllStrings{});
     }
 }
+TEST_CASE("benchmark simd kernels rank() and prefix_rank() operations - " SIGMA_STR " alphabet", "[string][" SIGMA_STR "][time][simd]") {
+    auto const& text = generateText<0, Sigma>();
+
+    using SimdStrings = Variant<
+        Instance<seqan::pfb::FlattenedBitvectors2L,       512, 65536>::Type,
+        Instance<seqan::pfb::PairedFlattenedBitvectors2L, 512, 65536>::Type,
+        Delimiter /*delimiter, is ignored*/
+    >;
+
+    auto detected = seqan::pfb::simd::level;
+    auto levels = std::vector<std::pair<seqan::pfb::simd::Level, std::string>>{{seqan::pfb::simd::Level::None, "portable"}};
+    if (detected >= seqan::pfb::simd::Level::AVX2)   levels.emplace_back(seqan::pfb::simd::Level::AVX2, "avx2");
+    if (detected >= seqan::pfb::simd::Level::AVX512) levels.emplace_back(seqan::pfb::simd::Level::AVX512, "avx512");
+    if constexpr (!seqan::pfb::simd::runtime_dispatch) {
+        // the kernel is selected by the compile flags, simd::level has no effect
+        levels = {{seqan::pfb::simd::compiled, "compile-time"}};
+    }
+
+    for (auto op : {"rank()", "prefix_rank()"}) {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title(std::string{op} + " simd kernels")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            if (skipTooLong<String>(text.size(), getName<String>())) return;
+            auto str = String{text};
+
+            for (auto const& [level, levelName] : levels) {
+                auto name = getName<String>() + " - " + levelName;
+                INFO(name);
+                seqan::pfb::simd::level = level;
+
+                auto rng = ankerl::nanobench::Rng{};
+                if (op == std::string{"rank()"}) {
+                    BenchPerf::run(bench, name, [&]() {
+                        auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
+                        ankerl::nanobench::doNotOptimizeAway(v);
+                    });
+                } else {
+                    BenchPerf::run(bench, name, [&]() {
+                        auto v = str.prefix_rank(rng.bounded(text.size()+1), rng.bounded(Sigma+1));
+                        ankerl::nanobench::doNotOptimizeAway(v);
+                    });
+                }
+            }
+        }, SimdStrings{});
+    }
+    seqan::pfb::simd::level = detected;
+}
+TEST_CASE("benchmark compile-time symbol rank() operations - " SIGMA_STR " alphabet", "[string][" SIGMA_STR "][time][static]") {
+    benchStaticRank<Sigma>(generateText<0, Sigma>());
+}
+
 TEST_CASE("benchmark vectors in size - alphabet " SIGMA_STR, "[string][" SIGMA_STR "][size]") {
     auto const& text = generateText<0, Sigma>();
     auto rng = ankerl::nanobench::Rng{};
@@ -234,26 +303,16 @@ TEST_CASE("benchmark vectors in size - alphabet " SIGMA_STR, "[string][" SIGMA_S
         BenchSize benchSize;
         benchSize.baseSize = std::ceil(std::log2(Sigma));
         benchSize.entries[0][2] = "bits/char";
-        benchSize.entries[0][4] = "alphabet " SIGMA_STR;
+        benchSize.entries[0].back() = "alphabet " SIGMA_STR;
 
         call_with_templates([&]<template <size_t> class _String>() {
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
-            auto size = [&]() {
-                auto ofs     = std::stringstream{};
-                auto archive = cereal::BinaryOutputArchive{ofs};
-                archive(str);
-                return ofs.str().size();
-            }();
-            benchSize.addEntry({
-                .name = name,
-                .size = size,
-                .text_size = text.size(),
-                .bits_per_char = (size*8)/double(text.size())
-            });
+            benchSize.addEntry(name, str, text.size());
         }, AllStrings{});
     }
 }
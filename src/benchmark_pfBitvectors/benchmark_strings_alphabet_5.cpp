@@ -2,7 +2,10 @@
 // SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: CC0-1.0
 
+#include "AllStrings5.h"
+#include "BenchPerf.h"
 #include "BenchSize.h"
+#include "BenchUtils.h"
 
 #include <catch2/catch_all.hpp>
 #include <cereal/archives/binary.hpp>
@@ -21,37 +24,6 @@ namespace {
     #define SIGMA_STR TOSTRING(SIGMA)
 }
 
-using AllStrings = Variant<
-    seqan::pfb::MultiBitvectorFixed,
-#ifdef PFBITVECTORS_USE_AWFMINDEX
-    seqan::pfb::AWFMIndex,
-#endif
-#ifdef PFBITVECTORS_USE_SDSL
-    seqan::pfb::Sdsl_wt_bldc,
-    seqan::pfb::Sdsl_wt_epr,
-#endif
-//    Instance<seqan::pfb::FlattenedBitvectors2L,   64,  4096>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L,  128,  4096>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L,  256,  4096>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L,  512,  4096>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L, 1024,  4096>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L, 2048,  4096>::Type,
-    Instance<seqan::pfb::FlattenedBitvectors2L,   64, 65536>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L,  128, 65536>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L,  256, 65536>::Type,
-    Instance<seqan::pfb::FlattenedBitvectors2L,  512, 65536>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L, 1024, 65536>::Type,
-//    Instance<seqan::pfb::FlattenedBitvectors2L, 2048, 65536>::Type,
-    Instance<seqan::pfb::PairedFlattenedBitvectors2L,   64, 65536>::Type,
-//    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  128, 65536>::Type,
-//    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  256, 65536>::Type,
-    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  512, 65536>::Type,
-//    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 1024, 65536>::Type,
-//    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 2048, 65536>::Type,
-    Delimiter /*delimiter, is ignored*/
->;
-
-
 template <size_t min, size_t range>
 auto generateText(size_t length) -> std::vector<uint8_t> {
     auto rng = ankerl::nanobench::Rng{};
@@ -99,8 +71,9 @@ TEST_CASE("benchmark strings c'tor operation - " SIGMA_STR " alphabet", "[string
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto str = String{text};
                 ankerl::nanobench::doNotOptimizeAway(const_cast<String const&>(str));
             });
@@ -122,10 +95,11 @@ TEST_CASE("benchmark vectors symbol() operations - " SIGMA_STR " alphabet", "[st
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.symbol(rng.bounded(text.size()));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -146,10 +120,11 @@ TEST_CASE("benchmark vectors rank() operations - " SIGMA_STR " alphabet", "[stri
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -170,10 +145,11 @@ TEST_CASE("benchmark vectors prefix_rank() operations - " SIGMA_STR " alphabet",
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.prefix_rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -193,12 +169,13 @@ TEST_CASE("benchmark vectors all_ranks() operations - " SIGMA_STR " alphabet", "
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto rng = ankerl::nanobench::Rng{};
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.all_ranks(rng.bounded(text.size()+1));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
@@ -219,16 +196,71 @@ TEST_CASE("benchmark vectors all_ranks_and_prefix_ranks() operations - Sigma alp
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
 
-            bench.run(name, [&]() {
+            BenchPerf::run(bench, name, [&]() {
                 auto v = str.all_ranks_and_prefix_ranks(rng.bounded(text.size()+1));
                 ankerl::nanobench::doNotOptimizeAway(v);
             });
         }, AllStrings{});
     }
 }
+TEST_CASE("benchmark simd kernels rank() and prefix_rank() operations - " SIGMA_STR " alphabet", "[string][" SIGMA_STR "][time][simd]") {
+    auto const& text = generateText<0, Sigma>();
+
+    using SimdStrings = Variant<
+        Instance<seqan::pfb::FlattenedBitvectors2L,       512, 65536>::Type,
+        Instance<seqan::pfb::PairedFlattenedBitvectors2L, 512, 65536>::Type,
+        Delimiter /*delimiter, is ignored*/
+    >;
+
+    auto detected = seqan::pfb::simd::level;
+    auto levels = std::vector<std::pair<seqan::pfb::simd::Level, std::string>>{{seqan::pfb::simd::Level::None, "portable"}};
+    if (detected >= seqan::pfb::simd::Level::AVX2)   levels.emplace_back(seqan::pfb::simd::Level::AVX2, "avx2");
+    if (detected >= seqan::pfb::simd::Level::AVX512) levels.emplace_back(seqan::pfb::simd::Level::AVX512, "avx512");
+    if constexpr (!seqan::pfb::simd::runtime_dispatch) {
+        // the kernel is selected by the compile flags, simd::level has no effect
+        levels = {{seqan::pfb::simd::compiled, "compile-time"}};
+    }
+
+    for (auto op : {"rank()", "prefix_rank()"}) {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title(std::string{op} + " simd kernels")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            if (skipTooLong<String>(text.size(), getName<String>())) return;
+            auto str = String{text};
+
+            for (auto const& [level, levelName] : levels) {
+                auto name = getName<String>() + " - " + levelName;
+                INFO(name);
+                seqan::pfb::simd::level = level;
+
+                auto rng = ankerl::nanobench::Rng{};
+                if (op == std::string{"rank()"}) {
+                    BenchPerf::run(bench, name, [&]() {
+                        auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
+                        ankerl::nanobench::doNotOptimizeAway(v);
+                    });
+                } else {
+                    BenchPerf::run(bench, name, [&]() {
+                        auto v = str.prefix_rank(rng.bounded(text.size()+1), rng.bounded(Sigma+1));
+                        ankerl::nanobench::doNotOptimizeAway(v);
+                    });
+                }
+            }
+        }, SimdStrings{});
+    }
+    seqan::pfb::simd::level = detected;
+}
+TEST_CASE("benchmark compile-time symbol rank() operations - " SIGMA_STR " alphabet", "[string][" SIGMA_STR "][time][static]") {
+    benchStaticRank<Sigma>(generateText<0, Sigma>());
+}
+
 TEST_CASE("benchmark vectors in size - alphabet " SIGMA_STR, "[string][" SIGMA_STR "][size]") {
     auto const& text = generateText<0, Sigma>();
     auto rng = ankerl::nanobench::Rng{};
@@ -237,30 +269,16 @@ TEST_CASE("benchmark vectors in size - alphabet " SIGMA_STR, "[string][" SIGMA_S
         BenchSize benchSize;
         benchSize.baseSize = std::ceil(std::log2(Sigma));
         benchSize.entries[0][2] = "bits/char";
-        benchSize.entries[0][4] = "alphabet " SIGMA_STR;
+        benchSize.entries[0].back() = "alphabet " SIGMA_STR;
 
         call_with_templates([&]<template <size_t> class _String>() {
             using String = _String<Sigma>;
             auto name = getName<String>();
             INFO(name);
+            if (skipTooLong<String>(text.size(), name)) return;
 
             auto str = String{text};
-            auto size = [&]() {
-                if constexpr (requires() { {str.space_usage() } -> std::same_as<size_t>; }) {
-                    return str.space_usage();
-                } else {
-                    auto ofs     = std::stringstream{};
-                    auto archive = cereal::BinaryOutputArchive{ofs};
-                    archive(str);
-                    return ofs.str().size();
-                }
-            }();
-            benchSize.addEntry({
-                .name = name,
-                .size = size,
-                .text_size = text.size(),
-                .bits_per_char = (size*8)/double(text.size())
-            });
+            benchSize.addEntry(name, str, text.size());
         }, AllStrings{});
     }
 }
@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "BenchPerf.h"
+#include "BenchSize.h"
+
+#include <catch2/catch_all.hpp>
+#include <cereal/archives/binary.hpp>
+#include <cstddef>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_externalLibsAdapter/all.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+
+namespace {
+    #define SIGMA 16
+    #define STRINGIFY(x) #x
+    #define TOSTRING(x) STRINGIFY(x)
+    constexpr static size_t Sigma = SIGMA;
+    #define SIGMA_STR TOSTRING(SIGMA)
+
+    // share of the four dominant symbols (A/C/G/T), remaining symbols are rare
+    constexpr static double Skew = 0.97;
+}
+
+using AllStrings = Variant<
+    seqan::pfb::MultiBitvectorFixed,
+    seqan::pfb::WaveletMatrixFixed,
+    seqan::pfb::HuffmanWaveletTreeFixed,
+    seqan::pfb::HuffmanWaveletTreePaired,
+#ifdef PFBITVECTORS_USE_SDSL
+    seqan::pfb::Sdsl_wt_bldc,
+    seqan::pfb::Sdsl_wt_epr,
+#endif
+//    Instance<seqan::pfb::FlattenedBitvectors2L,   64,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  128,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  256,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  512,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 1024,  4096>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 2048,  4096>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L,   64, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  128, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L,  256, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L,  512, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 1024, 65536>::Type,
+//    Instance<seqan::pfb::FlattenedBitvectors2L, 2048, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L,   64, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  128, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  256, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L,  512, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 1024, 65536>::Type,
+//    Instance<seqan::pfb::PairedFlattenedBitvectors2L, 2048, 65536>::Type,
+    Delimiter /*delimiter, is ignored*/
+>;
+
+
+// generates a DNA like text, most symbols are between 0-3, rarely any other symbol
+auto generateSkewedText(size_t length) -> std::vector<uint8_t> {
+    auto rng = ankerl::nanobench::Rng{};
+
+    auto text = std::vector<uint8_t>{};
+    for (size_t i{0}; i<length; ++i) {
+        if (rng.uniform01() < Skew) {
+            text.push_back(rng.bounded(4));
+        } else {
+            text.push_back(rng.bounded(Sigma-4) + 4);
+        }
+    }
+    return text;
+}
+
+auto generateSkewedText() -> std::vector<uint8_t> const& {
+    static auto text = []() -> std::vector<uint8_t> {
+        auto size = []() -> size_t {
+            auto ptr = std::getenv("STRINGSIZE");
+            if (ptr) {
+                return std::stoull(ptr);
+            }
+            #ifdef NDEBUG
+                return 1'000'000;
+            #else
+                return 1'000;
+            #endif
+        }();
+        return generateSkewedText(size);
+    }();
+    return text;
+}
+
+
+TEST_CASE("benchmark strings c'tor operation - skewed " SIGMA_STR " alphabet", "[string][skewed][time][ctor]") {
+    auto const& text = generateSkewedText();
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("c'tor()")
+             .relative(true)
+             .batch(text.size());
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            BenchPerf::run(bench, name, [&]() {
+                auto str = String{text};
+                ankerl::nanobench::doNotOptimizeAway(const_cast<String const&>(str));
+            });
+        }, AllStrings{});
+    }
+}
+
+TEST_CASE("benchmark vectors symbol() operations - skewed " SIGMA_STR " alphabet", "[string][skewed][time][symbol]") {
+    auto const& text = generateSkewedText();
+    auto rng = ankerl::nanobench::Rng{};
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("symbol()")
+             .relative(true)
+             .batch(text.size());
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto str = String{text};
+
+            BenchPerf::run(bench, name, [&]() {
+                auto v = str.symbol(rng.bounded(text.size()));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+        }, AllStrings{});
+    }
+}
+
+TEST_CASE("benchmark vectors rank() operations - skewed " SIGMA_STR " alphabet", "[string][skewed][time][rank]") {
+    auto const& text = generateSkewedText();
+    auto rng = ankerl::nanobench::Rng{};
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("rank()")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto str = String{text};
+
+            BenchPerf::run(bench, name, [&]() {
+                auto v = str.rank(rng.bounded(text.size()+1), text[rng.bounded(text.size())]);
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+        }, AllStrings{});
+    }
+}
+
+TEST_CASE("benchmark vectors prefix_rank() operations - skewed " SIGMA_STR " alphabet", "[string][skewed][time][prefix_rank]") {
+    auto const& text = generateSkewedText();
+    auto rng = ankerl::nanobench::Rng{};
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("prefix_rank()")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto str = String{text};
+
+            BenchPerf::run(bench, name, [&]() {
+                auto v = str.prefix_rank(rng.bounded(text.size()+1), text[rng.bounded(text.size())]);
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+        }, AllStrings{});
+    }
+}
+
+TEST_CASE("benchmark vectors all_ranks() operations - skewed " SIGMA_STR " alphabet", "[string][skewed][time][all_ranks]") {
+    auto const& text = generateSkewedText();
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("all_ranks()")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto rng = ankerl::nanobench::Rng{};
+
+            auto str = String{text};
+
+            BenchPerf::run(bench, name, [&]() {
+                auto v = str.all_ranks(rng.bounded(text.size()+1));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+        }, AllStrings{});
+    }
+}
+
+TEST_CASE("benchmark vectors all_ranks_and_prefix_ranks() operations - skewed " SIGMA_STR " alphabet", "[string][skewed][time][all_ranks_and_prefix_ranks]") {
+    auto const& text = generateSkewedText();
+    auto rng = ankerl::nanobench::Rng{};
+
+    SECTION("benchmarking") {
+        auto bench = ankerl::nanobench::Bench{};
+        bench.title("all_ranks_and_prefix_ranks()")
+             .relative(true);
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto str = String{text};
+
+            BenchPerf::run(bench, name, [&]() {
+                auto v = str.all_ranks_and_prefix_ranks(rng.bounded(text.size()+1));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+        }, AllStrings{});
+    }
+}
+TEST_CASE("benchmark vectors in size - skewed alphabet " SIGMA_STR, "[string][skewed][size]") {
+    auto const& text = generateSkewedText();
+    auto rng = ankerl::nanobench::Rng{};
+
+    SECTION("benchmarking") {
+        BenchSize benchSize;
+        benchSize.baseSize = std::ceil(std::log2(Sigma));
+        benchSize.entries[0][2] = "bits/char";
+        benchSize.entries[0].back() = "skewed alphabet " SIGMA_STR;
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+
+            auto str = String{text};
+            benchSize.addEntry(name, str, text.size());
+        }, AllStrings{});
+    }
+}
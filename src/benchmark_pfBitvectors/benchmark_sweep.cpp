@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "AllBitvectors.h"
+#include "AllStrings5.h"
+#include "BenchPerf.h"
+#include "BenchSize.h"
+#include "BenchUtils.h"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <fstream>
+#include <nanobench.h>
+#include <string>
+#include <vector>
+
+/* Working-set size sweep: benchmarks random rank queries of every type in AllBitvectors and AllStrings (alphabet 5)
+ * at geometrically spaced sizes, from L1 resident to multiple GB, to see where each layout crosses the
+ * L2/L3/DRAM/TLB boundaries.
+ *
+ * Environment variables:
+ *  - SWEEP_MIN:    smallest length in bits/characters (default 4096)
+ *  - SWEEP_MAX:    largest length (default 2^34)
+ *  - SWEEP_FACTOR: factor between two lengths (default 2)
+ *  - SWEEP_OUTPUT: prefix of the result files (default "sweep"), writes <prefix>_<kind>.csv and <prefix>_<kind>.json
+ *
+ * The result files are rewritten after each point, an aborted sweep keeps the finished points.
+ * Sizes beyond the l0 counter of a type (e.g. 2^32 and more for uint32_t l0) are skipped for that type.
+ */
+
+namespace {
+auto sweepSizes() -> std::vector<size_t> {
+    auto minSize = std::max<size_t>(1, envOr("SWEEP_MIN", 4096));
+    #ifdef NDEBUG
+        auto maxSize = envOr("SWEEP_MAX", size_t{1} << 34);
+    #else
+        auto maxSize = envOr("SWEEP_MAX", size_t{1} << 16);
+    #endif
+    auto factor = [&]() {
+        auto ptr = std::getenv("SWEEP_FACTOR");
+        return ptr ? std::max(std::stod(ptr), 1.01) : 2.;
+    }();
+
+    auto r = std::vector<size_t>{};
+    for (double s = minSize; s <= maxSize; s *= factor) {
+        if (r.empty() || r.back() != size_t(s)) {
+            r.push_back(s);
+        }
+    }
+    return r;
+}
+
+struct SweepResults {
+    struct Point {
+        std::string name;
+        size_t      size;
+        size_t      bytes;
+        double      bitsPerEntry;
+        double      nsPerQuery;
+    };
+
+    std::string kind;
+    std::vector<Point> points;
+
+    void add(Point p) {
+        fmt::print("{} {:>14} {:>10.3f} bits/entry {:>10.2f} ns/query  {}\n", kind, p.size, p.bitsPerEntry, p.nsPerQuery, p.name);
+        points.push_back(std::move(p));
+        write();
+    }
+
+    void write() const {
+        auto prefix = std::string{"sweep"};
+        if (auto ptr = std::getenv("SWEEP_OUTPUT")) {
+            prefix = ptr;
+        }
+        {
+            auto ofs = std::ofstream{prefix + "_" + kind + ".csv"};
+            ofs << "name,size,bytes,bits_per_entry,ns_per_query\n";
+            for (auto const& p : points) {
+                // names contain commas (template arguments), but never quotes
+                ofs << fmt::format("\"{}\",{},{},{:.6f},{:.3f}\n", p.name, p.size, p.bytes, p.bitsPerEntry, p.nsPerQuery);
+            }
+        }
+        {
+            auto ofs = std::ofstream{prefix + "_" + kind + ".json"};
+            ofs << "[\n";
+            for (size_t i{0}; i < points.size(); ++i) {
+                auto const& p = points[i];
+                ofs << fmt::format("  {{\"name\": \"{}\", \"size\": {}, \"bytes\": {}, \"bits_per_entry\": {:.6f}, \"ns_per_query\": {:.3f}}}{}\n",
+                                   p.name, p.size, p.bytes, p.bitsPerEntry, p.nsPerQuery, i+1 < points.size() ? "," : "");
+            }
+            ofs << "]\n";
+        }
+    }
+};
+
+// median run time of `query` in ns
+template <typename Query>
+auto measureNs(std::string const& name, Query query) -> double {
+    auto bench = ankerl::nanobench::Bench{};
+    bench.output(nullptr)
+         .epochs(11)
+         .minEpochTime(std::chrono::milliseconds{10})
+         .minEpochIterations(10'000);
+    BenchPerf::run(bench, name, query);
+    return bench.results().back().median(ankerl::nanobench::Result::Measure::elapsed) * 1e9;
+}
+}
+
+TEST_CASE("sweep bit vector rank over working-set sizes", "[bitvector][sweep]") {
+    auto results = SweepResults{.kind = "bitvector"};
+    for (auto size : sweepSizes()) {
+        auto text = [&]() {
+            auto rng  = ankerl::nanobench::Rng{};
+            auto text = std::vector<bool>(size);
+            for (size_t i{0}; i < text.size(); ++i) {
+                text[i] = rng.bounded(4) == 0;
+            }
+            return text;
+        }();
+
+        call_with_templates([&]<typename Vector>() {
+            auto name = getName<Vector>();
+            INFO(name);
+            if (skipTooLong<Vector>(size, name)) return;
+
+            auto vec   = Vector{text};
+            auto usage = BenchSize::measure(vec);
+            auto rng   = ankerl::nanobench::Rng{};
+            auto ns    = measureNs(name, [&]() {
+                auto v = vec.rank(rng.bounded(text.size()));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+            results.add({name, size, usage.total(), usage.total() * 8. / size, ns});
+        }, AllBitvectors{});
+    }
+}
+
+TEST_CASE("sweep string rank over working-set sizes - 5 alphabet", "[string][5][sweep]") {
+    constexpr size_t Sigma = 5;
+    auto results = SweepResults{.kind = "string5"};
+    for (auto size : sweepSizes()) {
+        auto text = [&]() {
+            auto rng  = ankerl::nanobench::Rng{};
+            auto text = std::vector<uint8_t>(size);
+            for (auto& c : text) {
+                c = rng.bounded(Sigma);
+            }
+            return text;
+        }();
+
+        call_with_templates([&]<template <size_t> class _String>() {
+            using String = _String<Sigma>;
+            auto name = getName<String>();
+            INFO(name);
+            if (skipTooLong<String>(size, name)) return;
+
+            auto str   = String{text};
+            auto usage = BenchSize::measure(str);
+            auto rng   = ankerl::nanobench::Rng{};
+            auto ns    = measureNs(name, [&]() {
+                auto v = str.rank(rng.bounded(text.size()+1), rng.bounded(Sigma));
+                ankerl::nanobench::doNotOptimizeAway(v);
+            });
+            results.add({name, size, usage.total(), usage.total() * 8. / size, ns});
+        }, AllStrings{});
+    }
+}
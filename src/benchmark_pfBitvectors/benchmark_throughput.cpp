@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+#include "BenchUtils.h"
+
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <nanobench.h>
+#include <pfBitvectors/pfBitvectors.h>
+#include <pfBitvectors_externalLibsAdapter/all.h>
+#include <pfBitvectors_test_utils/utils.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/* Throughput of random queries on a single shared instance, answered by 1 to THREADS threads
+ * (powers of two and THREADS itself). Thread i is pinned to the i-th cpu, cpus are taken node by node.
+ * Once the memory bandwidth saturates the total throughput stops growing and the
+ * latency of each single query rises, which can change the ranking of the structures.
+ *
+ * Environment variables:
+ *  - THREADS:  maximal number of threads (default: all cpus)
+ *  - QUERIES:  queries per thread
+ *  - TEXTSIZE: length of the bit vectors and strings
+ */
+
+namespace {
+auto textSize() -> size_t {
+    #ifdef NDEBUG
+        return envOr("TEXTSIZE", 500'000'000);
+    #else
+        return envOr("TEXTSIZE", 100'000);
+    #endif
+}
+
+auto queriesPerThread() -> size_t {
+    #ifdef NDEBUG
+        return envOr("QUERIES", 10'000'000);
+    #else
+        return envOr("QUERIES", 10'000);
+    #endif
+}
+
+// cpus in the order threads are pinned to them
+auto cpuOrder() -> std::vector<size_t> const& {
+    static auto order = []() {
+        auto r = std::vector<size_t>{};
+        for (auto const& cpus : seqan::pfb::NumaTopology::get().cpus) {
+            r.insert(r.end(), cpus.begin(), cpus.end());
+        }
+        return r;
+    }();
+    return order;
+}
+
+// 1, 2, 4, ..., THREADS
+auto threadCounts() -> std::vector<size_t> {
+    auto maxThreads = std::max<size_t>(1, envOr("THREADS", cpuOrder().size()));
+    auto r = std::vector<size_t>{};
+    for (size_t t{1}; t < maxThreads; t *= 2) {
+        r.push_back(t);
+    }
+    r.push_back(maxThreads);
+    return r;
+}
+
+// returns false if pinning is not supported
+auto pinCurrentThread(size_t cpu) -> bool {
+    #if defined(__linux__) && defined(CPU_SET)
+        if (cpu >= CPU_SETSIZE) return false;
+        auto set = cpu_set_t{};
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+    #else
+        (void)cpu;
+        return false;
+    #endif
+}
+
+struct Table {
+    std::vector<std::vector<std::string>> entries {
+        {"threads", "total Mq/s", "Mq/s per thread", "speedup", "ns/q mean", "ns/q slowest", "name"}
+    };
+    double singleThread{};
+
+    // seconds: run time of each thread
+    void addEntry(std::string name, size_t queries, std::vector<double> const& seconds) {
+        double total{}, slowest{}, latency{};
+        for (auto s : seconds) {
+            total   += queries / s;
+            latency += s / queries;
+            slowest  = std::max(slowest, s / queries);
+        }
+        latency /= seconds.size();
+        if (seconds.size() == 1) {
+            singleThread = total;
+        }
+        entries.push_back({
+            fmt::format("{}", seconds.size()),
+            fmt::format("{:.2f}", total / 1e6),
+            fmt::format("{:.2f}", total / 1e6 / seconds.size()),
+            fmt::format("{:.2f}", singleThread > 0. ? total / singleThread : 0.),
+            fmt::format("{:.1f}", latency * 1e9),
+            fmt::format("{:.1f}", slowest * 1e9),
+            std::move(name)
+        });
+    }
+
+    ~Table() {
+        printTable(entries);
+    }
+};
+
+/* Runs `threads` pinned threads, each calls `query(rng)` `queries` times with its own rng.
+ * All threads start at the same time. Returns the run time of each thread in seconds
+ */
+template <typename Query>
+auto runThreads(size_t threads, size_t queries, Query query) -> std::vector<double> {
+    auto const& cpus = cpuOrder();
+    auto seconds = std::vector<double>(threads);
+    auto ready   = std::atomic<size_t>{0};
+    auto workers = std::vector<std::thread>{};
+    for (size_t i{0}; i < threads; ++i) {
+        workers.emplace_back([&, i]() {
+            pinCurrentThread(cpus[i % cpus.size()]);
+            auto rng = ankerl::nanobench::Rng{i + 1};
+            ready.fetch_add(1);
+            while (ready.load() < threads) {}
+            auto start = std::chrono::steady_clock::now();
+            uint64_t checksum{};
+            for (size_t q{0}; q < queries; ++q) {
+                checksum += query(rng);
+            }
+            ankerl::nanobench::doNotOptimizeAway(checksum);
+            seconds[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return seconds;
+}
+
+template <typename Query>
+void runAllThreadCounts(Table& table, std::string const& name, Query query) {
+    auto queries = queriesPerThread();
+    for (auto threads : threadCounts()) {
+        table.addEntry(name, queries, runThreads(threads, queries, query));
+    }
+}
+}
+
+using ThroughputBitvectors = std::variant<
+#ifdef PFBITVECTORS_USE_PASTA
+    seqan::pfb::FlatRank,
+    seqan::pfb::WideRank,
+#endif
+#ifdef PFBITVECTORS_USE_SDSL
+    seqan::pfb::SDSL_V5,
+#endif
+#ifdef PFBITVECTORS_USE_SUX
+    seqan::pfb::Rank9,
+#endif
+    seqan::pfb::Bitvector<  64, 65536>,
+    seqan::pfb::Bitvector< 512, 65536>,
+    seqan::pfb::PairedBitvector< 512, 65536>,
+    std::monostate /*delimiter, is ignored*/
+>;
+
+using ThroughputStrings = Variant<
+    Instance<seqan::pfb::FlattenedBitvectors2L,             512, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L,       512, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,  512, 65536>::Type,
+    seqan::pfb::MultiBitvectorFixed,
+    Delimiter /*delimiter, is ignored*/
+>;
+
+TEST_CASE("benchmark multi-threaded rank throughput of bit vectors", "[bitvector][time][throughput]") {
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<bool>(textSize());
+        for (size_t i{0}; i < text.size(); ++i) {
+            text[i] = rng.bounded(4) == 0;
+        }
+        return text;
+    }();
+
+    auto table = Table{};
+    call_with_templates([&]<typename Vector>() {
+        auto vec = Vector{text};
+        runAllThreadCounts(table, getName<Vector>() + " - rank", [&](ankerl::nanobench::Rng& rng) -> uint64_t {
+            return vec.rank(rng.bounded(text.size() + 1));
+        });
+    }, ThroughputBitvectors{});
+}
+
+TEST_CASE("benchmark multi-threaded rank throughput of strings", "[string][time][throughput]") {
+    constexpr size_t Sigma = 5;
+    auto text = []() {
+        auto rng  = ankerl::nanobench::Rng{};
+        auto text = std::vector<uint8_t>(textSize());
+        for (auto& c : text) {
+            c = rng.bounded(Sigma);
+        }
+        return text;
+    }();
+
+    auto table = Table{};
+    call_with_templates([&]<template <size_t> class _String>() {
+        using String = _String<Sigma>;
+        auto str = String{text};
+        auto name = getName<String>();
+        runAllThreadCounts(table, name + " - rank", [&](ankerl::nanobench::Rng& rng) -> uint64_t {
+            return str.rank(rng.bounded(text.size() + 1), rng.bounded(Sigma));
+        });
+        runAllThreadCounts(table, name + " - prefix_rank", [&](ankerl::nanobench::Rng& rng) -> uint64_t {
+            return str.prefix_rank(rng.bounded(text.size() + 1), rng.bounded(Sigma));
+        });
+        runAllThreadCounts(table, name + " - all_ranks", [&](ankerl::nanobench::Rng& rng) -> uint64_t {
+            return sumOfRanks(str.all_ranks(rng.bounded(text.size() + 1)));
+        });
+    }, ThroughputStrings{});
+}
@@ -6,6 +6,7 @@
 #include <bitset>
 #include <cstddef>
 
+#include "WordBitset.h"
 #include "utils.h"
 
 namespace seqan::pfb {
@@ -45,9 +46,9 @@ void saveBV(std::bitset<N> const& b, Archive& ar) {
         ar(v);
     }
 }
-template <size_t N, bool Align=true>
-struct alignas(std::max(alignof(std::bitset<N>), Align?alignAsValue(N):size_t{1})) AlignedBitset {
-    std::bitset<N> bits;
+template <size_t N, bool Align=true, template <size_t> typename TBitset=std::bitset>
+struct alignas(std::max(alignof(TBitset<N>), Align?alignAsValue(N):size_t{1})) AlignedBitset {
+    TBitset<N> bits;
 
     decltype(auto) operator[](size_t i) {
         return bits[i];
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+/**
+ * Allocator support
+ *
+ * All bit vectors and strings take a trailing `TAllocator` template parameter
+ * (default `std::allocator<std::byte>`). It is rebound to the element types of
+ * l0, l1 and bits, so a single allocator object serves all containers of a structure.
+ * Stateful allocators (e.g. std::pmr::polymorphic_allocator) are passed as last
+ * constructor argument and are kept by deserialization, since it only resizes the containers.
+ * Copies follow the rules of std::vector, use the copy constructor taking an allocator
+ * to copy into a specific memory resource.
+ * Bitvector2L and the flattened strings also accept `MappedStorage` (see Storage.h) instead of an allocator, giving a read-only view.
+ */
+namespace seqan::pfb {
+
+template <typename T, typename TAllocator>
+using rebound_vector = std::vector<T, typename std::allocator_traits<TAllocator>::template rebind_alloc<T>>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    using allocator = std::pmr::polymorphic_allocator<std::byte>;
+}
+#endif
+
+}
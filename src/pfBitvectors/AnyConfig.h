@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "TypeTag.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+/**
+ * Configurations of AnyBitvectorOf and AnyStringOf
+ *
+ * Each configuration pairs a bit vector or string type with a name, e.g.
+ *   `Named<"Bitvector2L<512, 65536>", Bitvector2L<512, 65536>>`
+ * The name selects the configuration at runtime, a hash of the name and the layout of the type
+ * (see config_id) is written in front of the data when saving, so loading picks the configuration
+ * that was saved and rejects archives of a different type with the same name (e.g. another Sigma).
+ */
+namespace seqan::pfb {
+
+namespace detail {
+    // string literal as template argument
+    template <size_t N>
+    struct fixed_string {
+        std::array<char, N> data{};
+
+        constexpr fixed_string(char const (&str)[N]) {
+            std::copy_n(str, N, data.begin());
+        }
+
+        constexpr auto view() const -> std::string_view {
+            return {data.data(), N-1};
+        }
+    };
+
+    // hash of the configuration name and the type tag of its type (see bulk::type_tag), stored in archives
+    template <typename Config>
+    constexpr auto config_id() -> uint64_t {
+        return bulk::make_tag(Config::name, bulk::type_tag<typename Config::type>());
+    }
+
+    // ids of all configurations, in the order of Configs...
+    template <typename... Configs>
+    constexpr auto config_ids() -> std::array<uint64_t, sizeof...(Configs)> {
+        return {config_id<Configs>()...};
+    }
+
+    /** Index of the configuration named `name`/with id `id` in Configs...
+     *  throws if no configuration matches
+     */
+    template <typename... Configs>
+    auto config_index(std::string_view name) -> size_t {
+        constexpr auto names = std::array<std::string_view, sizeof...(Configs)>{Configs::name...};
+        for (size_t i{0}; i < names.size(); ++i) {
+            if (names[i] == name) return i;
+        }
+        auto msg = std::string{"unknown configuration \""} + std::string{name} + "\", available:";
+        for (auto n : names) {
+            msg += std::string{" \""} + std::string{n} + "\"";
+        }
+        throw std::runtime_error{msg};
+    }
+
+    template <typename... Configs>
+    auto config_index(uint64_t id) -> size_t {
+        constexpr auto ids = config_ids<Configs...>();
+        for (size_t i{0}; i < ids.size(); ++i) {
+            if (ids[i] == id) return i;
+        }
+        throw std::runtime_error{"unknown configuration id " + std::to_string(id) + ", the archive was written with a different set of configurations"};
+    }
+
+    // constructs alternative `index` of the variant from args (switch over all alternatives)
+    template <typename Variant, typename... Args>
+    void emplace_config(Variant& var, size_t index, Args&&... args) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (void)((index == I && (var.template emplace<I>(std::forward<Args>(args)...), true)) || ...);
+        }(std::make_index_sequence<std::variant_size_v<Variant>>{});
+    }
+}
+
+// a bit vector or string type `T` selectable by `Name`
+template <detail::fixed_string Name, typename T>
+struct Named {
+    static constexpr std::string_view name = Name.view();
+    using type = T;
+};
+
+}
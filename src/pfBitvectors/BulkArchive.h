@@ -0,0 +1,571 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "TypeTag.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Bulk binary archives
+ *
+ * Writes the members of all bit vectors and strings (as listed in their `serialize` functions)
+ * as contiguous binary arrays. Vectors of trivially copyable elements (l0, l1, bits, ...)
+ * are copied as a whole instead of going through saveBV/loadBV.
+ *
+ * Layout (all values in native byte order):
+ *   64 byte header: magic "PFBVBULK", version, endianness marker, file size, type tag (see TypeTag.h)
+ *   scalar:         sizeof(T) bytes, starting at an 8 byte boundary
+ *   vector<T>:      element count and sizeof(T) as uint64_t, data starts at a 64 byte boundary
+ *                   (vectors of non trivially copyable elements store the count followed by each element)
+ *
+ * Archives are not portable between machines of different byte order, loading them throws.
+ * The file based functions can split the arrays into chunks that are read/written by multiple threads.
+ * Since no pointers are stored, archives can also be queried in place, see BulkMemoryReader.
+ */
+namespace seqan::pfb {
+
+namespace bulk {
+    inline constexpr std::array<char, 8> magic{'P', 'F', 'B', 'V', 'B', 'U', 'L', 'K'};
+    inline constexpr uint32_t version = 2;
+    inline constexpr uint32_t endianMarker = 0x01020304;
+    // bulk arrays start at cache line boundaries
+    inline constexpr size_t arrayAlignment = 64;
+    inline constexpr size_t defaultChunkSize = size_t{16} << 20;
+
+    struct Header {
+        std::array<char, 8> magic{bulk::magic};
+        uint32_t version{bulk::version};
+        uint32_t endian{endianMarker};
+        uint64_t fileSize{};
+        uint64_t typeTag{};
+        std::array<uint64_t, 4> reserved{};
+    };
+    static_assert(sizeof(Header) == 64, "header must fill exactly one cache line");
+
+    // throws if the header was not written by BulkOutputArchive of this version and byte order
+    inline void validate(Header const& header, std::string const& who) {
+        if (header.magic != bulk::magic) {
+            throw std::runtime_error{who + ": not a pfBitvectors bulk archive"};
+        }
+        if (header.endian != bulk::endianMarker) {
+            throw std::runtime_error{who + ": archive was written on a machine with a different byte order"};
+        }
+        if (header.version != bulk::version) {
+            throw std::runtime_error{who + ": unsupported archive version " + std::to_string(header.version)};
+        }
+    }
+
+    // throws if the archive holds a different type than expected, see type_tag
+    inline void validate_type(uint64_t stored, uint64_t expected, std::string const& who) {
+        if (stored != expected) {
+            throw std::runtime_error{who + ": archive was written for a different type"};
+        }
+    }
+}
+
+namespace detail {
+    template <typename T>
+    struct is_std_vector : std::false_type {};
+    template <typename T, typename A>
+    struct is_std_vector<std::vector<T, A>> : std::true_type {};
+
+    template <typename T>
+    struct is_std_array : std::false_type {};
+    template <typename T, size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+
+    template <typename T>
+    struct is_std_span : std::false_type {};
+    template <typename T, size_t N>
+    struct is_std_span<std::span<T, N>> : std::true_type {};
+
+    // piece of a file, either pointing into the saved/loaded object or into the archive metadata
+    struct BulkSegment {
+        uint64_t offset{};
+        size_t   size{};
+        char*    ptr{};
+        size_t   metaOffset{};
+    };
+
+    // splits segments into pieces of at most chunkSize bytes
+    inline auto split_segments(std::vector<BulkSegment> const& segments, size_t chunkSize) -> std::vector<BulkSegment> {
+        chunkSize = std::max<size_t>(chunkSize, 1);
+        auto chunks = std::vector<BulkSegment>{};
+        for (auto const& s : segments) {
+            for (size_t i{0}; i < s.size; i += chunkSize) {
+                auto size = std::min(chunkSize, s.size - i);
+                chunks.push_back({s.offset + i, size, s.ptr ? s.ptr + i : nullptr, s.metaOffset + i});
+            }
+        }
+        return chunks;
+    }
+
+    // calls worker(chunk, stream) for each chunk, every thread opens its own stream via openStream()
+    template <typename OpenStream, typename Worker>
+    void for_each_chunk_parallel(std::vector<BulkSegment> const& chunks, size_t threads, OpenStream openStream, Worker worker) {
+        auto next  = std::atomic<size_t>{0};
+        auto error = std::exception_ptr{};
+        auto errorMutex = std::mutex{};
+        auto run = [&]() {
+            try {
+                auto stream = openStream();
+                for (size_t i = next++; i < chunks.size(); i = next++) {
+                    worker(chunks[i], stream);
+                }
+            } catch (...) {
+                auto lock = std::lock_guard{errorMutex};
+                if (!error) error = std::current_exception();
+            }
+        };
+        threads = std::max<size_t>(1, std::min(threads, chunks.size()));
+        if (threads == 1) {
+            run();
+        } else {
+            auto pool = std::vector<std::thread>{};
+            for (size_t i{0}; i < threads; ++i) {
+                pool.emplace_back(run);
+            }
+            for (auto& t : pool) {
+                t.join();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/** Collects the layout of an object, see saveBinary
+ */
+class BulkOutputArchive {
+    std::string meta;
+    std::vector<detail::BulkSegment> segments;
+    uint64_t offset{};
+    uint64_t typeTag{};
+
+    void appendMeta(void const* ptr, size_t size) {
+        if (segments.empty() || segments.back().ptr != nullptr) {
+            segments.push_back({offset, 0, nullptr, meta.size()});
+        }
+        meta.append(static_cast<char const*>(ptr), size);
+        segments.back().size += size;
+        offset += size;
+    }
+
+    void appendBulk(void const* ptr, size_t size) {
+        if (size == 0) return;
+        // segments are only read during writing
+        segments.push_back({offset, size, const_cast<char*>(static_cast<char const*>(ptr)), 0});
+        offset += size;
+    }
+
+    void pad(size_t alignment) {
+        static constexpr auto zeros = std::array<char, bulk::arrayAlignment>{};
+        if (auto r = offset % alignment; r != 0) {
+            appendMeta(zeros.data(), alignment - r);
+        }
+    }
+
+    template <typename T>
+    void process(T const& v) {
+        static_assert(!detail::is_std_span<T>::value, "views (MappedStorage) can not be saved, save the owning structure");
+        if constexpr (detail::is_std_vector<T>::value) {
+            using V = typename T::value_type;
+            static_assert(!std::is_same_v<V, bool>, "std::vector<bool> is not supported");
+            pad(8);
+            uint64_t count = v.size();
+            appendMeta(&count, sizeof(count));
+            if constexpr (std::is_trivially_copyable_v<V>) {
+                uint64_t elementSize = sizeof(V);
+                appendMeta(&elementSize, sizeof(elementSize));
+                pad(bulk::arrayAlignment);
+                appendBulk(v.data(), v.size() * sizeof(V));
+            } else {
+                for (auto const& e : v) {
+                    process(e);
+                }
+            }
+        } else if constexpr (detail::is_std_array<T>::value && !std::is_trivially_copyable_v<T>) {
+            for (auto const& e : v) {
+                process(e);
+            }
+        } else if constexpr (requires(T& t) { t.serialize(*this); }) {
+            const_cast<T&>(v).serialize(*this);
+        } else if constexpr (requires(T const& t) { t.save(*this); }) {
+            v.save(*this);
+        } else {
+            static_assert(std::is_trivially_copyable_v<T>, "type can not be written by BulkOutputArchive");
+            pad(8);
+            appendMeta(&v, sizeof(T));
+        }
+    }
+
+public:
+    // typeTag is written into the header, see bulk::type_tag
+    explicit BulkOutputArchive(uint64_t _typeTag = 0)
+        : typeTag{_typeTag}
+    {
+        auto header = bulk::Header{};
+        appendMeta(&header, sizeof(header));
+    }
+
+    template <typename... Ts>
+    void operator()(Ts const&... vs) {
+        (process(vs), ...);
+    }
+
+    // total size of the archive in bytes
+    auto size() const -> uint64_t {
+        return offset;
+    }
+
+    void write(std::ostream& os) {
+        finish();
+        for (auto const& s : segments) {
+            os.write(s.ptr ? s.ptr : meta.data() + s.metaOffset, s.size);
+        }
+        if (!os) {
+            throw std::runtime_error{"BulkOutputArchive: writing failed"};
+        }
+    }
+
+    // writes the archive to memory, dst must provide size() bytes
+    void write(std::byte* dst) {
+        finish();
+        for (auto const& s : segments) {
+            std::memcpy(dst + s.offset, s.ptr ? s.ptr : meta.data() + s.metaOffset, s.size);
+        }
+    }
+
+    void write(std::filesystem::path const& path, size_t threads = 1, size_t chunkSize = bulk::defaultChunkSize) {
+        finish();
+        {
+            auto ofs = std::ofstream{path, std::ios::binary | std::ios::trunc};
+            if (!ofs) {
+                throw std::runtime_error{"BulkOutputArchive: can not open " + path.string()};
+            }
+        }
+        std::filesystem::resize_file(path, offset);
+
+        auto chunks = detail::split_segments(segments, chunkSize);
+        detail::for_each_chunk_parallel(chunks, threads, [&]() {
+            return std::fstream{path, std::ios::binary | std::ios::in | std::ios::out};
+        }, [&](detail::BulkSegment const& c, std::fstream& fs) {
+            fs.seekp(c.offset);
+            fs.write(c.ptr ? c.ptr : meta.data() + c.metaOffset, c.size);
+            if (!fs) {
+                throw std::runtime_error{"BulkOutputArchive: writing " + path.string() + " failed"};
+            }
+        });
+    }
+
+private:
+    void finish() {
+        auto header = bulk::Header{};
+        header.fileSize = offset;
+        header.typeTag  = typeTag;
+        std::memcpy(meta.data(), &header, sizeof(header));
+    }
+};
+
+/** Reads an archive written by BulkOutputArchive, see loadBinary
+ *
+ * If `deferred` is set, bulk arrays are only allocated and their positions are recorded,
+ * they are filled later by `read(path, threads)`.
+ */
+class BulkInputArchive {
+    std::istream& is;
+    bool deferred;
+    uint64_t offset{};
+    uint64_t fileSize{};
+    uint64_t tag{};
+    std::vector<detail::BulkSegment> pending;
+
+    void readMeta(void* ptr, size_t size) {
+        if (offset + size > fileSize) {
+            throw std::runtime_error{"BulkInputArchive: archive is truncated"};
+        }
+        is.read(static_cast<char*>(ptr), size);
+        if (!is) {
+            throw std::runtime_error{"BulkInputArchive: reading failed"};
+        }
+        offset += size;
+    }
+
+    void readBulk(void* ptr, size_t size) {
+        if (size == 0) return;
+        if (offset + size > fileSize) {
+            throw std::runtime_error{"BulkInputArchive: archive is truncated"};
+        }
+        if (deferred) {
+            pending.push_back({offset, size, static_cast<char*>(ptr), 0});
+            is.seekg(size, std::ios::cur);
+        } else {
+            is.read(static_cast<char*>(ptr), size);
+        }
+        if (!is) {
+            throw std::runtime_error{"BulkInputArchive: reading failed"};
+        }
+        offset += size;
+    }
+
+    void skip(size_t alignment) {
+        auto buffer = std::array<char, bulk::arrayAlignment>{};
+        if (auto r = offset % alignment; r != 0) {
+            readMeta(buffer.data(), alignment - r);
+        }
+    }
+
+    template <typename T>
+    void process(T& v) {
+        static_assert(!detail::is_std_span<T>::value, "views (MappedStorage) can not be loaded, open them on the archive instead");
+        if constexpr (detail::is_std_vector<T>::value) {
+            using V = typename T::value_type;
+            static_assert(!std::is_same_v<V, bool>, "std::vector<bool> is not supported");
+            skip(8);
+            uint64_t count{};
+            readMeta(&count, sizeof(count));
+            if constexpr (std::is_trivially_copyable_v<V>) {
+                uint64_t elementSize{};
+                readMeta(&elementSize, sizeof(elementSize));
+                if (elementSize != sizeof(V)) {
+                    throw std::runtime_error{"BulkInputArchive: element size does not match, archive was written for a different type"};
+                }
+                if (count > (fileSize - offset) / sizeof(V)) {
+                    throw std::runtime_error{"BulkInputArchive: archive is truncated"};
+                }
+                skip(bulk::arrayAlignment);
+                v.resize(count);
+                readBulk(v.data(), count * sizeof(V));
+            } else {
+                // every element occupies at least one byte, a corrupt count must not cause a huge allocation
+                if (count > fileSize - offset) {
+                    throw std::runtime_error{"BulkInputArchive: archive is truncated"};
+                }
+                v.clear();
+                v.resize(count);
+                for (auto& e : v) {
+                    process(e);
+                }
+            }
+        } else if constexpr (detail::is_std_array<T>::value && !std::is_trivially_copyable_v<T>) {
+            for (auto& e : v) {
+                process(e);
+            }
+        } else if constexpr (requires(T& t) { t.serialize(*this); }) {
+            v.serialize(*this);
+        } else if constexpr (requires(T& t) { t.load(*this); }) {
+            v.load(*this);
+        } else {
+            static_assert(std::is_trivially_copyable_v<T>, "type can not be read by BulkInputArchive");
+            skip(8);
+            readMeta(&v, sizeof(T));
+        }
+    }
+
+public:
+    BulkInputArchive(std::istream& _is, bool _deferred = false)
+        : is{_is}
+        , deferred{_deferred}
+    {
+        auto header = bulk::Header{};
+        fileSize = sizeof(header);
+        readMeta(&header, sizeof(header));
+        bulk::validate(header, "BulkInputArchive");
+        fileSize = header.fileSize;
+        tag      = header.typeTag;
+    }
+
+    // tag of the type that was saved, see bulk::type_tag
+    auto typeTag() const -> uint64_t {
+        return tag;
+    }
+
+    template <typename... Ts>
+    void operator()(Ts&... vs) {
+        (process(vs), ...);
+    }
+
+    // fills all deferred bulk arrays
+    void read(std::filesystem::path const& path, size_t threads = 1, size_t chunkSize = bulk::defaultChunkSize) {
+        auto chunks = detail::split_segments(pending, chunkSize);
+        pending.clear();
+        detail::for_each_chunk_parallel(chunks, threads, [&]() {
+            return std::ifstream{path, std::ios::binary};
+        }, [&](detail::BulkSegment const& c, std::ifstream& ifs) {
+            ifs.seekg(c.offset);
+            ifs.read(c.ptr, c.size);
+            if (!ifs) {
+                throw std::runtime_error{"BulkInputArchive: reading " + path.string() + " failed"};
+            }
+        });
+    }
+};
+
+/** Walks through an archive written by BulkOutputArchive that lies in memory (e.g. a mapped file)
+ *
+ * Members must be requested in the same order as they were written. Bulk arrays are not copied,
+ * `array<T>()` returns a span pointing into the memory region. The region must start at a
+ * 64 byte boundary, so the arrays keep their alignment.
+ */
+class BulkMemoryReader {
+    std::byte const* base{};
+    uint64_t offset{};
+    uint64_t fileSize{};
+    uint64_t tag{};
+
+    void require(size_t size) const {
+        if (size > fileSize - offset) {
+            throw std::runtime_error{"BulkMemoryReader: archive is truncated"};
+        }
+    }
+    void skip(size_t alignment) {
+        if (auto r = offset % alignment; r != 0) {
+            require(alignment - r);
+            offset += alignment - r;
+        }
+    }
+    template <typename T>
+    auto readMeta() -> T {
+        require(sizeof(T));
+        auto v = T{};
+        std::memcpy(&v, base + offset, sizeof(T));
+        offset += sizeof(T);
+        return v;
+    }
+
+public:
+    BulkMemoryReader(std::byte const* _base, size_t _size)
+        : base{_base}
+        , fileSize{_size}
+    {
+        if (reinterpret_cast<uintptr_t>(base) % bulk::arrayAlignment != 0) {
+            throw std::runtime_error{"BulkMemoryReader: archive must be aligned to 64 bytes"};
+        }
+        auto header = readMeta<bulk::Header>();
+        bulk::validate(header, "BulkMemoryReader");
+        if (header.fileSize > _size) {
+            throw std::runtime_error{"BulkMemoryReader: archive is truncated"};
+        }
+        fileSize = header.fileSize;
+        tag      = header.typeTag;
+    }
+
+    // tag of the type that was saved, see bulk::type_tag
+    auto typeTag() const -> uint64_t {
+        return tag;
+    }
+
+    // next vector<T> of the archive, T must be trivially copyable
+    template <typename T>
+    auto array() -> std::span<T const> {
+        static_assert(std::is_trivially_copyable_v<T>, "only arrays of trivially copyable types are stored in bulk");
+        static_assert(alignof(T) <= bulk::arrayAlignment);
+        skip(8);
+        auto count       = readMeta<uint64_t>();
+        auto elementSize = readMeta<uint64_t>();
+        if (elementSize != sizeof(T)) {
+            throw std::runtime_error{"BulkMemoryReader: element size does not match, archive was written for a different type"};
+        }
+        skip(bulk::arrayAlignment);
+        if (count > (fileSize - offset) / sizeof(T)) {
+            throw std::runtime_error{"BulkMemoryReader: archive is truncated"};
+        }
+        auto ptr = reinterpret_cast<T const*>(base + offset);
+        offset += count * sizeof(T);
+        return {ptr, count};
+    }
+
+    // next scalar of the archive
+    template <typename T>
+    auto scalar() -> T {
+        static_assert(std::is_trivially_copyable_v<T>);
+        skip(8);
+        return readMeta<T>();
+    }
+
+    // total size of the archive in bytes
+    auto size() const -> uint64_t {
+        return fileSize;
+    }
+
+    // points the views of a mapped structure at the next sections, called by its serialize function
+    template <typename... Ts>
+    void operator()(Ts&... vs) {
+        (process(vs), ...);
+    }
+
+private:
+    template <typename T>
+    void process(std::span<T const>& v) {
+        v = array<T>();
+    }
+    template <typename T>
+    void process(T& v) {
+        v = scalar<T>();
+    }
+};
+
+/** Saves a bit vector or string as bulk binary archive
+ */
+template <typename T>
+void saveBinary(T const& v, std::ostream& os) {
+    auto archive = BulkOutputArchive{bulk::type_tag<T>()};
+    archive(v);
+    archive.write(os);
+}
+
+/** Saves a bit vector or string as bulk binary archive,
+ *  the arrays are split into chunks of chunkSize bytes and written by `threads` threads
+ */
+template <typename T>
+void saveBinary(T const& v, std::filesystem::path const& path, size_t threads = 1, size_t chunkSize = bulk::defaultChunkSize) {
+    auto archive = BulkOutputArchive{bulk::type_tag<T>()};
+    archive(v);
+    archive.write(path, threads, chunkSize);
+}
+
+/** Loads a bit vector or string from a bulk binary archive
+ */
+template <typename T>
+void loadBinary(T& v, std::istream& is) {
+    auto archive = BulkInputArchive{is};
+    bulk::validate_type(archive.typeTag(), bulk::type_tag<T>(), "loadBinary");
+    archive(v);
+}
+
+/** Loads a bit vector or string from a bulk binary archive,
+ *  the arrays are split into chunks of chunkSize bytes and read by `threads` threads
+ */
+template <typename T>
+void loadBinary(T& v, std::filesystem::path const& path, size_t threads = 1, size_t chunkSize = bulk::defaultChunkSize) {
+    auto ifs = std::ifstream{path, std::ios::binary};
+    if (!ifs) {
+        throw std::runtime_error{"loadBinary: can not open " + path.string()};
+    }
+    auto archive = BulkInputArchive{ifs, /*.deferred=*/true};
+    bulk::validate_type(archive.typeTag(), bulk::type_tag<T>(), "loadBinary");
+    archive(v);
+    archive.read(path, threads, chunkSize);
+}
+
+}
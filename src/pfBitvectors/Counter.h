@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/**
+ * Counter types of the l0 and l1 levels
+ *
+ * Bitvector2L and the flattened strings take the counter types as template parameters TL1 and TL0.
+ * l1 counters are relative to their l0 block and never exceed l0_bits_ct - l1_bits_ct, so by
+ * default the smallest type holding this value is chosen at compile time (l1_counter_t).
+ * l0 counters are absolute and must hold the total length, they default to uint64_t.
+ * With TL0 = uint32_t the constructors throw std::length_error for inputs with 2^32 or more entries,
+ * dispatch_l0_counter picks uint32_t or uint64_t at runtime.
+ */
+namespace seqan::pfb {
+
+// smallest unsigned integer type that can hold the value N
+template <uint64_t N>
+using uint_fit_t = std::conditional_t<N <= std::numeric_limits<uint8_t>::max(),  uint8_t,
+                   std::conditional_t<N <= std::numeric_limits<uint16_t>::max(), uint16_t,
+                   std::conditional_t<N <= std::numeric_limits<uint32_t>::max(), uint32_t,
+                                                                                 uint64_t>>>;
+
+// smallest l1 counter type for the given block sizes
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using l1_counter_t = uint_fit_t<l0_bits_ct - l1_bits_ct>;
+
+// throws if a structure with totalLength entries can not be counted with TL0
+template <typename TL0>
+void check_l0_counter(uint64_t totalLength, char const* name) {
+    if (totalLength > std::numeric_limits<TL0>::max()) {
+        throw std::length_error{std::string{name} + ": " + std::to_string(totalLength)
+                                + " entries exceed the l0 counter type, use a wider TL0"};
+    }
+}
+
+/** Chooses the l0 counter type for a structure with totalLength entries
+ *  calls `cb.template operator()<uint32_t>()` if possible, otherwise `cb.template operator()<uint64_t>()`
+ */
+template <typename CB>
+auto dispatch_l0_counter(uint64_t totalLength, CB&& cb) {
+    if (totalLength <= std::numeric_limits<uint32_t>::max()) {
+        return cb.template operator()<uint32_t>();
+    }
+    return cb.template operator()<uint64_t>();
+}
+
+}
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// PFBITVECTORS_MMAP=0 forces reading files into memory instead of mapping them
+#ifndef PFBITVECTORS_MMAP
+    #if __has_include(<sys/mman.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+        #define PFBITVECTORS_MMAP 1
+    #else
+        #define PFBITVECTORS_MMAP 0
+    #endif
+#endif
+#if PFBITVECTORS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace seqan::pfb {
+
+/** Access pattern hints for (parts of) a mapped file, forwarded to madvise
+ */
+enum class Advice {
+    Normal,
+    Random,     // rank queries, no read-ahead
+    Sequential, // scanning
+    WillNeed,   // page in now
+    DontNeed,   // pages can be dropped
+};
+
+/**
+ * Read-only mapping of a whole file
+ *
+ * On POSIX systems the file is mapped with mmap, pages are only read from disk when they are accessed.
+ * On other systems the file is read into a page aligned buffer, hints are ignored.
+ * The mapping always starts at a page boundary.
+ */
+class MappedFile {
+    std::byte const* ptr{};
+    size_t length{};
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(std::filesystem::path const& path) {
+        #if PFBITVECTORS_MMAP
+            auto fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error{"MappedFile: can not open " + path.string()};
+            }
+            // the mapping stays valid after closing the file descriptor
+            try {
+                map(fd, path.string());
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+        #else
+            auto ifs = std::ifstream{path, std::ios::binary};
+            if (!ifs) {
+                throw std::runtime_error{"MappedFile: can not open " + path.string()};
+            }
+            length = std::filesystem::file_size(path);
+            if (length > 0) {
+                auto p = static_cast<std::byte*>(::operator new(length, std::align_val_t{pageSize()}));
+                ptr = p;
+                if (!ifs.read(reinterpret_cast<char*>(p), length)) {
+                    release();
+                    throw std::runtime_error{"MappedFile: can not read " + path.string()};
+                }
+            }
+        #endif
+    }
+
+    #if PFBITVECTORS_MMAP
+    /** Maps an already opened file descriptor (e.g. a shared memory object), read-only
+     *  the descriptor is not closed
+     */
+    MappedFile(int fd, std::string const& name) {
+        map(fd, name);
+    }
+    #endif
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile(MappedFile&& o) noexcept
+        : ptr{std::exchange(o.ptr, nullptr)}
+        , length{std::exchange(o.length, 0)}
+    {}
+    auto operator=(MappedFile const&) -> MappedFile& = delete;
+    auto operator=(MappedFile&& o) noexcept -> MappedFile& {
+        if (this != &o) {
+            release();
+            ptr    = std::exchange(o.ptr, nullptr);
+            length = std::exchange(o.length, 0);
+        }
+        return *this;
+    }
+    ~MappedFile() {
+        release();
+    }
+
+    auto data() const -> std::byte const* {
+        return ptr;
+    }
+
+    auto size() const -> size_t {
+        return length;
+    }
+
+    static auto pageSize() -> size_t {
+        #if PFBITVECTORS_MMAP
+            static auto const size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            return size;
+        #else
+            return 4096;
+        #endif
+    }
+
+    /** Applies an access hint to the bytes [offset, offset+size)
+     *  the range is extended to page boundaries, failures are ignored (it is only a hint)
+     */
+    void advise(size_t offset, size_t size, Advice advice) const {
+        #if PFBITVECTORS_MMAP
+            if (ptr == nullptr || size == 0 || offset >= length) return;
+            auto page  = pageSize();
+            auto begin = offset / page * page;
+            auto end   = std::min(offset + size, length);
+            auto flag = [&]() {
+                switch (advice) {
+                    case Advice::Random:     return MADV_RANDOM;
+                    case Advice::Sequential: return MADV_SEQUENTIAL;
+                    case Advice::WillNeed:   return MADV_WILLNEED;
+                    case Advice::DontNeed:   return MADV_DONTNEED;
+                    case Advice::Normal:     break;
+                }
+                return MADV_NORMAL;
+            }();
+            ::madvise(const_cast<std::byte*>(ptr) + begin, end - begin, flag);
+        #else
+            (void)offset;
+            (void)size;
+            (void)advice;
+        #endif
+    }
+
+    // same as advise, but the range is given as span pointing into the mapping
+    template <typename T>
+    void advise(std::span<T const> range, Advice advice) const {
+        auto p = reinterpret_cast<std::byte const*>(range.data());
+        if (p < ptr || p >= ptr + length) return;
+        advise(static_cast<size_t>(p - ptr), range.size_bytes(), advice);
+    }
+
+private:
+    #if PFBITVECTORS_MMAP
+    void map(int fd, std::string const& name) {
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            throw std::runtime_error{"MappedFile: can not stat " + name};
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            auto p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED) {
+                length = 0;
+                throw std::runtime_error{"MappedFile: can not map " + name};
+            }
+            ptr = static_cast<std::byte const*>(p);
+        }
+    }
+    #endif
+
+    void release() {
+        if (ptr == nullptr) return;
+        #if PFBITVECTORS_MMAP
+            ::munmap(const_cast<std::byte*>(ptr), length);
+        #else
+            ::operator delete(const_cast<std::byte*>(ptr), std::align_val_t{pageSize()});
+        #endif
+        ptr = nullptr;
+        length = 0;
+    }
+};
+
+}
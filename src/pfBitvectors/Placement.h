@@ -0,0 +1,350 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "Allocator.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+ * Memory placement for large read-only indices
+ *
+ * At billions of bits random rank queries are dominated by TLB misses and, on multi-socket hosts,
+ * by accesses to the memory of another NUMA node. Both are opt-in via the allocator parameter
+ * (see Allocator.h):
+ *
+ *   auto vec = pmr::Bitvector2L<512, 65536>{text, pmr::allocator{hugePageResource()}};
+ *
+ * places bits, l1 and l0 2MB aligned and requests transparent huge pages (madvise(MADV_HUGEPAGE)).
+ *
+ *   auto replicas = NumaReplicated<pmr::Bitvector2L<512, 65536>>{vec};
+ *   replicas.local().rank(idx);
+ *
+ * keeps one copy per NUMA node, each bound to the memory of its node, and answers queries
+ * with the copy of the node the calling thread currently runs on.
+ * On systems without NUMA support there is a single node.
+ * Binding is best effort (it fails e.g. without permission or in restricted containers),
+ * `bound()` of HugePageResource and NumaReplicated reports whether it succeeded.
+ */
+namespace seqan::pfb {
+
+/** NUMA nodes of this machine and the cpus belonging to them
+ *
+ * Read from /sys/devices/system/node on Linux, otherwise a single node with all cpus.
+ */
+struct NumaTopology {
+    std::vector<size_t> ids;               // node id used by the kernel (might have gaps)
+    std::vector<std::vector<size_t>> cpus; // cpus of each node
+    std::vector<size_t> nodeOfCpu;         // node (index into ids) of each cpu
+
+    static auto get() -> NumaTopology const& {
+        static auto const topology = NumaTopology{load()};
+        return topology;
+    }
+
+    auto nodes() const -> size_t {
+        return cpus.size();
+    }
+
+    // node of the cpu the calling thread currently runs on
+    auto currentNode() const -> size_t {
+        #if defined(__linux__)
+            auto cpu = ::sched_getcpu();
+            if (cpu >= 0 && static_cast<size_t>(cpu) < nodeOfCpu.size()) {
+                return nodeOfCpu[cpu];
+            }
+        #endif
+        return 0;
+    }
+
+    /** Restricts the calling thread to the cpus of the given node
+     *  returns false if this is not supported
+     */
+    auto bindCurrentThread(size_t node) const -> bool {
+        #if defined(__linux__) && defined(CPU_SET)
+            auto set = cpu_set_t{};
+            CPU_ZERO(&set);
+            for (auto cpu : cpus.at(node)) {
+                if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            }
+            return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+        #else
+            (void)node;
+            return false;
+        #endif
+    }
+
+private:
+    // parses lists like "0-3,8-11"
+    static auto parseList(std::string const& line) -> std::vector<size_t> {
+        auto r  = std::vector<size_t>{};
+        auto ss = std::stringstream{line};
+        auto entry = std::string{};
+        while (std::getline(ss, entry, ',')) {
+            if (entry.empty() || entry == "\n") continue;
+            auto dash  = entry.find('-');
+            auto first = std::stoull(entry.substr(0, dash));
+            auto last  = dash == std::string::npos ? first : std::stoull(entry.substr(dash + 1));
+            for (auto i = first; i <= last; ++i) {
+                r.push_back(i);
+            }
+        }
+        return r;
+    }
+
+    static auto load() -> NumaTopology {
+        auto t = NumaTopology{};
+        #if defined(__linux__)
+            auto readLine = [](std::string const& path) {
+                auto ifs  = std::ifstream{path};
+                auto line = std::string{};
+                std::getline(ifs, line);
+                return line;
+            };
+            try {
+                for (auto node : parseList(readLine("/sys/devices/system/node/online"))) {
+                    auto cpus = parseList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+                    if (cpus.empty()) continue; // memory only node
+                    t.ids.push_back(node);
+                    t.cpus.push_back(cpus);
+                }
+            } catch (...) {
+                t.ids.clear();
+                t.cpus.clear();
+            }
+        #endif
+        if (t.cpus.empty()) {
+            t.ids  = {0};
+            t.cpus.resize(1);
+            for (size_t i{0}; i < std::max<size_t>(1, std::thread::hardware_concurrency()); ++i) {
+                t.cpus[0].push_back(i);
+            }
+        }
+        for (size_t node{0}; node < t.cpus.size(); ++node) {
+            for (auto cpu : t.cpus[node]) {
+                if (t.nodeOfCpu.size() <= cpu) t.nodeOfCpu.resize(cpu + 1);
+                t.nodeOfCpu[cpu] = node;
+            }
+        }
+        return t;
+    }
+};
+
+#if defined(__cpp_lib_memory_resource)
+
+/** Memory resource that places each allocation 2MB aligned and requests transparent huge pages
+ *
+ * Allocations smaller than half a huge page (e.g. l0 of small structures) use regular pages,
+ * so they do not occupy a whole huge page each.
+ * If a node id is given, the memory is bound to this NUMA node (Linux only), see bound().
+ * Without mmap the memory is only aligned.
+ */
+class HugePageResource : public std::pmr::memory_resource {
+    int node{-1};
+    std::atomic<bool> unbound{false}; // an allocation could not be bound to node
+
+public:
+    static constexpr size_t hugePageSize = size_t{1} << 21;
+
+    HugePageResource() = default;
+    explicit HugePageResource(size_t nodeId)
+        : node{static_cast<int>(nodeId)}
+    {}
+
+    // true if a node was given and all allocations so far are bound to it
+    auto bound() const -> bool {
+        return node >= 0 && !unbound.load(std::memory_order_relaxed);
+    }
+
+private:
+    static auto mappedSize(size_t bytes) -> size_t {
+        auto page = bytes < hugePageSize / 2 ? MappedFile::pageSize() : hugePageSize;
+        return (std::max<size_t>(bytes, 1) + page - 1) / page * page;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        auto size = mappedSize(bytes);
+        #if PFBITVECTORS_MMAP
+            if (alignment > hugePageSize) throw std::bad_alloc{};
+            // over-allocate and cut off the unaligned head and tail
+            auto extra = size < hugePageSize ? 0 : hugePageSize;
+            auto raw   = ::mmap(nullptr, size + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc{};
+            auto addr = reinterpret_cast<uintptr_t>(raw);
+            auto aligned = extra ? (addr + hugePageSize - 1) / hugePageSize * hugePageSize : addr;
+            if (aligned > addr) {
+                ::munmap(raw, aligned - addr);
+            }
+            if (addr + size + extra > aligned + size) {
+                ::munmap(reinterpret_cast<void*>(aligned + size), addr + size + extra - aligned - size);
+            }
+            auto p = reinterpret_cast<void*>(aligned);
+            #if defined(MADV_HUGEPAGE)
+                if (extra) ::madvise(p, size, MADV_HUGEPAGE);
+            #endif
+            if (node >= 0) {
+                #if defined(__linux__) && defined(SYS_mbind)
+                    // MPOL_BIND, must happen before the pages are touched
+                    constexpr int mpolBind = 2;
+                    auto mask = std::vector<unsigned long>(node / (8 * sizeof(unsigned long)) + 1);
+                    mask[node / (8 * sizeof(unsigned long))] |= 1ul << (node % (8 * sizeof(unsigned long)));
+                    if (::syscall(SYS_mbind, p, size, mpolBind, mask.data(), mask.size() * 8 * sizeof(unsigned long) + 1, 0) != 0) {
+                        unbound.store(true, std::memory_order_relaxed);
+                    }
+                #else
+                    unbound.store(true, std::memory_order_relaxed);
+                #endif
+            }
+            return p;
+        #else
+            if (node >= 0) unbound.store(true, std::memory_order_relaxed);
+            return ::operator new(size, std::align_val_t{std::max(alignment, hugePageSize)});
+        #endif
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        #if PFBITVECTORS_MMAP
+            (void)alignment;
+            ::munmap(p, mappedSize(bytes));
+        #else
+            ::operator delete(p, std::align_val_t{std::max(alignment, hugePageSize)});
+        #endif
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// process wide huge page resource, not bound to a NUMA node
+inline auto hugePageResource() -> HugePageResource* {
+    static auto resource = HugePageResource{};
+    return &resource;
+}
+
+/** One copy of a read-only structure per NUMA node
+ *
+ * T must be constructible from (T const&, pmr::allocator), e.g. pmr::Bitvector2L or pmr::FlattenedBitvectors2L.
+ * Each copy is made by a thread running on its node and placed in huge pages bound to that node,
+ * if either fails the copy is still usable but might live on another node, see bound().
+ * Use local() outside of hot loops, rank/symbol/... look up the node on every call.
+ */
+template <typename T>
+class NumaReplicated {
+    // declared before replicas, so the replicas are destroyed first
+    std::vector<std::unique_ptr<HugePageResource>> resources;
+    std::vector<std::unique_ptr<T>> replicas;
+    std::vector<uint8_t> pinned; // the copy was made by a thread restricted to its node
+    NumaTopology topology;       // nodes of the replicas, local() looks up the node in it
+
+public:
+    explicit NumaReplicated(T const& v, NumaTopology const& _topology = NumaTopology::get())
+        : topology{_topology}
+    {
+        auto nodes = topology.nodes();
+        resources.resize(nodes);
+        replicas.resize(nodes);
+        pinned.resize(nodes);
+        auto threads = std::vector<std::thread>{};
+        auto errors  = std::vector<std::exception_ptr>(nodes);
+        for (size_t node{0}; node < nodes; ++node) {
+            resources[node] = std::make_unique<HugePageResource>(topology.ids[node]);
+            threads.emplace_back([&, node]() {
+                try {
+                    pinned[node] = topology.bindCurrentThread(node); // first touch happens on this node
+                    replicas[node] = std::make_unique<T>(v, pmr::allocator{resources[node].get()});
+                } catch (...) {
+                    errors[node] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (auto const& e : errors) {
+            if (e) std::rethrow_exception(e);
+        }
+    }
+    NumaReplicated(NumaReplicated const&) = delete;
+    NumaReplicated(NumaReplicated&&) noexcept = default;
+    auto operator=(NumaReplicated const&) -> NumaReplicated& = delete;
+    auto operator=(NumaReplicated&&) -> NumaReplicated& = delete;
+
+    auto nodes() const -> size_t {
+        return replicas.size();
+    }
+
+    // true if the copy of the node was made on the node and its memory is bound to it
+    auto bound(size_t node) const -> bool {
+        return pinned.at(node) && resources.at(node)->bound();
+    }
+
+    // true if all copies are bound to their nodes
+    auto bound() const -> bool {
+        for (size_t node{0}; node < nodes(); ++node) {
+            if (!bound(node)) return false;
+        }
+        return true;
+    }
+
+    auto replica(size_t node) const -> T const& {
+        return *replicas.at(node);
+    }
+
+    // copy on the node of the calling thread
+    auto local() const -> T const& {
+        auto node = topology.currentNode();
+        return *replicas[node < replicas.size() ? node : 0];
+    }
+
+    size_t size() const {
+        return replicas[0]->size();
+    }
+
+    template <typename... Args>
+    auto symbol(Args... args) const {
+        return local().symbol(args...);
+    }
+
+    template <typename... Args>
+    auto rank(Args... args) const {
+        return local().rank(args...);
+    }
+
+    template <typename... Args>
+    auto prefix_rank(Args... args) const {
+        return local().prefix_rank(args...);
+    }
+
+    template <typename... Args>
+    auto all_ranks(Args... args) const {
+        return local().all_ranks(args...);
+    }
+
+    template <typename... Args>
+    auto all_ranks_and_prefix_ranks(Args... args) const {
+        return local().all_ranks_and_prefix_ranks(args...);
+    }
+};
+
+#endif
+
+}
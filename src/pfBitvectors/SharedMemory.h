@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "BulkArchive.h"
+#include "MappedFile.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if PFBITVECTORS_MMAP && !defined(__EMSCRIPTEN__)
+#define PFBITVECTORS_SHM 1
+#else
+#define PFBITVECTORS_SHM 0
+#endif
+
+/**
+ * Sharing bit vectors and strings between processes
+ *
+ * publishShared writes a bulk archive (see saveBinary) into a named POSIX shared memory object,
+ * attachShared maps it read-only into another process. The archive contains no pointers,
+ * so it can be mapped at any address. Views (MappedBitvector2L, MappedFlattenedBitvectors2L, ...)
+ * are constructed from the returned mapping, all processes share the same physical pages.
+ *
+ * Only available on POSIX systems (PFBITVECTORS_SHM).
+ */
+namespace seqan::pfb {
+
+#if PFBITVECTORS_SHM
+
+/** Owner of a named shared memory object, removes the name on destruction
+ *
+ * Processes that already attached keep their mapping after the name was removed.
+ */
+class SharedMemory {
+    std::string _name;
+
+public:
+    SharedMemory() = default;
+    explicit SharedMemory(std::string name)
+        : _name{std::move(name)}
+    {}
+    SharedMemory(SharedMemory const&) = delete;
+    SharedMemory(SharedMemory&& o) noexcept
+        : _name{std::exchange(o._name, {})}
+    {}
+    auto operator=(SharedMemory const&) -> SharedMemory& = delete;
+    auto operator=(SharedMemory&& o) noexcept -> SharedMemory& {
+        if (this != &o) {
+            unlink();
+            _name = std::exchange(o._name, {});
+        }
+        return *this;
+    }
+    ~SharedMemory() {
+        unlink();
+    }
+
+    auto name() const -> std::string const& {
+        return _name;
+    }
+
+    // keeps the shared memory object alive after destruction
+    auto release() -> std::string {
+        return std::exchange(_name, {});
+    }
+
+private:
+    void unlink() {
+        if (!_name.empty()) {
+            ::shm_unlink(_name.c_str());
+            _name.clear();
+        }
+    }
+};
+
+/** Publishes v as shared memory object with the given name (e.g. "/my_index")
+ *
+ * Throws if the name already exists.
+ */
+template <typename T>
+auto publishShared(T const& v, std::string const& name) -> SharedMemory {
+    auto archive = BulkOutputArchive{bulk::type_tag<T>()};
+    archive(v);
+    auto size = archive.size();
+
+    auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error{"publishShared: can not create shared memory object " + name};
+    }
+    auto owner = SharedMemory{name};
+    auto fail = [&](char const* what) {
+        ::close(fd);
+        throw std::runtime_error{std::string{"publishShared: "} + what + " " + name};
+    };
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        fail("can not resize shared memory object");
+    }
+    auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        fail("can not map shared memory object");
+    }
+    archive.write(static_cast<std::byte*>(p));
+    ::munmap(p, size);
+    ::close(fd);
+    return owner;
+}
+
+/** Maps the shared memory object with the given name read-only
+ */
+inline auto attachShared(std::string const& name) -> std::shared_ptr<MappedFile const> {
+    auto fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error{"attachShared: can not open shared memory object " + name};
+    }
+    try {
+        auto file = std::make_shared<MappedFile const>(fd, name);
+        ::close(fd);
+        return file;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+#endif
+
+}
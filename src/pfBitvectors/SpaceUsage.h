@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+namespace seqan::pfb {
+
+/**
+ * In-memory size of a bit vector or string in bytes, split by level
+ *
+ * Returned by `space_breakdown()`, `space_usage()` returns total().
+ * Only heap memory is accounted, the object itself (sizeof) is not.
+ * Static tables (masks and lookup tables used by the queries) exist once per process and
+ * are shared by all instances of the same block size, adding two usages keeps the larger one.
+ */
+struct SpaceUsage {
+    size_t l0{};     // superblock counters
+    size_t l1{};     // block counters
+    size_t bits{};   // the bits/bit planes including alignment padding of the blocks
+    size_t tables{}; // static tables used by the queries
+    size_t slack{};  // allocated but unused capacity of the vectors
+    size_t other{};  // everything else, e.g. wavelet tree topology
+
+    auto total() const -> size_t {
+        return l0 + l1 + bits + tables + slack + other;
+    }
+
+    auto operator+=(SpaceUsage const& o) -> SpaceUsage& {
+        l0     += o.l0;
+        l1     += o.l1;
+        bits   += o.bits;
+        tables  = std::max(tables, o.tables);
+        slack  += o.slack;
+        other  += o.other;
+        return *this;
+    }
+
+    friend auto operator+(SpaceUsage a, SpaceUsage const& b) -> SpaceUsage {
+        return a += b;
+    }
+};
+
+namespace detail {
+    // bytes occupied by the elements of a vector
+    template <typename V>
+    auto used_bytes(V const& v) -> size_t {
+        return v.size() * sizeof(typename V::value_type);
+    }
+
+    // bytes allocated by a vector but not used
+    template <typename V>
+    auto slack_bytes(V const& v) -> size_t {
+        return (v.capacity() - v.size()) * sizeof(typename V::value_type);
+    }
+
+    // views (MappedStorage, see Storage.h) do not allocate
+    template <typename T>
+    auto slack_bytes(std::span<T const> const&) -> size_t {
+        return 0;
+    }
+
+    template <size_t N, template <size_t> typename TBitset>
+    constexpr bool uses_mask_tables = std::same_as<TBitset<N>, std::bitset<N>>;
+
+    // leftshift_masks (utils.h)
+    template <size_t N, template <size_t> typename TBitset>
+    constexpr size_t lshift_table_bytes = uses_mask_tables<N, TBitset> ? sizeof(std::array<std::bitset<N>, N+1>) : 0;
+
+    // skip_first_or_last_n_bits_masks (utils.h)
+    template <size_t N, template <size_t> typename TBitset>
+    constexpr size_t skip_table_bytes = uses_mask_tables<N, TBitset> ? sizeof(std::array<std::bitset<N>, N*2+1>) : 0;
+
+    // lut_ternarylogic2, lut_mark_exact and lut_mark_less (ternarylogic.h), only used for 3 bit planes
+    template <size_t N, template <size_t> typename TBitset, size_t bitct>
+    constexpr size_t ternary_table_bytes = (uses_mask_tables<N, TBitset> && bitct == 3) ? (256 + 8 + 9) * sizeof(void*) : 0;
+}
+
+}
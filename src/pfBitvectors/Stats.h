@@ -0,0 +1,248 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Query instrumentation
+ *
+ * Compiling with `PFBITVECTORS_STATS=1` (cmake option PFBITVECTORS_STATS) makes the queries
+ * (rank, prefix_rank, all_ranks, symbol) of the bit vectors and strings count per thread:
+ *  - the number of queries, nested queries (e.g. the levels of a WaveletMatrix) are not counted again
+ *  - the l0 counters, l1 counters and blocks they read
+ *  - the lookups in the static mask tables (utils.h, ternarylogic.h)
+ *  - the reuse distance of the blocks: the number of block reads since the same block was read last
+ *
+ * Without it all hooks are empty and vanish. The macro changes inline functions,
+ * all translation units of a program must agree on it.
+ * The reuse distance keeps one entry per block ever read, it is meant for analysis, not production.
+ */
+#ifndef PFBITVECTORS_STATS
+#define PFBITVECTORS_STATS 0
+#endif
+
+namespace seqan::pfb::stats {
+
+inline constexpr bool enabled = PFBITVECTORS_STATS;
+
+struct Counters {
+    uint64_t queries{};
+    uint64_t l0{};
+    uint64_t l1{};
+    uint64_t blocks{};
+    uint64_t tables{};
+    // reuse[0]: same block as the previous read, reuse[i]: distance in [2^(i-1), 2^i)
+    std::array<uint64_t, 65> reuse{};
+    // blocks read for the first time
+    uint64_t coldBlocks{};
+
+    auto operator+=(Counters const& o) -> Counters& {
+        queries    += o.queries;
+        l0         += o.l0;
+        l1         += o.l1;
+        blocks     += o.blocks;
+        tables     += o.tables;
+        coldBlocks += o.coldBlocks;
+        for (size_t i{0}; i < reuse.size(); ++i) {
+            reuse[i] += o.reuse[i];
+        }
+        return *this;
+    }
+
+    friend auto operator+(Counters a, Counters const& b) -> Counters {
+        return a += b;
+    }
+
+    // fraction of block reads with a reuse distance smaller than 2^e (cold reads count as infinite)
+    auto reuseBelow(size_t e) const -> double {
+        if (blocks == 0) return 0.;
+        uint64_t c{};
+        for (size_t i{0}; i <= std::min<size_t>(e, 64); ++i) {
+            c += reuse[i];
+        }
+        return double(c) / blocks;
+    }
+};
+
+namespace detail {
+    struct ThreadState;
+
+    struct Registry {
+        std::mutex                mutex;
+        std::vector<ThreadState*> threads;
+        Counters                  exited;
+    };
+
+    inline auto registry() -> Registry& {
+        static auto r = Registry{};
+        return r;
+    }
+
+    struct ThreadState {
+        Counters counters;
+        std::unordered_map<void const*, uint64_t> lastRead;
+        uint64_t clock{};
+        size_t   depth{};
+
+        ThreadState() {
+            auto& r = registry();
+            auto lock = std::lock_guard{r.mutex};
+            r.threads.push_back(this);
+        }
+        ThreadState(ThreadState const&) = delete;
+        auto operator=(ThreadState const&) -> ThreadState& = delete;
+
+        ~ThreadState() {
+            auto& r = registry();
+            auto lock = std::lock_guard{r.mutex};
+            r.exited += counters;
+            std::erase(r.threads, this);
+        }
+
+        void reset() {
+            counters = {};
+            lastRead.clear();
+            clock = 0;
+        }
+    };
+
+    inline auto local() -> ThreadState& {
+        thread_local auto s = ThreadState{};
+        return s;
+    }
+}
+
+/* The counting is kept out of line, so the instrumented queries are inlined and optimized
+ * like the plain ones (this also avoids false positive -Warray-bounds of gcc)
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define PFBITVECTORS_STATS_NOINLINE [[gnu::noinline]]
+#else
+#define PFBITVECTORS_STATS_NOINLINE
+#endif
+namespace detail {
+    PFBITVECTORS_STATS_NOINLINE inline void beginQuery() {
+        auto& s = local();
+        if (s.depth++ == 0) {
+            s.counters.queries += 1;
+        }
+    }
+
+    PFBITVECTORS_STATS_NOINLINE inline void endQuery() {
+        local().depth -= 1;
+    }
+
+    PFBITVECTORS_STATS_NOINLINE inline void readL0(size_t n) {
+        local().counters.l0 += n;
+    }
+
+    PFBITVECTORS_STATS_NOINLINE inline void readL1(size_t n) {
+        local().counters.l1 += n;
+    }
+
+    PFBITVECTORS_STATS_NOINLINE inline void readTable() {
+        local().counters.tables += 1;
+    }
+
+    PFBITVECTORS_STATS_NOINLINE inline void readBlock(void const* block) {
+        auto& s = local();
+        s.counters.blocks += 1;
+        auto [iter, inserted] = s.lastRead.try_emplace(block, s.clock);
+        if (inserted) {
+            s.counters.coldBlocks += 1;
+        } else {
+            auto distance = s.clock - iter->second - 1;
+            s.counters.reuse[std::bit_width(distance)] += 1;
+            iter->second = s.clock;
+        }
+        s.clock += 1;
+    }
+}
+#undef PFBITVECTORS_STATS_NOINLINE
+
+// counts a query, if it isn't nested inside another query
+struct Query {
+    Query() {
+        if constexpr (enabled) {
+            detail::beginQuery();
+        }
+    }
+    Query(Query const&) = delete;
+    auto operator=(Query const&) -> Query& = delete;
+
+    ~Query() {
+        if constexpr (enabled) {
+            detail::endQuery();
+        }
+    }
+};
+
+inline void readL0([[maybe_unused]] size_t n = 1) {
+    if constexpr (enabled) {
+        detail::readL0(n);
+    }
+}
+
+inline void readL1([[maybe_unused]] size_t n = 1) {
+    if constexpr (enabled) {
+        detail::readL1(n);
+    }
+}
+
+inline void readTable() {
+    if constexpr (enabled) {
+        detail::readTable();
+    }
+}
+
+// block is identified by its address
+inline void readBlock([[maybe_unused]] void const* block) {
+    if constexpr (enabled) {
+        detail::readBlock(block);
+    }
+}
+
+// counters of the calling thread
+inline auto local() -> Counters {
+    if constexpr (enabled) {
+        return detail::local().counters;
+    }
+    return {};
+}
+
+// counters of all threads, including exited ones; must not run concurrently to queries
+inline auto collect() -> Counters {
+    auto c = Counters{};
+    if constexpr (enabled) {
+        auto& r = detail::registry();
+        auto lock = std::lock_guard{r.mutex};
+        c = r.exited;
+        for (auto t : r.threads) {
+            c += t->counters;
+        }
+    }
+    return c;
+}
+
+// resets the counters of all threads; must not run concurrently to queries
+inline void reset() {
+    if constexpr (enabled) {
+        auto& r = detail::registry();
+        auto lock = std::lock_guard{r.mutex};
+        r.exited = {};
+        for (auto t : r.threads) {
+            t->reset();
+        }
+    }
+}
+
+}
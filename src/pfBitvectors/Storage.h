@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "Allocator.h"
+#include "BulkArchive.h"
+#include "MappedFile.h"
+
+#include <concepts>
+#include <memory>
+#include <span>
+
+/**
+ * Storage policies
+ *
+ * The trailing template parameter of the bit vectors and strings decides where l0, l1 and the
+ * bits live. An allocator (see Allocator.h) gives owning rebound_vectors, `MappedStorage` gives
+ * read-only std::spans into a bulk archive (see saveBinary) that lies in memory, usually a
+ * memory mapped file. Both use the same query code, only construction and space accounting differ.
+ *
+ * Mapped structures are views: nothing is deserialized, opening one only validates the header
+ * and locates the sections, which start at 64 byte boundaries. Pages are read from disk on first
+ * access, so start-up time is independent of the index size.
+ */
+namespace seqan::pfb {
+
+// read-only view on a bulk archive, used in place of an allocator
+struct MappedStorage {};
+
+template <typename TStorage>
+inline constexpr bool is_mapped_storage = std::same_as<TStorage, MappedStorage>;
+
+namespace detail {
+    template <typename TStorage>
+    struct storage_traits {
+        template <typename T>
+        using vector = rebound_vector<T, TStorage>;
+
+        // owning structures have nothing to keep alive
+        struct keep_alive {};
+    };
+
+    template <>
+    struct storage_traits<MappedStorage> {
+        template <typename T>
+        using vector = std::span<T const>;
+
+        using keep_alive = std::shared_ptr<MappedFile const>;
+    };
+
+    // hints for the sections of a mapped structure, l0 and l1 are small and paged in right away, bits are accessed randomly
+    template <typename L0, typename L1, typename Bits>
+    void advise_sections(MappedFile const& file, std::span<L0 const> l0, std::span<L1 const> l1, std::span<Bits const> bits) {
+        file.advise(l0, Advice::WillNeed);
+        file.advise(l1, Advice::WillNeed);
+        file.advise(bits, Advice::Random);
+    }
+}
+
+// container of T, a rebound_vector or a std::span for MappedStorage
+template <typename T, typename TStorage>
+using storage_vector = typename detail::storage_traits<TStorage>::template vector<T>;
+
+// section of a default constructed view, a single zeroed element like in an empty owning structure
+template <typename T>
+auto empty_section() -> std::span<T const> {
+    static T const element{};
+    return {&element, 1};
+}
+
+// mapping kept alive by a structure, empty for owning storage
+template <typename TStorage>
+using storage_keep_alive = typename detail::storage_traits<TStorage>::keep_alive;
+
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Type tags of bulk archives
+ *
+ * A tag is a hash over the name of a structure and all template parameters that change its
+ * serialized layout (Sigma, block sizes, alignment, bit set and counter types). saveBinary writes
+ * the tag of the saved type into the archive header, loadBinary and the mapped views throw if it
+ * does not match. The allocator is not part of the tag, archives can be loaded with any allocator.
+ *
+ * Types provide `static constexpr auto bulk_tag() -> uint64_t`, types without it have the tag 0.
+ */
+namespace seqan::pfb::bulk {
+
+// FNV-1a, byte order independent
+constexpr auto fnv1a(uint64_t h, uint64_t v) -> uint64_t {
+    for (size_t i{0}; i < 8; ++i) {
+        h ^= (v >> (i*8)) & 0xff;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// the length is hashed as well, so consecutive strings can not be shifted into each other
+constexpr auto fnv1a(uint64_t h, std::string_view s) -> uint64_t {
+    h = fnv1a(h, uint64_t{s.size()});
+    for (char c : s) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// name of a bit set template, specialized for each storage (see WordBitset.h)
+template <template <size_t> typename TBitset>
+inline constexpr std::string_view bitset_name{};
+
+template <>
+inline constexpr std::string_view bitset_name<std::bitset>{"std::bitset"};
+
+// size and signedness of a counter type
+template <typename T>
+    requires std::is_integral_v<T>
+inline constexpr uint64_t integral_tag = sizeof(T) * 2 + std::is_signed_v<T>;
+
+/** Combines the name of a structure with its layout parameters (integers or names)
+ */
+template <typename... Params>
+constexpr auto make_tag(std::string_view kind, Params... params) -> uint64_t {
+    auto h = fnv1a(0xcbf29ce484222325ull, kind);
+    ((h = fnv1a(h, params)), ...);
+    // 0 is reserved for untagged types
+    return h == 0 ? 1 : h;
+}
+
+// tag of T, 0 if T has none
+template <typename T>
+constexpr auto type_tag() -> uint64_t {
+    if constexpr (requires() { { T::bulk_tag() } -> std::same_as<uint64_t>; }) {
+        return T::bulk_tag();
+    } else {
+        return 0;
+    }
+}
+
+}
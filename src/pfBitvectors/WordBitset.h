@@ -0,0 +1,319 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "TypeTag.h"
+#include "simd.h"
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace seqan::pfb {
+
+/**
+ * WordBitset a drop-in replacement for std::bitset<N> stored as plain uint64_t words
+ *
+ * Bit i is bit (i%64) of word i/64, independent of the standard library.
+ * Ranks, masks and popcounts are computed by the word kernels below instead of
+ * going through shifts and mask tables of std::bitset.
+ * The alignment is the one of uint64_t, cache line alignment is done by the surrounding
+ * structures (see AlignedBitset and InBits), identical to std::bitset.
+ * Can be selected via the `TBitset` template parameter of the bit vectors and strings.
+ */
+template <size_t N>
+struct WordBitset {
+    static_assert(N % 64 == 0, "WordBitset requires a multiple of 64 bits");
+    static constexpr size_t word_ct = N / 64;
+
+    std::array<uint64_t, word_ct> words{};
+
+    struct reference {
+        uint64_t* word;
+        uint64_t  mask;
+
+        auto operator=(bool v) -> reference& {
+            if (v) *word |= mask;
+            else   *word &= ~mask;
+            return *this;
+        }
+        auto operator=(reference const& o) -> reference& {
+            return *this = static_cast<bool>(o);
+        }
+        operator bool() const {
+            return (*word & mask) != 0;
+        }
+    };
+
+    constexpr WordBitset() = default;
+
+    // same as the std::bitset<N> constructor, sets the lowest 64 bits
+    constexpr WordBitset(uint64_t v)
+        : words{{v}}
+    {}
+
+    WordBitset(std::bitset<N> const& b) {
+        static constexpr auto mask = std::bitset<N>{~uint64_t{0}};
+        for (size_t i{0}; i < word_ct; ++i) {
+            words[i] = ((b >> (i*64)) & mask).to_ullong();
+        }
+    }
+
+    static constexpr auto size() -> size_t {
+        return N;
+    }
+
+    bool test(size_t i) const {
+        assert(i < N);
+        return (words[i/64] >> (i%64)) & 1;
+    }
+    bool operator[](size_t i) const {
+        return test(i);
+    }
+    auto operator[](size_t i) -> reference {
+        assert(i < N);
+        return {&words[i/64], uint64_t{1} << (i%64)};
+    }
+
+    auto set() -> WordBitset& {
+        for (auto& w : words) w = ~uint64_t{0};
+        return *this;
+    }
+    auto set(size_t i, bool v = true) -> WordBitset& {
+        (*this)[i] = v;
+        return *this;
+    }
+    auto reset() -> WordBitset& {
+        for (auto& w : words) w = 0;
+        return *this;
+    }
+    auto reset(size_t i) -> WordBitset& {
+        return set(i, false);
+    }
+    auto flip() -> WordBitset& {
+        for (auto& w : words) w = ~w;
+        return *this;
+    }
+
+    auto count() const -> size_t {
+        size_t c{};
+        for (auto w : words) c += std::popcount(w);
+        return c;
+    }
+    bool any() const {
+        return count() > 0;
+    }
+    bool none() const {
+        return !any();
+    }
+    bool all() const {
+        return count() == N;
+    }
+
+    auto to_ullong() const -> uint64_t {
+        return words[0];
+    }
+    auto to_bitset() const -> std::bitset<N> {
+        auto b = std::bitset<N>{};
+        for (size_t i{word_ct}; i > 0; --i) {
+            b = (b << 64) | std::bitset<N>{words[i-1]};
+        }
+        return b;
+    }
+
+    auto data() -> uint64_t* {
+        return words.data();
+    }
+    auto data() const -> uint64_t const* {
+        return words.data();
+    }
+
+    auto operator&=(WordBitset const& o) -> WordBitset& {
+        for (size_t i{0}; i < word_ct; ++i) words[i] &= o.words[i];
+        return *this;
+    }
+    auto operator|=(WordBitset const& o) -> WordBitset& {
+        for (size_t i{0}; i < word_ct; ++i) words[i] |= o.words[i];
+        return *this;
+    }
+    auto operator^=(WordBitset const& o) -> WordBitset& {
+        for (size_t i{0}; i < word_ct; ++i) words[i] ^= o.words[i];
+        return *this;
+    }
+    auto operator~() const -> WordBitset {
+        auto r = *this;
+        return r.flip();
+    }
+
+    // shifts towards higher bit positions, like std::bitset
+    auto operator<<=(size_t shift) -> WordBitset& {
+        if (shift >= N) return reset();
+        auto ws = shift / 64;
+        auto bs = shift % 64;
+        for (size_t i{word_ct}; i > ws; --i) {
+            auto j = i - 1 - ws;
+            auto v = words[j] << bs;
+            if (bs && j > 0) v |= words[j-1] >> (64 - bs);
+            words[i-1] = v;
+        }
+        for (size_t i{0}; i < ws; ++i) words[i] = 0;
+        return *this;
+    }
+    // shifts towards lower bit positions, like std::bitset
+    auto operator>>=(size_t shift) -> WordBitset& {
+        if (shift >= N) return reset();
+        auto ws = shift / 64;
+        auto bs = shift % 64;
+        for (size_t i{0}; i + ws < word_ct; ++i) {
+            auto j = i + ws;
+            auto v = words[j] >> bs;
+            if (bs && j+1 < word_ct) v |= words[j+1] << (64 - bs);
+            words[i] = v;
+        }
+        for (size_t i{word_ct - ws}; i < word_ct; ++i) words[i] = 0;
+        return *this;
+    }
+    auto operator<<(size_t shift) const -> WordBitset {
+        auto r = *this;
+        return r <<= shift;
+    }
+    auto operator>>(size_t shift) const -> WordBitset {
+        auto r = *this;
+        return r >>= shift;
+    }
+
+    friend auto operator&(WordBitset l, WordBitset const& r) -> WordBitset { return l &= r; }
+    friend auto operator|(WordBitset l, WordBitset const& r) -> WordBitset { return l |= r; }
+    friend auto operator^(WordBitset l, WordBitset const& r) -> WordBitset { return l ^= r; }
+    friend bool operator==(WordBitset const&, WordBitset const&) = default;
+};
+
+template <>
+inline constexpr std::string_view bulk::bitset_name<WordBitset>{"WordBitset"};
+
+/* Stored in 64bit blocks starting with the lowest bits,
+ * the same format as saveBV/loadBV of std::bitset<N>.
+ */
+template <size_t N, typename Archive>
+void loadBV(WordBitset<N>& b, Archive& ar) {
+    for (auto& w : b.words) {
+        ar(w);
+    }
+}
+template <size_t N, typename Archive>
+void saveBV(WordBitset<N> const& b, Archive& ar) {
+    for (auto const& w : b.words) {
+        ar(w);
+    }
+}
+
+namespace detail {
+    // bits of word i at positions smaller than n
+    inline auto word_mask_below(size_t i, size_t n) -> uint64_t {
+        auto start = i * 64;
+        if (n <= start)     return 0;
+        if (n >= start + 64) return ~uint64_t{0};
+        return (uint64_t{1} << (n - start)) - 1;
+    }
+
+    // counts the set bits in [lo, hi)
+    template <size_t N>
+    auto count_range(WordBitset<N> const& b, size_t lo, size_t hi) -> size_t {
+        assert(lo <= hi && hi <= N);
+        size_t c{};
+        for (size_t i{0}; i < WordBitset<N>::word_ct; ++i) {
+            auto m = word_mask_below(i, hi) & ~word_mask_below(i, lo);
+            c += std::popcount(b.words[i] & m);
+        }
+        return c;
+    }
+}
+
+// same as lshift_and_count in utils.h: counts the bits [0, N-shift)
+template <size_t N>
+size_t lshift_and_count(WordBitset<N> const& b, size_t shift) {
+    assert(shift <= N);
+    return detail::count_range(b, 0, N - shift);
+}
+
+// same as rshift_and_count in utils.h: counts the bits [shift, N)
+template <size_t N>
+size_t rshift_and_count(WordBitset<N> const& b, size_t shift) {
+    assert(shift <= N);
+    return detail::count_range(b, shift, N);
+}
+
+// same as skip_first_or_last_n_bits_and_count in utils.h
+template <size_t N>
+size_t skip_first_or_last_n_bits_and_count(WordBitset<N> const& b, size_t idx) {
+    assert(idx <= N*2);
+    if (idx <= N) return detail::count_range(b, idx, N);
+    return detail::count_range(b, 0, idx - N);
+}
+
+template <size_t N>
+size_t signed_rshift_and_count(WordBitset<N> const& b, size_t shift) {
+    return skip_first_or_last_n_bits_and_count(b, shift);
+}
+
+/** Marks all positions holding exactly value, with _arr[0] being the least significant bit
+ *  (see mark_exact_large of std::bitset)
+ */
+template <size_t N1, size_t N2>
+auto mark_exact_large(size_t value, std::array<WordBitset<N1>, N2> const& _arr) -> WordBitset<N1> {
+#if PFBITVECTORS_SIMD
+    if constexpr (simd::supported_ternarylogic<N1>) {
+        if (simd::ternarylogic_enabled()) return simd::mark_exact(value, _arr);
+    }
+#endif
+    auto r = WordBitset<N1>{};
+    for (size_t i{0}; i < WordBitset<N1>::word_ct; ++i) {
+        auto acc = ~uint64_t{0};
+        for (size_t j{0}; j < N2; ++j) {
+            auto s = uint64_t{0} - ((value >> j) & 1);
+            acc &= ~(_arr[j].words[i] ^ s);
+        }
+        r.words[i] = acc;
+    }
+    return r;
+}
+
+/** Marks all positions holding a value smaller or equal to value
+ *  (see mark_exact_or_less_large of std::bitset)
+ */
+template <size_t N1, size_t N2>
+auto mark_exact_or_less_large(size_t value, std::array<WordBitset<N1>, N2> const& _arr) -> WordBitset<N1> {
+    if (value >> N2) return WordBitset<N1>{}.set();
+#if PFBITVECTORS_SIMD
+    if constexpr (simd::supported_ternarylogic<N1>) {
+        if (simd::ternarylogic_enabled()) return simd::mark_exact_or_less(value, _arr);
+    }
+#endif
+    // from least to most significant bit: smaller if this bit is smaller, or equal and the lower bits are smaller or equal
+    auto r = WordBitset<N1>{};
+    for (size_t i{0}; i < WordBitset<N1>::word_ct; ++i) {
+        auto acc = ~uint64_t{0};
+        for (size_t j{0}; j < N2; ++j) {
+            auto p = _arr[j].words[i];
+            auto s = uint64_t{0} - ((value >> j) & 1);
+            acc = (~p & s) | (~(p ^ s) & acc);
+        }
+        r.words[i] = acc;
+    }
+    return r;
+}
+
+/** Marks all positions holding a value smaller than value
+ *  (see mark_less_large of std::bitset)
+ */
+template <size_t N1, size_t N2>
+auto mark_less_large(size_t value, std::array<WordBitset<N1>, N2> const& _arr) -> WordBitset<N1> {
+    if (value == 0) return WordBitset<N1>{};
+    return mark_exact_or_less_large(value-1, _arr);
+}
+
+}
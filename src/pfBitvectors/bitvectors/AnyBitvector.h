@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../AnyConfig.h"
+#include "../SpaceUsage.h"
+#include "Bitvector2L.h"
+#include "PairedBitvector2L.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <variant>
+
+namespace seqan::pfb {
+
+/**
+ * AnyBitvectorOf a bit vector whose configuration is chosen at runtime from a fixed set `Configs...` (see Named)
+ *
+ * Single queries dispatch on every call (std::visit). The *_batch functions dispatch once and then
+ * answer all queries with the concrete type, `visit(cb)` hands the concrete type to cb for own query loops.
+ */
+template <typename... Configs>
+struct AnyBitvectorOf {
+    std::variant<typename Configs::type...> vec;
+
+    AnyBitvectorOf() = default;
+
+    // builds the configuration named `config`, throws if it is not part of Configs...
+    template <std::ranges::sized_range range_t>
+    AnyBitvectorOf(std::string_view config, range_t&& _range) {
+        detail::emplace_config(vec, detail::config_index<Configs...>(config), std::forward<range_t>(_range));
+    }
+
+    // names of all configurations
+    static constexpr auto configs() {
+        return std::array<std::string_view, sizeof...(Configs)>{Configs::name...};
+    }
+
+    auto config() const -> std::string_view {
+        return configs()[vec.index()];
+    }
+
+    template <typename CB>
+    decltype(auto) visit(CB&& cb) const {
+        return std::visit(std::forward<CB>(cb), vec);
+    }
+
+    size_t size() const {
+        return visit([](auto const& v) -> size_t { return v.size(); });
+    }
+
+    bool symbol(size_t idx) const {
+        return visit([&](auto const& v) -> bool { return v.symbol(idx); });
+    }
+
+    uint64_t rank(size_t idx) const {
+        return visit([&](auto const& v) -> uint64_t { return v.rank(idx); });
+    }
+
+    // out[i] = symbol(idx[i])
+    void symbol_batch(std::span<uint64_t const> idx, std::span<uint64_t> out) const {
+        assert(out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.symbol(idx[i]);
+            }
+        });
+    }
+
+    // out[i] = rank(idx[i])
+    void rank_batch(std::span<uint64_t const> idx, std::span<uint64_t> out) const {
+        assert(out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.rank(idx[i]);
+            }
+        });
+    }
+
+    auto space_breakdown() const -> SpaceUsage {
+        return visit([](auto const& v) { return v.space_breakdown(); });
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    // the configuration id comes first, loading switches to the saved configuration
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        constexpr auto ids = detail::config_ids<Configs...>();
+        uint64_t id = ids[vec.index()];
+        ar(id);
+        if (id != ids[vec.index()]) {
+            detail::emplace_config(vec, detail::config_index<Configs...>(id));
+        }
+        std::visit([&](auto& v) { ar(v); }, vec);
+    }
+};
+
+// precompiled default set
+using AnyBitvector = AnyBitvectorOf<
+    Named<"Bitvector2L<64, 65536>",         Bitvector2L<64, 65536>>,
+    Named<"Bitvector2L<128, 65536>",        Bitvector2L<128, 65536>>,
+    Named<"Bitvector2L<256, 65536>",        Bitvector2L<256, 65536>>,
+    Named<"Bitvector2L<512, 65536>",        Bitvector2L<512, 65536>>,
+    Named<"Bitvector2L<1024, 65536>",       Bitvector2L<1024, 65536>>,
+    Named<"Bitvector2LWord<64, 65536>",     Bitvector2LWord<64, 65536>>,
+    Named<"Bitvector2LWord<512, 65536>",    Bitvector2LWord<512, 65536>>,
+    Named<"PairedBitvector2L<256, 65536>",  PairedBitvector2L<256, 65536>>,
+    Named<"PairedBitvector2L<512, 65536>",  PairedBitvector2L<512, 65536>>,
+    Named<"PairedBitvector2L<1024, 65536>", PairedBitvector2L<1024, 65536>>
+>;
+
+}
@@ -4,6 +4,11 @@
 #pragma once
 
 #include "../AlignedBitset.h"
+#include "../Counter.h"
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../Storage.h"
+#include "../TypeTag.h"
 #include "../ranges.h"
 #include "../utils.h"
 
@@ -16,6 +21,8 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <limits>
 #include <ranges>
 #include <span>
@@ -26,30 +33,66 @@ namespace seqan::pfb {
 /**
  * Bitvector2L a bit vector with only bits and blocks
  *
+ * TL1/TL0 are the counter types of the two levels (see Counter.h)
+ * With MappedStorage (see Storage.h) it is a read-only view on a bulk archive, see MappedBitvector2L
  */
-template <size_t l1_bits_ct, size_t l0_bits_ct, bool shift_and_count=false, bool Align=true>
+template <size_t l1_bits_ct, size_t l0_bits_ct, bool shift_and_count=false, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TL1=l1_counter_t<l1_bits_ct, l0_bits_ct>, typename TL0=uint64_t, typename TAllocator=std::allocator<std::byte>>
 struct Bitvector2L {
     static_assert(l1_bits_ct < l0_bits_ct, "first level must be smaller than second level");
-    static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<uint16_t>::max(), "l0_bits_ct can only hold up to uint16_t bits");
-    std::vector<uint64_t> l0{0};
-    std::vector<uint16_t> l1{0};
-    std::vector<AlignedBitset<l1_bits_ct, Align>> bits{{}};
+    static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<TL1>::max(), "TL1 can not hold the counts of a l0 block");
+    using allocator_type = TAllocator;
+    using Block = AlignedBitset<l1_bits_ct, Align, TBitset>;
+    using L1Counter = TL1;
+    using L0Counter = TL0;
+
+    // read-only view on a bulk archive, see Storage.h
+    static constexpr bool mapped = is_mapped_storage<TAllocator>;
+
+    storage_vector<TL0, TAllocator>   l0;
+    storage_vector<TL1, TAllocator>   l1;
+    storage_vector<Block, TAllocator> bits;
     size_t totalLength{};
+    [[no_unique_address]] storage_keep_alive<TAllocator> file{};
+
+    // an empty bit vector still has one block, so rank(0) needs no special case
+    Bitvector2L() requires (!mapped)
+        : l0(1), l1(1), bits(1)
+    {}
+
+    // an empty view spans a zeroed block as well
+    Bitvector2L() requires mapped
+        : l0(empty_section<TL0>()), l1(empty_section<TL1>()), bits(empty_section<Block>())
+    {}
 
-    Bitvector2L() = default;
     Bitvector2L(Bitvector2L const&) = default;
     Bitvector2L(Bitvector2L&&) noexcept = default;
 
+    explicit Bitvector2L(TAllocator const& alloc) requires (!mapped)
+        : l0(1, 0, alloc)
+        , l1(1, 0, alloc)
+        , bits(1, Block{}, alloc)
+    {}
+
+    // copy using a different allocator
+    Bitvector2L(Bitvector2L const& other, TAllocator const& alloc) requires (!mapped)
+        : l0(other.l0, alloc)
+        , l1(other.l1, alloc)
+        , bits(other.bits, alloc)
+        , totalLength{other.totalLength}
+    {}
+
     // constructor accepting view to bools or already compact uint64_t
     // converts it to a view that produces `std::bitset<l1_bits_ct>`
     template <std::ranges::sized_range range_t>
-    Bitvector2L(range_t&& _range) {
+    Bitvector2L(range_t&& _range, TAllocator const& alloc = {})
+        : Bitvector2L{alloc}
+    {
         auto _size = _range.size();
         if constexpr (std::same_as<std::ranges::range_value_t<range_t>, uint64_t>) {
-            *this = {std::forward<range_t>(_range) | view_as_bitset<l1_bits_ct>};
+            *this = Bitvector2L{internal_tag{}, std::forward<range_t>(_range) | view_as_bitset<l1_bits_ct>, _size*64, alloc};
             totalLength = _size*64;
         } else if constexpr (std::convertible_to<std::ranges::range_value_t<range_t>, bool>) {
-            *this = {std::forward<range_t>(_range) | view_bool_as_uint64 | view_as_bitset<l1_bits_ct>};
+            *this = Bitvector2L{internal_tag{}, std::forward<range_t>(_range) | view_bool_as_uint64 | view_as_bitset<l1_bits_ct>, _size, alloc};
             totalLength = _size;
         } else {
             []<bool b=false>() {
@@ -65,7 +108,19 @@ struct Bitvector2L {
     // the actual constructor, already receiving premade std::bitsets<N>
     template <std::ranges::sized_range range_t>
         requires std::same_as<std::ranges::range_value_t<range_t>, std::bitset<l1_bits_ct>>
-    Bitvector2L(range_t&& _range) {
+    Bitvector2L(range_t&& _range, TAllocator const& alloc = {})
+        : Bitvector2L{internal_tag{}, std::forward<range_t>(_range), _range.size()*l1_bits_ct, alloc}
+    {}
+
+private:
+    struct internal_tag{};
+
+    // builds from premade std::bitsets, only the first _entries bits are real, the rest of the last block is padding
+    template <std::ranges::sized_range range_t>
+    Bitvector2L(internal_tag, range_t&& _range, size_t _entries, TAllocator const& alloc)
+        : Bitvector2L{alloc}
+    {
+        check_l0_counter<TL0>(_entries, "Bitvector2L");
         auto _length = static_cast<size_t>(_range.size()*l1_bits_ct);
         l0.resize(_length/l0_bits_ct + 1);
         l1.resize(_length/l1_bits_ct + 1);
@@ -87,27 +142,51 @@ struct Bitvector2L {
         }
     }
 
+public:
+    // maps a file written by saveBinary (MappedStorage only)
+    explicit Bitvector2L(std::filesystem::path const& path) requires mapped
+        : Bitvector2L{std::make_shared<MappedFile const>(path)}
+    {}
+
+    // view on an already mapped archive (e.g. shared memory, see attachShared), keeps the mapping alive
+    explicit Bitvector2L(std::shared_ptr<MappedFile const> _file) requires mapped
+        : Bitvector2L{_file->data(), _file->size()}
+    {
+        file = std::move(_file);
+        detail::advise_sections(*file, l0, l1, bits);
+    }
+
+    // view on an archive in memory, the memory must outlive the view
+    Bitvector2L(std::byte const* data, size_t size) requires mapped {
+        auto reader = BulkMemoryReader{data, size};
+        bulk::validate_type(reader.typeTag(), bulk_tag(), "Bitvector2L");
+        serialize(reader);
+    }
+
     auto operator=(Bitvector2L const&) -> Bitvector2L& = default;
     auto operator=(Bitvector2L&&) noexcept -> Bitvector2L& = default;
 
-    void reserve(size_t _length) {
+    void reserve(size_t _length) requires (!mapped) {
         l0.reserve(_length/l0_bits_ct + 1);
         l1.reserve(_length/l1_bits_ct + 1);
         bits.reserve(_length/l1_bits_ct + 1);
     }
 
-    void push_back(bool _value) {
+    void push_back(bool _value) requires (!mapped) {
+        assert(totalLength < std::numeric_limits<TL0>::max());
         auto bitId         = totalLength % l1_bits_ct;
         bits.back()[bitId] = _value;
 
         totalLength += 1;
         if (totalLength % l1_bits_ct == 0) { // new l1-block
-            l1.emplace_back(l1.back() + bits.back().count());
+            // counted in 64bit, a full l0 block does not fit into TL1
+            auto count = uint64_t{l1.back()} + bits.back().count();
             bits.emplace_back();
             if (totalLength % l0_bits_ct == 0) { // new l0-block
-                l0.emplace_back(l0.back() + l1.back());
-                l1.back() = 0;
+                l0.emplace_back(l0.back() + count);
+                count = 0;
             }
+            l1.emplace_back(count);
         }
     }
 
@@ -116,21 +195,27 @@ struct Bitvector2L {
     }
 
     bool symbol(size_t idx) const noexcept {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx < totalLength);
         auto bitId = idx % l1_bits_ct;
         auto l1Id  = idx / l1_bits_ct;
         assert(l1Id < bits.size());
+        stats::readBlock(&bits[l1Id]);
         auto bit = bits[l1Id][bitId];
         return bit;
     }
 
     uint64_t rank(size_t idx) const noexcept {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         auto bitId = idx % (l1_bits_ct);
         auto l1Id = idx / l1_bits_ct;
         auto l0Id = idx / l0_bits_ct;
         assert(l1Id < bits.size());
         assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
 
         auto count = [&]() {
             if constexpr (shift_and_count) {
@@ -161,11 +246,57 @@ struct Bitvector2L {
         return idx;
     }
 
+    // heap memory of this bit vector (the mapped sections for MappedStorage), see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage {
+        auto s   = SpaceUsage{};
+        s.l0     = detail::used_bytes(l0);
+        s.l1     = detail::used_bytes(l1);
+        s.bits   = detail::used_bytes(bits);
+        s.slack  = detail::slack_bytes(l0) + detail::slack_bytes(l1) + detail::slack_bytes(bits);
+        s.tables = shift_and_count ? 0 : detail::skip_table_bytes<l1_bits_ct, TBitset>;
+        return s;
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    auto get_allocator() const -> TAllocator requires (!mapped) {
+        return TAllocator{l0.get_allocator()};
+    }
+
+    // hint for the blocks of a view, e.g. Advice::WillNeed to page in the whole bit vector
+    void advise(Advice advice) const requires mapped {
+        if (file) file->advise(bits, advice);
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("Bitvector2L", l1_bits_ct, l0_bits_ct, Align, bulk::bitset_name<TBitset>, bulk::integral_tag<TL1>, bulk::integral_tag<TL0>);
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(l0, l1, totalLength, bits);
     }
 };
+
+// same as Bitvector2L, but the blocks are stored as plain uint64_t words
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using Bitvector2LWord = Bitvector2L<l1_bits_ct, l0_bits_ct, false, true, WordBitset>;
+
+// same as Bitvector2L, with 32bit l0 counters (for less than 2^32 bits)
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using Bitvector2L32 = Bitvector2L<l1_bits_ct, l0_bits_ct, false, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint32_t>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as Bitvector2L, allocating from a std::pmr::memory_resource
+    template <size_t l1_bits_ct, size_t l0_bits_ct>
+    using Bitvector2L = seqan::pfb::Bitvector2L<l1_bits_ct, l0_bits_ct, false, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint64_t, pmr::allocator>;
+}
+#endif
+
 //using L0L1_64_4kBitvector   = Bitvector2L<64, 4096>;
 //using L0L1_128_4kBitvector  = Bitvector2L<128, 4096>;
 //using L0L1_256_4kBitvector  = Bitvector2L<256, 4096>;
@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../Storage.h"
+#include "Bitvector2L.h"
+
+namespace seqan::pfb {
+
+/**
+ * MappedBitvector2L a read-only view of a Bitvector2L stored as bulk archive
+ *
+ * Same as the mapped strings (see MappedFlattenedBitvectors2L), it is the Bitvector2L with
+ * MappedStorage, queries run directly on the archive in memory, a mapped file or a shared memory object.
+ */
+template <size_t l1_bits_ct, size_t l0_bits_ct, bool shift_and_count=false, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TL1=l1_counter_t<l1_bits_ct, l0_bits_ct>, typename TL0=uint64_t>
+using MappedBitvector2L = Bitvector2L<l1_bits_ct, l0_bits_ct, shift_and_count, Align, TBitset, TL1, TL0, MappedStorage>;
+
+// view of Bitvector<L1, L0>
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedBitvector = MappedBitvector2L<l1_bits_ct, l0_bits_ct>;
+
+// view of Bitvector2LWord
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedBitvector2LWord = MappedBitvector2L<l1_bits_ct, l0_bits_ct, false, true, WordBitset>;
+
+// view of Bitvector2L32
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedBitvector2L32 = MappedBitvector2L<l1_bits_ct, l0_bits_ct, false, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint32_t>;
+
+}
@@ -4,6 +4,10 @@
 #pragma once
 
 #include "../AlignedBitset.h"
+#include "../Allocator.h"
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
 #include "../ranges.h"
 #include "../utils.h"
 
@@ -16,6 +20,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <ranges>
 #include <span>
 #include <vector>
@@ -31,25 +36,42 @@ namespace seqan::pfb {
  *   (512) for 1024bits, we need 1088bits, resulting in 1.0625bits per bit
  *   (1024) for 2048bits, we need 2112bits, resulting in 1.0312bits per bit
  */
-template <size_t bits_ct, bool Align=true>
+template <size_t bits_ct, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TAllocator=std::allocator<std::byte>>
 struct PairedBitvector1L {
-    std::vector<uint64_t>                      l0{0};
-    std::vector<AlignedBitset<bits_ct, Align>> bits{{}};
+    using allocator_type = TAllocator;
+    using Block = AlignedBitset<bits_ct, Align, TBitset>;
+
+    rebound_vector<uint64_t, TAllocator> l0{0};
+    rebound_vector<Block, TAllocator>    bits{{}};
     size_t totalLength{};
 
     PairedBitvector1L() = default;
     PairedBitvector1L(PairedBitvector1L const&) = default;
     PairedBitvector1L(PairedBitvector1L&&) noexcept = default;
 
+    explicit PairedBitvector1L(TAllocator const& alloc)
+        : l0(1, 0, alloc)
+        , bits(1, Block{}, alloc)
+    {}
+
+    // copy using a different allocator
+    PairedBitvector1L(PairedBitvector1L const& other, TAllocator const& alloc)
+        : l0(other.l0, alloc)
+        , bits(other.bits, alloc)
+        , totalLength{other.totalLength}
+    {}
+
     // constructor accepting view to bools or already compact uint64_t
     template <std::ranges::sized_range range_t>
-    PairedBitvector1L(range_t&& _range) {
+    PairedBitvector1L(range_t&& _range, TAllocator const& alloc = {})
+        : PairedBitvector1L{alloc}
+    {
         auto _size = _range.size();
         if constexpr (std::same_as<std::ranges::range_value_t<range_t>, uint64_t>) {
-            *this = {std::forward<range_t>(_range) | view_as_bitset<bits_ct>};
+            *this = PairedBitvector1L{std::forward<range_t>(_range) | view_as_bitset<bits_ct>, alloc};
             totalLength = _size*64;
         } else if constexpr (std::convertible_to<std::ranges::range_value_t<range_t>, bool>) {
-            *this = {std::forward<range_t>(_range) | view_bool_as_uint64 | view_as_bitset<bits_ct>};
+            *this = PairedBitvector1L{std::forward<range_t>(_range) | view_bool_as_uint64 | view_as_bitset<bits_ct>, alloc};
             totalLength = _size;
         } else {
             []<bool b=false>() {
@@ -63,7 +85,9 @@ struct PairedBitvector1L {
     // the actual constructor, already receiving premade std::bitsets<N>
     template <std::ranges::sized_range range_t>
         requires std::same_as<std::ranges::range_value_t<range_t>, std::bitset<bits_ct>>
-    PairedBitvector1L(range_t&& _range) {
+    PairedBitvector1L(range_t&& _range, TAllocator const& alloc = {})
+        : PairedBitvector1L{alloc}
+    {
         auto _length = static_cast<size_t>(_range.size()*bits_ct);
 
         l0.resize((_length+bits_ct)/(bits_ct*2) + 1);
@@ -112,17 +136,22 @@ struct PairedBitvector1L {
     }
 
     bool symbol(size_t idx) const noexcept {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx < totalLength);
         auto bitId        = idx % bits_ct;
         auto blockId      = idx / bits_ct;
+        stats::readBlock(&bits[blockId]);
         auto bit = bits[blockId][bitId];
         return bit;
     }
 
     uint64_t rank(size_t idx) const noexcept {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         auto bitId = idx % (bits_ct*2);
         auto l0Id  = idx / bits_ct;
+        stats::readL0();
+        stats::readBlock(&bits[l0Id]);
 
         int64_t right_l0 = (l0Id%2)*2-1;
 
@@ -133,10 +162,45 @@ struct PairedBitvector1L {
         return ct;
     }
 
+    // heap memory of this bit vector, see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage {
+        auto s   = SpaceUsage{};
+        s.l0     = detail::used_bytes(l0);
+        s.bits   = detail::used_bytes(bits);
+        s.slack  = detail::slack_bytes(l0) + detail::slack_bytes(bits);
+        s.tables = detail::skip_table_bytes<bits_ct, TBitset>;
+        return s;
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    auto get_allocator() const -> TAllocator {
+        return TAllocator{l0.get_allocator()};
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("PairedBitvector1L", bits_ct, Align, bulk::bitset_name<TBitset>);
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(l0, totalLength, bits);
     }
 };
 
+// same as PairedBitvector1L, but the blocks are stored as plain uint64_t words
+template <size_t bits_ct>
+using PairedBitvector1LWord = PairedBitvector1L<bits_ct, true, WordBitset>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as PairedBitvector1L, allocating from a std::pmr::memory_resource
+    template <size_t bits_ct>
+    using PairedBitvector1L = seqan::pfb::PairedBitvector1L<bits_ct, true, std::bitset, pmr::allocator>;
+}
+#endif
+
 }
@@ -4,6 +4,10 @@
 #pragma once
 
 #include "../AlignedBitset.h"
+#include "../Allocator.h"
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
 #include "../ranges.h"
 #include "../utils.h"
 
@@ -16,6 +20,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <limits>
 #include <ranges>
 #include <span>
@@ -27,28 +32,47 @@ namespace seqan::pfb {
  * PairedBitvector2L a bit vector with only bits and blocks
  *
  */
-template <size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true, bool ShiftAndCount=false>
+template <size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true, bool ShiftAndCount=false, template <size_t> typename TBitset=std::bitset, typename TAllocator=std::allocator<std::byte>>
 struct PairedBitvector2L {
     static_assert(l1_bits_ct < l0_bits_ct, "first level must be smaller than second level");
     static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<uint16_t>::max(), "l0_bits_ct can only hold up to uint16_t bits");
-    std::vector<uint64_t> l0{0};
-    std::vector<uint16_t> l1{0};
-    std::vector<AlignedBitset<l1_bits_ct, Align>> bits{{}};
+    using allocator_type = TAllocator;
+    using Block = AlignedBitset<l1_bits_ct, Align, TBitset>;
+
+    rebound_vector<uint64_t, TAllocator> l0{0};
+    rebound_vector<uint16_t, TAllocator> l1{0};
+    rebound_vector<Block, TAllocator>    bits{{}};
     size_t totalLength{};
 
     PairedBitvector2L() = default;
     PairedBitvector2L(PairedBitvector2L const&) = default;
     PairedBitvector2L(PairedBitvector2L&&) noexcept = default;
 
+    explicit PairedBitvector2L(TAllocator const& alloc)
+        : l0(1, 0, alloc)
+        , l1(1, 0, alloc)
+        , bits(1, Block{}, alloc)
+    {}
+
+    // copy using a different allocator
+    PairedBitvector2L(PairedBitvector2L const& other, TAllocator const& alloc)
+        : l0(other.l0, alloc)
+        , l1(other.l1, alloc)
+        , bits(other.bits, alloc)
+        , totalLength{other.totalLength}
+    {}
+
     // constructor accepting view to bools or already compact uint64_t
     template <std::ranges::sized_range range_t>
-    PairedBitvector2L(range_t&& _range) {
+    PairedBitvector2L(range_t&& _range, TAllocator const& alloc = {})
+        : PairedBitvector2L{alloc}
+    {
         auto _size = _range.size();
         if constexpr (std::same_as<std::ranges::range_value_t<range_t>, uint64_t>) {
-            *this = {std::forward<range_t>(_range) | view_as_bitset<l1_bits_ct>};
+            *this = PairedBitvector2L{std::forward<range_t>(_range) | view_as_bitset<l1_bits_ct>, alloc};
             totalLength = _size*64;
         } else if constexpr (std::convertible_to<std::ranges::range_value_t<range_t>, bool>) {
-            *this = {std::forward<range_t>(_range) | view_bool_as_uint64 | view_as_bitset<l1_bits_ct>};
+            *this = PairedBitvector2L{std::forward<range_t>(_range) | view_bool_as_uint64 | view_as_bitset<l1_bits_ct>, alloc};
             totalLength = _size;
         } else {
             []<bool b=false>() {
@@ -63,7 +87,9 @@ struct PairedBitvector2L {
     // the actual constructor, already receiving premade std::bitsets<N>
     template <std::ranges::sized_range range_t>
         requires std::same_as<std::ranges::range_value_t<range_t>, std::bitset<l1_bits_ct>>
-    PairedBitvector2L(range_t&& _range) {
+    PairedBitvector2L(range_t&& _range, TAllocator const& alloc = {})
+        : PairedBitvector2L{alloc}
+    {
         auto _length = static_cast<size_t>(_range.size()*l1_bits_ct);
 
         l0.resize((_length+l0_bits_ct)/(l0_bits_ct*2) + 1);
@@ -176,15 +202,18 @@ struct PairedBitvector2L {
     }
 
     bool symbol(size_t idx) const noexcept {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx < totalLength);
         auto bitId = idx % l1_bits_ct;
         auto l1Id  = idx / l1_bits_ct;
         assert(l1Id < bits.size());
+        stats::readBlock(&bits[l1Id]);
         auto bit = bits[l1Id][bitId];
         return bit;
     }
 
     uint64_t rank(size_t idx) const noexcept {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         auto bitId = idx % (l1_bits_ct*2);
         auto l1Id = idx / l1_bits_ct;
@@ -192,6 +221,9 @@ struct PairedBitvector2L {
         assert(l1Id < bits.size());
         assert(l1Id/2 < l1.size());
         assert(l0Id/2 < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
 
         int64_t right_l1 = (l1Id%2)*2-1;
         int64_t right_l0 = (l0Id%2)*2-1;
@@ -214,6 +246,30 @@ struct PairedBitvector2L {
         return r;
     }
 
+    // heap memory of this bit vector, see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage {
+        auto s   = SpaceUsage{};
+        s.l0     = detail::used_bytes(l0);
+        s.l1     = detail::used_bytes(l1);
+        s.bits   = detail::used_bytes(bits);
+        s.slack  = detail::slack_bytes(l0) + detail::slack_bytes(l1) + detail::slack_bytes(bits);
+        s.tables = detail::skip_table_bytes<l1_bits_ct, TBitset>;
+        return s;
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    auto get_allocator() const -> TAllocator {
+        return TAllocator{l0.get_allocator()};
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("PairedBitvector2L", l1_bits_ct, l0_bits_ct, Align, bulk::bitset_name<TBitset>);
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(l0, l1, totalLength, bits);
@@ -223,4 +279,17 @@ struct PairedBitvector2L {
 template <size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true>
 using PairedBitvector2LShift = PairedBitvector2L<l1_bits_ct, l0_bits_ct, Align, true>;
 
+
+// same as PairedBitvector2L, but the blocks are stored as plain uint64_t words
+template <size_t l1_bits_ct, size_t l0_bits_ct>
+using PairedBitvector2LWord = PairedBitvector2L<l1_bits_ct, l0_bits_ct, true, false, WordBitset>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as PairedBitvector2L, allocating from a std::pmr::memory_resource
+    template <size_t l1_bits_ct, size_t l0_bits_ct>
+    using PairedBitvector2L = seqan::pfb::PairedBitvector2L<l1_bits_ct, l0_bits_ct, true, false, std::bitset, pmr::allocator>;
+}
+#endif
+
 }
@@ -0,0 +1,199 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../TypeTag.h"
+#include "FMIndex.h"
+#include "SuffixArray.h"
+
+#if __has_include(<cereal/types/array.hpp>)
+    #include <cereal/types/array.hpp>
+#endif
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <vector>
+
+namespace seqan::pfb {
+
+/* Interval of a pattern in the forward (lb) and the reverse index (lbRev), both have the same size
+ */
+struct BiSAInterval {
+    uint64_t lb{};
+    uint64_t lbRev{};
+    uint64_t len{};
+
+    auto size() const -> uint64_t {
+        return len;
+    }
+
+    bool empty() const {
+        return len == 0;
+    }
+
+    bool operator==(BiSAInterval const&) const = default;
+};
+
+namespace detail {
+    // ranks and prefix ranks of all symbols, for strings without all_ranks_and_prefix_ranks
+    template <typename String>
+    auto all_ranks_and_prefix_ranks(String const& str, uint64_t idx) {
+        if constexpr (requires() { str.all_ranks_and_prefix_ranks(idx); }) {
+            return str.all_ranks_and_prefix_ranks(idx);
+        } else {
+            auto rs  = std::array<uint64_t, String::Sigma>{};
+            auto prs = std::array<uint64_t, String::Sigma>{};
+            for (size_t s{0}; s < rs.size(); ++s) {
+                rs[s] = str.rank(idx, s);
+            }
+            for (size_t s{1}; s < prs.size(); ++s) {
+                prs[s] = prs[s-1] + rs[s-1];
+            }
+            return std::tuple{rs, prs};
+        }
+    }
+}
+
+/**
+ * BiFMIndex bidirectional FM index (2FM), the BWT of the text and of the reversed text are stored in `String`
+ *
+ * Patterns can be extended to the left and to the right in any order, the intervals in the other
+ * direction are kept up to date with prefix_rank (number of smaller symbols).
+ *   - extend_left/right(interval, symb) uses two rank and two prefix_rank queries
+ *   - extend_left/right_all(interval) extends by all symbols with two all_ranks_and_prefix_ranks queries,
+ *     as needed by approximate search, see SearchScheme.h
+ * The text consists of the symbols 1...Sigma-1, symbol 0 is reserved for the sentinel.
+ */
+template <typename String>
+struct BiFMIndex {
+    static constexpr size_t Sigma = String::Sigma;
+
+    String bwt;
+    String bwtRev;
+    // C[s]: number of symbols in the BWT that are smaller than s (the same for both directions)
+    std::array<uint64_t, Sigma+1> C{};
+
+    BiFMIndex() = default;
+
+    BiFMIndex(std::span<uint8_t const> text)
+        : BiFMIndex{from_bwt, bwt_from_text(text), bwt_from_text(std::vector<uint8_t>(text.rbegin(), text.rend()))}
+    {}
+
+    // BWTs of the text and of the reversed text, see bwt_from_text
+    BiFMIndex(from_bwt_t, std::span<uint8_t const> _bwt, std::span<uint8_t const> _bwtRev)
+        : bwt{_bwt}
+        , bwtRev{_bwtRev}
+    {
+        assert(_bwt.size() == _bwtRev.size());
+        for (auto c : _bwt) {
+            assert(c < Sigma);
+            C[c+1] += 1;
+        }
+        for (size_t i{1}; i < C.size(); ++i) {
+            C[i] += C[i-1];
+        }
+    }
+
+    // number of rows, text length + 1
+    size_t size() const {
+        return bwt.size();
+    }
+
+    // interval of the empty pattern
+    auto all() const -> BiSAInterval {
+        return {0, 0, size()};
+    }
+
+    // interval of `symb + pattern`
+    auto extend_left(BiSAInterval interval, uint8_t symb) const -> BiSAInterval {
+        return extend<false>(interval, symb);
+    }
+
+    // interval of `pattern + symb`
+    auto extend_right(BiSAInterval interval, uint8_t symb) const -> BiSAInterval {
+        return extend<true>(interval, symb);
+    }
+
+    // intervals of all `s + pattern`, entry 0 (the sentinel) is always empty
+    auto extend_left_all(BiSAInterval interval) const -> std::array<BiSAInterval, Sigma> {
+        return extend_all<false>(interval);
+    }
+
+    // intervals of all `pattern + s`, entry 0 (the sentinel) is always empty
+    auto extend_right_all(BiSAInterval interval) const -> std::array<BiSAInterval, Sigma> {
+        return extend_all<true>(interval);
+    }
+
+    // interval of `pattern`, searched from right to left, empty if it contains the sentinel or symbols >= Sigma
+    auto search(std::span<uint8_t const> pattern) const -> BiSAInterval {
+        auto interval = all();
+        for (size_t i{pattern.size()}; i > 0 && !interval.empty(); --i) {
+            auto symb = pattern[i-1];
+            if (symb == 0 || symb >= Sigma) return {};
+            interval = extend_left(interval, symb);
+        }
+        return interval;
+    }
+
+    // number of occurrences of `pattern` in the text
+    auto count(std::span<uint8_t const> pattern) const -> uint64_t {
+        return search(pattern).size();
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("BiFMIndex", bulk::type_tag<String>());
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        ar(bwt, bwtRev, C);
+    }
+
+private:
+    // extending to the right is extending the reversed pattern to the left in the reverse index
+    template <bool Right>
+    auto extend(BiSAInterval interval, uint8_t symb) const -> BiSAInterval {
+        assert(symb > 0 && symb < Sigma);
+        auto const& str = Right ? bwtRev : bwt;
+        auto lb    = Right ? interval.lbRev : interval.lb;
+        auto other = Right ? interval.lb : interval.lbRev;
+        auto ub    = lb + interval.len;
+
+        auto r1 = str.rank(lb, symb);
+        auto r2 = str.rank(ub, symb);
+        auto newOther = other + str.prefix_rank(ub, symb) - str.prefix_rank(lb, symb);
+        if constexpr (Right) {
+            return {newOther, C[symb] + r1, r2 - r1};
+        } else {
+            return {C[symb] + r1, newOther, r2 - r1};
+        }
+    }
+
+    template <bool Right>
+    auto extend_all(BiSAInterval interval) const -> std::array<BiSAInterval, Sigma> {
+        auto const& str = Right ? bwtRev : bwt;
+        auto lb    = Right ? interval.lbRev : interval.lb;
+        auto other = Right ? interval.lb : interval.lbRev;
+
+        auto [rs1, prs1] = detail::all_ranks_and_prefix_ranks(str, lb);
+        auto [rs2, prs2] = detail::all_ranks_and_prefix_ranks(str, lb + interval.len);
+        auto r = std::array<BiSAInterval, Sigma>{};
+        for (size_t s{1}; s < Sigma; ++s) {
+            auto newOther = other + prs2[s] - prs1[s];
+            if constexpr (Right) {
+                r[s] = {newOther, C[s] + rs1[s], rs2[s] - rs1[s]};
+            } else {
+                r[s] = {C[s] + rs1[s], newOther, rs2[s] - rs1[s]};
+            }
+        }
+        return r;
+    }
+};
+
+}
@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../TypeTag.h"
+#include "SuffixArray.h"
+
+#if __has_include(<cereal/types/array.hpp>)
+    #include <cereal/types/array.hpp>
+#endif
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace seqan::pfb {
+
+// half open range [lb, ub) of rows in the suffix array
+struct SAInterval {
+    uint64_t lb{};
+    uint64_t ub{};
+
+    auto size() const -> uint64_t {
+        return ub - lb;
+    }
+
+    bool empty() const {
+        return lb == ub;
+    }
+
+    bool operator==(SAInterval const&) const = default;
+};
+
+// marks constructors that take the BWT (see bwt_from_text) instead of the text
+struct from_bwt_t {};
+inline constexpr from_bwt_t from_bwt{};
+
+/**
+ * FMIndex backward search over a text, the BWT is stored in any string `String` (occurrence table)
+ *
+ * The text consists of the symbols 1...Sigma-1, symbol 0 is reserved for the sentinel.
+ * Patterns are searched from right to left:
+ *   - extend_left(interval, symb) uses two rank queries
+ *   - extend_left_all(interval) extends by all symbols at once with two all_ranks queries,
+ *     for searches that branch over the symbols (e.g. approximate search)
+ */
+template <typename String>
+struct FMIndex {
+    static constexpr size_t Sigma = String::Sigma;
+
+    String bwt;
+    // C[s]: number of symbols in the BWT that are smaller than s
+    std::array<uint64_t, Sigma+1> C{};
+
+    FMIndex() = default;
+
+    FMIndex(std::span<uint8_t const> text)
+        : FMIndex{from_bwt, bwt_from_text(text)}
+    {}
+
+    FMIndex(from_bwt_t, std::span<uint8_t const> _bwt)
+        : bwt{_bwt}
+    {
+        for (auto c : _bwt) {
+            assert(c < Sigma);
+            C[c+1] += 1;
+        }
+        for (size_t i{1}; i < C.size(); ++i) {
+            C[i] += C[i-1];
+        }
+    }
+
+    // number of rows, text length + 1
+    size_t size() const {
+        return bwt.size();
+    }
+
+    // interval of the empty pattern
+    auto all() const -> SAInterval {
+        return {0, size()};
+    }
+
+    // interval of `symb + pattern`, if `interval` belongs to pattern
+    auto extend_left(SAInterval interval, uint8_t symb) const -> SAInterval {
+        assert(symb > 0 && symb < Sigma);
+        return {C[symb] + bwt.rank(interval.lb, symb), C[symb] + bwt.rank(interval.ub, symb)};
+    }
+
+    // intervals of all `s + pattern`, entry 0 (the sentinel) is always empty
+    auto extend_left_all(SAInterval interval) const -> std::array<SAInterval, Sigma> {
+        auto r = std::array<SAInterval, Sigma>{};
+        if constexpr (requires() { bwt.all_ranks(0); }) {
+            auto lbs = bwt.all_ranks(interval.lb);
+            auto ubs = bwt.all_ranks(interval.ub);
+            for (size_t s{1}; s < Sigma; ++s) {
+                r[s] = {C[s] + lbs[s], C[s] + ubs[s]};
+            }
+        } else {
+            for (size_t s{1}; s < Sigma; ++s) {
+                r[s] = extend_left(interval, s);
+            }
+        }
+        return r;
+    }
+
+    // interval of `pattern`, empty if it does not occur, e.g. if it contains the sentinel or symbols >= Sigma
+    auto search(std::span<uint8_t const> pattern) const -> SAInterval {
+        auto interval = all();
+        for (size_t i{pattern.size()}; i > 0 && !interval.empty(); --i) {
+            auto symb = pattern[i-1];
+            if (symb == 0 || symb >= Sigma) return {};
+            interval = extend_left(interval, symb);
+        }
+        return interval;
+    }
+
+    // number of occurrences of `pattern` in the text
+    auto count(std::span<uint8_t const> pattern) const -> uint64_t {
+        return search(pattern).size();
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("FMIndex", bulk::type_tag<String>());
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        ar(bwt, C);
+    }
+};
+
+}
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "BiFMIndex.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Search schemes for approximate search (Hamming distance) with a bidirectional index,
+ * see Kucherov, Salikhov and Tsur, "Approximate string matching using a bidirectional index" (2016)
+ *
+ * The pattern is split into parts of (nearly) equal length. A search visits the parts in the order `pi`,
+ * each part must be adjacent to the parts visited before. After the j-th part, the number of
+ * errors must be within [l[j], u[j]]. A scheme is a set of searches that together find every
+ * occurrence with at most k errors, an occurrence can be reported by more than one search.
+ */
+namespace seqan::pfb {
+
+struct Search {
+    std::vector<size_t> pi;
+    std::vector<size_t> l;
+    std::vector<size_t> u;
+};
+using SearchScheme = std::vector<Search>;
+
+// one part, all errors allowed everywhere
+inline auto backtracking_scheme(size_t k) -> SearchScheme {
+    return {{{0}, {0}, {k}}};
+}
+
+// k+1 parts, one of them is free of errors, one search starting at each part
+inline auto pigeonhole_scheme(size_t k) -> SearchScheme {
+    auto scheme = SearchScheme{};
+    for (size_t i{0}; i <= k; ++i) {
+        auto s = Search{};
+        for (size_t p{i}; p <= k; ++p) s.pi.push_back(p);
+        for (size_t p{i}; p > 0; --p)  s.pi.push_back(p-1);
+        s.l.assign(k+1, 0);
+        s.u.assign(k+1, k);
+        s.u[0] = 0;
+        scheme.push_back(s);
+    }
+    return scheme;
+}
+
+// the schemes of Kucherov et al. for k = 1 and 2 (k+1 parts), pigeonhole for larger k
+inline auto kucherov_scheme(size_t k) -> SearchScheme {
+    switch (k) {
+    case 0: return backtracking_scheme(0);
+    case 1: return {
+        {{0, 1}, {0, 0}, {0, 1}},
+        {{1, 0}, {0, 1}, {0, 1}},
+    };
+    case 2: return {
+        {{0, 1, 2}, {0, 0, 0}, {0, 2, 2}},
+        {{2, 1, 0}, {0, 0, 0}, {0, 1, 2}},
+        {{1, 0, 2}, {0, 0, 1}, {0, 1, 2}},
+    };
+    default: return pigeonhole_scheme(k);
+    }
+}
+
+namespace detail {
+    // one symbol of a search: position in the pattern, direction and error bounds
+    struct SearchStep {
+        size_t pos;
+        bool   right;
+        size_t lo; // only checked at the end of a part
+        size_t up;
+    };
+
+    // the symbols of the pattern in the order they are visited by `search`
+    inline auto search_steps(Search const& search, size_t length) -> std::vector<SearchStep> {
+        auto parts = search.pi.size();
+        auto begin = [&](size_t p) { return p * length / parts; };
+
+        auto steps = std::vector<SearchStep>{};
+        for (size_t j{0}; j < parts; ++j) {
+            auto p = search.pi[j];
+            // the first part is read in the direction of the second part
+            auto right = (j == 0) ? (parts > 1 && search.pi[1] > p) : (p > search.pi[j-1]);
+            auto b = begin(p);
+            auto e = begin(p+1);
+            for (size_t i{b}; i < e; ++i) {
+                auto pos = right ? i : (e - 1 - (i - b));
+                steps.push_back({pos, right, (i+1 == e) ? search.l[j] : 0, search.u[j]});
+            }
+        }
+        return steps;
+    }
+
+    template <typename Index, typename CB>
+    void search_hamming(Index const& index, std::span<uint8_t const> pattern, std::span<SearchStep const> steps, BiSAInterval interval, size_t errors, CB& report) {
+        if (steps.empty()) {
+            report(interval, errors);
+            return;
+        }
+        auto const& step = steps.front();
+        auto symb = pattern[step.pos];
+        // no errors left, a single extension is cheaper than extending by all symbols
+        if (errors == step.up) {
+            // a symbol outside the alphabet can only be matched with a substitution
+            if (errors < step.lo || symb == 0 || symb >= Index::Sigma) return;
+            auto next = step.right ? index.extend_right(interval, symb) : index.extend_left(interval, symb);
+            if (!next.empty()) {
+                search_hamming(index, pattern, steps.subspan(1), next, errors, report);
+            }
+            return;
+        }
+        auto next = step.right ? index.extend_right_all(interval) : index.extend_left_all(interval);
+        for (size_t s{1}; s < next.size(); ++s) {
+            auto e = errors + (s != symb);
+            if (next[s].empty() || e < step.lo) continue;
+            search_hamming(index, pattern, steps.subspan(1), next[s], e, report);
+        }
+    }
+}
+
+/**
+ * Calls `report(interval, errors)` for every interval of strings with at most k substitutions to `pattern`,
+ * k is given by the scheme (see kucherov_scheme). Patterns shorter than the number of parts are searched by backtracking.
+ */
+template <typename Index, typename CB>
+void search_hamming(Index const& index, std::span<uint8_t const> pattern, SearchScheme const& scheme, CB&& report) {
+    assert(!scheme.empty());
+    if (pattern.empty()) {
+        report(index.all(), size_t{0});
+        return;
+    }
+    if (pattern.size() < scheme[0].pi.size()) {
+        size_t k{};
+        for (auto const& search : scheme) {
+            k = std::max(k, search.u.back());
+        }
+        search_hamming(index, pattern, backtracking_scheme(k), report);
+        return;
+    }
+    for (auto const& search : scheme) {
+        auto steps = detail::search_steps(search, pattern.size());
+        detail::search_hamming(index, pattern, std::span<detail::SearchStep const>{steps}, index.all(), 0, report);
+    }
+}
+
+}
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace seqan::pfb {
+
+/**
+ * Suffix array of `text` followed by a sentinel that is smaller than all symbols
+ *
+ * The result has text.size()+1 entries, the first one is the sentinel (text.size()).
+ * Prefix doubling with radix sort, O(n log n) time and 4 words per entry.
+ */
+inline auto suffix_array(std::span<uint8_t const> text) -> std::vector<uint64_t> {
+    auto n     = text.size() + 1;
+    auto sa    = std::vector<uint64_t>(n);
+    auto rank  = std::vector<uint64_t>(n);
+    auto tmp   = std::vector<uint64_t>(n);
+    auto count = std::vector<uint64_t>(std::max<size_t>(n, 257));
+
+    // stable counting sort of `order` by rank, writes into sa
+    size_t classes = 257;
+    auto sortByRank = [&](std::vector<uint64_t> const& order) {
+        std::fill_n(count.begin(), classes, 0);
+        for (auto i : order) {
+            count[rank[i]] += 1;
+        }
+        std::exclusive_scan(count.begin(), count.begin() + classes, count.begin(), uint64_t{0});
+        for (auto i : order) {
+            sa[count[rank[i]]++] = i;
+        }
+    };
+
+    for (size_t i{0}; i < text.size(); ++i) {
+        rank[i] = uint64_t{text[i]} + 1;
+    }
+    rank[n-1] = 0;
+    std::iota(tmp.begin(), tmp.end(), uint64_t{0});
+    sortByRank(tmp);
+
+    // rank of each suffix, equal if `same(a, b)`
+    auto rerank = [&](auto same) {
+        tmp[sa[0]] = 0;
+        for (size_t j{1}; j < n; ++j) {
+            tmp[sa[j]] = tmp[sa[j-1]] + !same(sa[j-1], sa[j]);
+        }
+        classes = tmp[sa[n-1]] + 1;
+        std::swap(rank, tmp);
+    };
+    rerank([&](uint64_t a, uint64_t b) { return rank[a] == rank[b]; });
+
+    // sorted by the first k symbols, sort by the first 2k symbols
+    for (size_t k{1}; classes < n; k *= 2) {
+        // order by the second half, suffixes shorter than k have an empty second half and come first
+        size_t p{0};
+        for (size_t i{n - std::min(k, n)}; i < n; ++i) {
+            tmp[p++] = i;
+        }
+        for (auto j : sa) {
+            if (j >= k) tmp[p++] = j - k;
+        }
+        sortByRank(tmp);
+        rerank([&](uint64_t a, uint64_t b) {
+            if (rank[a] != rank[b]) return false;
+            // the sentinel is unique, so equal first halves have both a second half
+            return rank[a+k] == rank[b+k];
+        });
+    }
+    return sa;
+}
+
+/**
+ * Burrows-Wheeler transform of `text` followed by a sentinel, the sentinel is written as 0
+ *
+ * All symbols of text must be larger than 0.
+ */
+inline auto bwt_from_text(std::span<uint8_t const> text) -> std::vector<uint8_t> {
+    for (auto c : text) {
+        if (c == 0) {
+            throw std::runtime_error{"bwt_from_text: symbol 0 is reserved for the sentinel"};
+        }
+    }
+    auto sa  = suffix_array(text);
+    auto bwt = std::vector<uint8_t>(sa.size());
+    for (size_t i{0}; i < sa.size(); ++i) {
+        bwt[i] = (sa[i] == 0) ? 0 : text[sa[i]-1];
+    }
+    return bwt;
+}
+
+}
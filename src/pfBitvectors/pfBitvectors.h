@@ -3,8 +3,21 @@
 // SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
+#include "BulkArchive.h"
+#include "Placement.h"
+#include "SharedMemory.h"
+#include "bitvectors/AnyBitvector.h"
 #include "bitvectors/Bitvector.h"
+#include "bitvectors/MappedBitvector2L.h"
 #include "bitvectors/PairedBitvector.h"
+#include "fmindex/BiFMIndex.h"
+#include "fmindex/FMIndex.h"
+#include "fmindex/SearchScheme.h"
+#include "strings/AnyString.h"
 #include "strings/FlattenedBitvectors2L.h"
+#include "strings/InterleavedFlattenedBitvectors2L.h"
+#include "strings/MappedFlattenedBitvectors2L.h"
 #include "strings/PairedFlattenedBitvectors2L.h"
 #include "strings/MultiBitvector.h"
+#include "strings/WaveletMatrix.h"
+#include "strings/HuffmanWaveletTree.h"
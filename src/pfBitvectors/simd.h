@@ -0,0 +1,317 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+
+/**
+ * Vectorized in-block kernels for 512 bit blocks with 2 or 3 planes (Sigma 3-8, e.g. DNA).
+ *
+ * Plane selection, the exact/less mask and the masked popcount stay in registers.
+ * The kernels are compiled with function level target attributes, so no extra compile flags are needed.
+ * In such generic builds `simd::level` is detected at startup and can be lowered at runtime (e.g. for benchmarking).
+ * If the library is compiled with `-mavx512f -mavx512vpopcntdq` (or `-mavx2 -mpopcnt`) the kernel is
+ * selected at compile time (`simd::compiled`), it is called directly and `simd::level` is ignored.
+ *
+ * Additionally, a vpternlog backend evaluates the functions of ternarylogic.h on bitsets whose size
+ * is a multiple of 512 bits (Sigma > 8, or larger blocks). It only needs avx512f and is switched by
+ * `simd::ternarylogic_active`, or selected at compile time if the library is compiled with `-mavx512f`.
+ * Define `PFBITVECTORS_NO_SIMD` to disable them.
+ */
+#if !defined(PFBITVECTORS_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define PFBITVECTORS_SIMD 1
+#include <immintrin.h>
+#else
+#define PFBITVECTORS_SIMD 0
+#endif
+
+namespace seqan::pfb::simd {
+
+enum class Level { None, AVX2, AVX512 };
+
+inline Level detectLevel() {
+#if PFBITVECTORS_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+        return Level::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return Level::AVX2;
+    }
+#endif
+    return Level::None;
+}
+
+inline bool detectTernarylogic() {
+#if PFBITVECTORS_SIMD
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#else
+    return false;
+#endif
+}
+
+// active kernel level, may be lowered, but never raised above detectLevel()
+inline Level level = detectLevel();
+
+// kernel level given by the compile flags, Level::None for generic builds
+inline constexpr Level compiled =
+#if PFBITVECTORS_SIMD && defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    Level::AVX512;
+#elif PFBITVECTORS_SIMD && defined(__AVX2__) && defined(__POPCNT__)
+    Level::AVX2;
+#else
+    Level::None;
+#endif
+
+// true if the kernel is selected by `level` on each call
+inline constexpr bool runtime_dispatch = compiled == Level::None;
+
+// true if the kernels below can handle blocks of N bits with bitct planes
+template <size_t N, size_t bitct>
+constexpr bool supported = PFBITVECTORS_SIMD && N == 512 && (bitct == 2 || bitct == 3);
+
+inline bool enabled() {
+    if constexpr (!runtime_dispatch) {
+        return true;
+    } else {
+        return level != Level::None;
+    }
+}
+
+// true if bitsets of N bits can be processed in full 512 bit registers by the vpternlog backend
+template <size_t N>
+constexpr bool supported_ternarylogic = PFBITVECTORS_SIMD && N % 512 == 0;
+
+// vpternlog backend of ternarylogic.h is active, may be disabled, but never enabled without avx512f
+inline bool ternarylogic_active = detectTernarylogic();
+
+// vpternlog backend is given by the compile flags, ternarylogic_active is ignored
+inline constexpr bool ternarylogic_compiled =
+#if PFBITVECTORS_SIMD && defined(__AVX512F__)
+    true;
+#else
+    false;
+#endif
+
+// vpternlog backend, is used by ternarylogic.h
+inline bool ternarylogic_enabled() {
+    if constexpr (ternarylogic_compiled) {
+        return true;
+    } else {
+        return ternarylogic_active;
+    }
+}
+
+namespace detail {
+#if PFBITVECTORS_SIMD
+// gcc reports the intentionally undefined pass-through registers of the avx512 intrinsics
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    static_assert(sizeof(std::bitset<512>) == 64, "std::bitset<512> expected to be stored as 8 words");
+
+    // per 64bit lane: all bits at positions smaller than v
+    __attribute__((target("avx512f")))
+    inline __m512i below_avx512(uint64_t v) {
+        auto laneStart = _mm512_set_epi64(448, 384, 320, 256, 192, 128, 64, 0);
+        auto t = _mm512_sub_epi64(_mm512_set1_epi64(static_cast<int64_t>(v)), laneStart);
+        t = _mm512_min_epi64(_mm512_max_epi64(t, _mm512_setzero_si512()), _mm512_set1_epi64(64));
+        return _mm512_andnot_si512(_mm512_sllv_epi64(_mm512_set1_epi64(-1), t), _mm512_set1_epi64(-1));
+    }
+
+    // same as below_avx512 for half h of the block, shift values are small, clamping 32bit halves is sufficient
+    __attribute__((target("avx2")))
+    inline __m256i below_avx2(uint64_t v, int64_t h) {
+        auto laneStart = _mm256_set_epi64x(192 + h*256, 128 + h*256, 64 + h*256, h*256);
+        auto t = _mm256_sub_epi64(_mm256_set1_epi64x(static_cast<int64_t>(v)), laneStart);
+        t = _mm256_min_epi32(_mm256_max_epi32(t, _mm256_setzero_si256()), _mm256_set1_epi32(64));
+        return _mm256_andnot_si256(_mm256_sllv_epi64(_mm256_set1_epi64x(-1), t), _mm256_set1_epi64x(-1));
+    }
+
+    /* Mask semantics (for a single position with plane bit p, symbol bit s and accumulator a)
+     * exact: a & ~(p ^ s)                   (ternary logic 0x90, starts with all ones)
+     * less:  (~p & s) | (~(p ^ s) & a)      (ternary logic 0xB2, starts with zero)
+     * Planes are processed from the least significant to the most significant bit.
+     */
+    template <bool Exact, size_t bitct, typename T>
+    __attribute__((target("avx512f,avx512vpopcntdq")))
+    inline uint64_t count_avx512(std::array<T, bitct> const& planes, uint64_t symb, uint64_t lo, uint64_t hi) {
+        auto ones = _mm512_set1_epi64(-1);
+        auto acc  = Exact ? ones : _mm512_setzero_si512();
+        for (size_t j{0}; j < bitct; ++j) {
+            auto p = _mm512_loadu_si512(static_cast<void const*>(&planes[j]));
+            auto s = _mm512_set1_epi64(-static_cast<int64_t>((symb >> j) & 1));
+            if constexpr (Exact) {
+                acc = _mm512_ternarylogic_epi64(acc, p, s, 0x90);
+            } else {
+                acc = _mm512_ternarylogic_epi64(acc, p, s, 0xB2);
+            }
+        }
+        if (!Exact && (symb >> bitct)) {
+            acc = ones;
+        }
+
+        // mask positions [lo, hi)
+        auto mask = _mm512_andnot_si512(below_avx512(lo), below_avx512(hi));
+        acc = _mm512_and_si512(acc, mask);
+        return _mm512_reduce_add_epi64(_mm512_popcnt_epi64(acc));
+    }
+
+    template <bool Exact, size_t bitct, typename T>
+    __attribute__((target("avx2,popcnt")))
+    inline uint64_t count_avx2(std::array<T, bitct> const& planes, uint64_t symb, uint64_t lo, uint64_t hi) {
+        auto ones = _mm256_set1_epi64x(-1);
+        __m256i acc[2];
+        acc[0] = acc[1] = Exact ? ones : _mm256_setzero_si256();
+        for (size_t j{0}; j < bitct; ++j) {
+            auto ptr = reinterpret_cast<__m256i const*>(&planes[j]);
+            auto s   = _mm256_set1_epi64x(-static_cast<int64_t>((symb >> j) & 1));
+            for (size_t h{0}; h < 2; ++h) {
+                auto p  = _mm256_loadu_si256(ptr + h);
+                auto eq = _mm256_xor_si256(_mm256_xor_si256(p, s), ones);
+                if constexpr (Exact) {
+                    acc[h] = _mm256_and_si256(acc[h], eq);
+                } else {
+                    acc[h] = _mm256_or_si256(_mm256_andnot_si256(p, s), _mm256_and_si256(eq, acc[h]));
+                }
+            }
+        }
+        if (!Exact && (symb >> bitct)) {
+            acc[0] = acc[1] = ones;
+        }
+
+        // mask positions [lo, hi)
+        alignas(32) std::array<uint64_t, 8> words;
+        for (size_t h{0}; h < 2; ++h) {
+            auto mask = _mm256_andnot_si256(below_avx2(lo, h), below_avx2(hi, h));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(words.data() + h*4), _mm256_and_si256(acc[h], mask));
+        }
+        uint64_t count{};
+        for (auto w : words) {
+            count += _mm_popcnt_u64(w);
+        }
+        return count;
+    }
+
+    template <int R, size_t N>
+    __attribute__((target("avx512f")))
+    inline void ternarylogic_avx512(void const* a, void const* b, void const* c, void* r) {
+        for (size_t i{0}; i < N/512; ++i) {
+            auto va = _mm512_loadu_si512(static_cast<char const*>(a) + i*64);
+            auto vb = _mm512_loadu_si512(static_cast<char const*>(b) + i*64);
+            auto vc = _mm512_loadu_si512(static_cast<char const*>(c) + i*64);
+            _mm512_storeu_si512(static_cast<char*>(r) + i*64, _mm512_ternarylogic_epi64(va, vb, vc, R));
+        }
+    }
+
+    // marks all positions equal to value (Exact), or less/less-or-equal than value (see count_avx512)
+    template <bool Exact, bool OrEqual, typename T, size_t N2>
+    __attribute__((target("avx512f")))
+    inline void mark_avx512(uint64_t value, std::array<T, N2> const& arr, T& r) {
+        for (size_t i{0}; i < sizeof(T)/64; ++i) {
+            auto acc = (Exact || OrEqual) ? _mm512_set1_epi64(-1) : _mm512_setzero_si512();
+            for (size_t j{0}; j < N2; ++j) {
+                auto p = _mm512_loadu_si512(reinterpret_cast<char const*>(&arr[j]) + i*64);
+                auto s = _mm512_set1_epi64(-static_cast<int64_t>((value >> j) & 1));
+                if constexpr (Exact) {
+                    acc = _mm512_ternarylogic_epi64(acc, p, s, 0x90);
+                } else {
+                    acc = _mm512_ternarylogic_epi64(acc, p, s, 0xB2);
+                }
+            }
+            _mm512_storeu_si512(reinterpret_cast<char*>(&r) + i*64, acc);
+        }
+    }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    template <bool Exact, size_t bitct, typename T>
+    uint64_t count(std::array<T, bitct> const& planes, uint64_t symb, uint64_t lo, uint64_t hi) {
+        static_assert(sizeof(T) == 64, "planes must be stored as 512 contiguous bits");
+        assert(lo <= hi && hi <= 512);
+    #if PFBITVECTORS_SIMD
+        if constexpr (compiled == Level::AVX512) {
+            return count_avx512<Exact>(planes, symb, lo, hi);
+        } else if constexpr (compiled == Level::AVX2) {
+            return count_avx2<Exact>(planes, symb, lo, hi);
+        } else {
+            if (level == Level::AVX512) {
+                return count_avx512<Exact>(planes, symb, lo, hi);
+            }
+            assert(level == Level::AVX2);
+            return count_avx2<Exact>(planes, symb, lo, hi);
+        }
+    #else
+        (void)planes; (void)symb; (void)lo; (void)hi;
+        assert(false);
+        return 0;
+    #endif
+    }
+}
+
+/** Counts the positions in [lo, hi) holding exactly symb
+ * Only valid if `supported<512, bitct>` and `enabled()`.
+ * Planes are std::bitset<512> or WordBitset<512>.
+ */
+template <size_t bitct, typename T>
+uint64_t count_exact(std::array<T, bitct> const& planes, uint64_t symb, uint64_t lo, uint64_t hi) {
+    return detail::count<true>(planes, symb, lo, hi);
+}
+
+/** Counts the positions in [lo, hi) holding a value smaller than symb
+ * Only valid if `supported<512, bitct>` and `enabled()`.
+ */
+template <size_t bitct, typename T>
+uint64_t count_less(std::array<T, bitct> const& planes, uint64_t symb, uint64_t lo, uint64_t hi) {
+    return detail::count<false>(planes, symb, lo, hi);
+}
+
+#if PFBITVECTORS_SIMD
+/** Evaluates the three input boolean function R (see ternarylogic_impl) with vpternlog
+ * Only valid if `supported_ternarylogic<N>` and `ternarylogic_enabled()`.
+ * T is std::bitset<N> or WordBitset<N>.
+ */
+template <size_t R, typename T>
+auto ternarylogic(T const& a, T const& b, T const& c) -> T {
+    static_assert(sizeof(T) % 64 == 0);
+    auto r = T{};
+    detail::ternarylogic_avx512<static_cast<int>(R), sizeof(T)*8>(&a, &b, &c, &r);
+    return r;
+}
+
+/** Marks all positions holding exactly value (see mark_exact_large)
+ */
+template <typename T, size_t N2>
+auto mark_exact(uint64_t value, std::array<T, N2> const& arr) -> T {
+    static_assert(sizeof(T) % 64 == 0);
+    auto r = T{};
+    detail::mark_avx512<true, false>(value, arr, r);
+    return r;
+}
+
+/** Marks all positions holding a value smaller or equal to value (see mark_exact_or_less_large)
+ */
+template <typename T, size_t N2>
+auto mark_exact_or_less(uint64_t value, std::array<T, N2> const& arr) -> T {
+    static_assert(sizeof(T) % 64 == 0);
+    auto r = T{};
+    if (value >> N2) {
+        r.set();
+        return r;
+    }
+    detail::mark_avx512<false, true>(value, arr, r);
+    return r;
+}
+#endif
+
+}
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../AnyConfig.h"
+#include "../SpaceUsage.h"
+#include "FlattenedBitvectors2L.h"
+#include "InterleavedFlattenedBitvectors2L.h"
+#include "PairedFlattenedBitvectors2L.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <variant>
+
+namespace seqan::pfb {
+
+/**
+ * AnyStringOf a string whose configuration is chosen at runtime from a fixed set `Configs...` (see Named)
+ *
+ * All configurations must have the same alphabet size.
+ * Single queries dispatch on every call (std::visit). The *_batch functions dispatch once and then
+ * answer all queries with the concrete type, `visit(cb)` hands the concrete type to cb for own query loops.
+ */
+template <typename... Configs>
+struct AnyStringOf {
+    static constexpr size_t Sigma = std::variant_alternative_t<0, std::variant<typename Configs::type...>>::Sigma;
+    static_assert(((Configs::type::Sigma == Sigma) && ...), "all configurations must have the same alphabet size");
+
+    std::variant<typename Configs::type...> str;
+
+    AnyStringOf() = default;
+
+    // builds the configuration named `config`, throws if it is not part of Configs...
+    template <typename range_t>
+    AnyStringOf(std::string_view config, range_t&& _symbols) {
+        detail::emplace_config(str, detail::config_index<Configs...>(config), std::forward<range_t>(_symbols));
+    }
+
+    // names of all configurations
+    static constexpr auto configs() {
+        return std::array<std::string_view, sizeof...(Configs)>{Configs::name...};
+    }
+
+    auto config() const -> std::string_view {
+        return configs()[str.index()];
+    }
+
+    template <typename CB>
+    decltype(auto) visit(CB&& cb) const {
+        return std::visit(std::forward<CB>(cb), str);
+    }
+
+    size_t size() const {
+        return visit([](auto const& v) -> size_t { return v.size(); });
+    }
+
+    uint64_t symbol(uint64_t idx) const {
+        return visit([&](auto const& v) -> uint64_t { return v.symbol(idx); });
+    }
+
+    uint64_t rank(uint64_t idx, uint64_t symb) const {
+        return visit([&](auto const& v) -> uint64_t { return v.rank(idx, symb); });
+    }
+
+    uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+        return visit([&](auto const& v) -> uint64_t { return v.prefix_rank(idx, symb); });
+    }
+
+    auto all_ranks(uint64_t idx) const -> std::array<uint64_t, Sigma> {
+        return visit([&](auto const& v) -> std::array<uint64_t, Sigma> { return v.all_ranks(idx); });
+    }
+
+    // out[i] = symbol(idx[i])
+    void symbol_batch(std::span<uint64_t const> idx, std::span<uint64_t> out) const {
+        assert(out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.symbol(idx[i]);
+            }
+        });
+    }
+
+    // out[i] = rank(idx[i], symb[i])
+    void rank_batch(std::span<uint64_t const> idx, std::span<uint64_t const> symb, std::span<uint64_t> out) const {
+        assert(symb.size() >= idx.size() && out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.rank(idx[i], symb[i]);
+            }
+        });
+    }
+
+    // out[i] = rank(idx[i], symb), the same symbol for all positions
+    void rank_batch(std::span<uint64_t const> idx, uint64_t symb, std::span<uint64_t> out) const {
+        assert(out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.rank(idx[i], symb);
+            }
+        });
+    }
+
+    // out[i] = prefix_rank(idx[i], symb[i])
+    void prefix_rank_batch(std::span<uint64_t const> idx, std::span<uint64_t const> symb, std::span<uint64_t> out) const {
+        assert(symb.size() >= idx.size() && out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.prefix_rank(idx[i], symb[i]);
+            }
+        });
+    }
+
+    // out[i] = all_ranks(idx[i])
+    void all_ranks_batch(std::span<uint64_t const> idx, std::span<std::array<uint64_t, Sigma>> out) const {
+        assert(out.size() >= idx.size());
+        visit([&](auto const& v) {
+            for (size_t i{0}; i < idx.size(); ++i) {
+                out[i] = v.all_ranks(idx[i]);
+            }
+        });
+    }
+
+    auto space_breakdown() const -> SpaceUsage {
+        return visit([](auto const& v) { return v.space_breakdown(); });
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    // the configuration id comes first, loading switches to the saved configuration
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        constexpr auto ids = detail::config_ids<Configs...>();
+        uint64_t id = ids[str.index()];
+        ar(id);
+        if (id != ids[str.index()]) {
+            detail::emplace_config(str, detail::config_index<Configs...>(id));
+        }
+        std::visit([&](auto& v) { ar(v); }, str);
+    }
+};
+
+// precompiled default set
+template <size_t Sigma>
+using AnyString = AnyStringOf<
+    Named<"FlattenedBitvectors2L<64, 65536>",             FlattenedBitvectors2L<Sigma, 64, 65536>>,
+    Named<"FlattenedBitvectors2L<128, 65536>",            FlattenedBitvectors2L<Sigma, 128, 65536>>,
+    Named<"FlattenedBitvectors2L<256, 65536>",            FlattenedBitvectors2L<Sigma, 256, 65536>>,
+    Named<"FlattenedBitvectors2L<512, 65536>",            FlattenedBitvectors2L<Sigma, 512, 65536>>,
+    Named<"FlattenedBitvectors2LWord<512, 65536>",        FlattenedBitvectors2LWord<Sigma, 512, 65536>>,
+    Named<"PairedFlattenedBitvectors2L<256, 65536>",      PairedFlattenedBitvectors2L<Sigma, 256, 65536>>,
+    Named<"PairedFlattenedBitvectors2L<512, 65536>",      PairedFlattenedBitvectors2L<Sigma, 512, 65536>>,
+    Named<"InterleavedFlattenedBitvectors2L<512, 65536>", InterleavedFlattenedBitvectors2L<Sigma, 512, 65536>>
+>;
+
+}
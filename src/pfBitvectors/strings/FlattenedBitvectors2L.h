@@ -3,12 +3,23 @@
 #pragma once
 
 #include "../AlignedBitset.h"
+#include "../Counter.h"
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../Storage.h"
+#include "../TypeTag.h"
+#include "../WordBitset.h"
+#include "../simd.h"
 #include "../ternarylogic.h"
 #include "../utils.h"
 
 #include <bit>
+#include <filesystem>
 #include <limits>
+#include <memory>
 #include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #if __has_include(<cereal/types/array.hpp>) \
@@ -18,30 +29,33 @@
 #endif
 
 namespace seqan::pfb::detail {
-    template <size_t N, size_t bitct>
-    auto rank(std::array<std::bitset<N>, bitct> const& arr, uint64_t symb) {
-        if constexpr (bitct == 3) {
+    // lookup tables (mark_*_fast, mark_exact_all) are only available for std::bitset
+    template <size_t N, template <size_t> typename TBitset>
+    constexpr bool has_lut = std::same_as<TBitset<N>, std::bitset<N>>;
+
+    template <size_t N, size_t bitct, template <size_t> typename TBitset>
+    auto rank(std::array<TBitset<N>, bitct> const& arr, uint64_t symb) {
+        if constexpr (bitct == 3 && has_lut<N, TBitset>) {
             return mark_exact_fast(symb, arr[2], arr[1], arr[0]);
         } else {
             return mark_exact_large(symb, arr);
         }
     }
 
-    template <size_t All, size_t N, size_t bitct>
-    auto rank_all(std::array<std::bitset<N>, bitct> const& arr) {
-        if constexpr (bitct == 3) {
+    template <size_t All, size_t N, size_t bitct, template <size_t> typename TBitset>
+    auto rank_all(std::array<TBitset<N>, bitct> const& arr) {
+        if constexpr (bitct == 3 && has_lut<N, TBitset>) {
             return mark_exact_all(arr[2], arr[1], arr[0]);
         } else {
-            auto const& mask = mask_positive_or_negative<N>;
-            auto res = std::array<std::bitset<N>, All>{};
+            auto res = std::array<TBitset<N>, All>{};
             {
-                auto p = arr[0] ^ mask[0];
+                auto p = ~arr[0];
                 res[0] = p;
                 p = ~p;
                 res[1] = p;
             }
             auto f = [&](size_t j) {
-                auto p = arr[j] ^ mask[1];
+                auto p = arr[j];
                 auto range = (1ull<<j);
                 for (size_t i{0}; i < range; ++i) { //4-5
                     res[range+i] =  p & res[i];
@@ -59,9 +73,9 @@ namespace seqan::pfb::detail {
     }
 
 
-    template <size_t N, size_t bitct>
-    auto prefix_rank(std::array<std::bitset<N>, bitct> const& arr, uint64_t symb) {
-        if constexpr (bitct == 3) {
+    template <size_t N, size_t bitct, template <size_t> typename TBitset>
+    auto prefix_rank(std::array<TBitset<N>, bitct> const& arr, uint64_t symb) {
+        if constexpr (bitct == 3 && has_lut<N, TBitset>) {
             return mark_less_fast(symb, arr[2], arr[1], arr[0]);
         } else {
             return mark_less_large(symb, arr);
@@ -73,22 +87,62 @@ namespace seqan::pfb::detail {
 
 namespace seqan::pfb {
 
+/** Query handle with a symbol fixed at compile time, returned by `bind<Symb>()`
+ */
+template <typename String, uint64_t Symb>
+struct BoundSymbol {
+    static constexpr uint64_t symbol = Symb;
+    String const* str;
+
+    uint64_t rank(uint64_t idx) const {
+        return str->template rank<Symb>(idx);
+    }
+
+    uint64_t prefix_rank(uint64_t idx) const {
+        return str->template prefix_rank<Symb>(idx);
+    }
+};
+
+/** Turns a runtime symbol into a compile-time symbol by switching over the alphabet
+ *  calls `cb.template operator()<symb>()` and returns its result
+ */
+template <size_t Sigma, typename CB>
+auto dispatch_symbol(uint64_t symb, CB&& cb) {
+    assert(symb < Sigma);
+    using R = decltype(cb.template operator()<0>());
+    return [&]<size_t... I>(std::index_sequence<I...>) -> R {
+        if constexpr (std::is_void_v<R>) {
+            (void)((symb == I && (cb.template operator()<I>(), true)) || ...);
+        } else {
+            R r{};
+            (void)((symb == I && (r = cb.template operator()<I>(), true)) || ...);
+            return r;
+        }
+    }(std::make_index_sequence<Sigma>{});
+}
+
 
-template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true>
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TL1=l1_counter_t<l1_bits_ct, l0_bits_ct>, typename TL0=uint64_t, typename TAllocator=std::allocator<std::byte>>
 struct FlattenedBitvectors2L {
     static_assert(l1_bits_ct < l0_bits_ct, "first level must be smaller than second level");
-    static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<uint16_t>::max(), "l0_bits_ct can only hold up to uint16_t bits");
+    static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<TL1>::max(), "TL1 can not hold the counts of a l0 block");
 
     static constexpr size_t Sigma = TSigma;
 
     // number of full length bit vectors needed `2^bitct > TSigma`
     static constexpr auto bitct = std::bit_width(TSigma-1);
+
+    // static tables used by the queries, see SpaceUsage
+    static constexpr size_t table_bytes = detail::lshift_table_bytes<l1_bits_ct, TBitset>
+                                        + detail::skip_table_bytes<l1_bits_ct, TBitset>
+                                        + detail::ternary_table_bytes<l1_bits_ct, TBitset, bitct>;
+
     // next full power of 2
     static constexpr auto bvct  = (1ull << bitct);
 
-    static constexpr auto AlignV = Align?alignAsValue(l1_bits_ct):alignof(std::array<std::bitset<l1_bits_ct>, bitct>);
+    static constexpr auto AlignV = Align?alignAsValue(l1_bits_ct):alignof(std::array<TBitset<l1_bits_ct>, bitct>);
     struct alignas(AlignV) InBits {
-        std::array<std::bitset<l1_bits_ct>, bitct> bits;
+        std::array<TBitset<l1_bits_ct>, bitct> bits;
 
         uint64_t symbol(uint64_t idx) const {
             assert(idx < l1_bits_ct);
@@ -104,17 +158,45 @@ struct FlattenedBitvectors2L {
         uint64_t rank(uint64_t idx, uint64_t symb) const {
             assert(symb < Sigma);
             assert(idx <= l1_bits_ct);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) return simd::count_exact<bitct>(bits, symb, 0, idx);
+            }
             auto v = mark_exact_large(symb, bits);
             return lshift_and_count(v, l1_bits_ct-idx);
         }
 
+        template <uint64_t symb>
+        uint64_t rank(uint64_t idx) const {
+            static_assert(symb < Sigma);
+            assert(idx <= l1_bits_ct);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) return simd::count_exact<bitct>(bits, symb, 0, idx);
+            }
+            auto v = mark_exact_static<symb>(bits);
+            return lshift_and_count(v, l1_bits_ct-idx);
+        }
+
         uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
             assert(symb <= Sigma);
             assert(idx <= l1_bits_ct);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) return simd::count_less<bitct>(bits, symb, 0, idx);
+            }
             auto v = detail::prefix_rank(bits, symb);
             return lshift_and_count(v, l1_bits_ct-idx);
         }
 
+        template <uint64_t symb>
+        uint64_t prefix_rank(uint64_t idx) const {
+            static_assert(symb <= Sigma);
+            assert(idx <= l1_bits_ct);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) return simd::count_less<bitct>(bits, symb, 0, idx);
+            }
+            auto v = mark_less_static<symb>(bits);
+            return lshift_and_count(v, l1_bits_ct-idx);
+        }
+
         auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
             assert(idx <= l1_bits_ct);
 
@@ -149,36 +231,87 @@ struct FlattenedBitvectors2L {
         }
     };
 
-    using BlockL1 = std::array<uint16_t, TSigma+1>;
-    using BlockL0 = std::array<uint64_t, TSigma+1>;
+    // counters per symbol, TL1/TL0 see Counter.h
+    using BlockL1 = std::array<TL1, TSigma+1>;
+    using BlockL0 = std::array<TL0, TSigma+1>;
+
+    using allocator_type = TAllocator;
+
+    // read-only view on a bulk archive, see Storage.h
+    static constexpr bool mapped = is_mapped_storage<TAllocator>;
 
-    std::vector<InBits> bits{{}};
-    std::vector<BlockL1> l1{{}};
-    std::vector<BlockL0> l0{{}};
+    storage_vector<InBits, TAllocator>  bits;
+    storage_vector<BlockL1, TAllocator> l1;
+    storage_vector<BlockL0, TAllocator> l0;
     size_t totalLength{};
+    [[no_unique_address]] storage_keep_alive<TAllocator> file{};
 
-    FlattenedBitvectors2L() = default;
+    // an empty string still has one block, so rank(0, symb) needs no special case
+    FlattenedBitvectors2L() requires (!mapped)
+        : bits(1), l1(1), l0(1)
+    {}
+
+    // an empty view spans a zeroed block as well
+    FlattenedBitvectors2L() requires mapped
+        : bits(empty_section<InBits>()), l1(empty_section<BlockL1>()), l0(empty_section<BlockL0>())
+    {}
 
-    FlattenedBitvectors2L(std::span<uint8_t const> _symbols)
-        : FlattenedBitvectors2L{internal_tag{}, _symbols}
+    FlattenedBitvectors2L(std::span<uint8_t const> _symbols, TAllocator const& alloc = {}) requires (!mapped)
+        : FlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
     {}
 
-    FlattenedBitvectors2L(std::span<uint64_t const> _symbols)
-        : FlattenedBitvectors2L{internal_tag{}, _symbols}
+    FlattenedBitvectors2L(std::span<uint64_t const> _symbols, TAllocator const& alloc = {}) requires (!mapped)
+        : FlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
     {}
 
     template <std::ranges::range range_t>
-        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
-    FlattenedBitvectors2L(range_t&& _symbols)
-        : FlattenedBitvectors2L{internal_tag{}, _symbols}
+        requires (!mapped && std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>)
+    FlattenedBitvectors2L(range_t&& _symbols, TAllocator const& alloc = {})
+        : FlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
     {}
 
+    explicit FlattenedBitvectors2L(TAllocator const& alloc) requires (!mapped)
+        : FlattenedBitvectors2L{internal_tag{}, std::span<uint8_t const>{}, alloc}
+    {}
+
+    // copy using a different allocator
+    FlattenedBitvectors2L(FlattenedBitvectors2L const& other, TAllocator const& alloc) requires (!mapped)
+        : bits(other.bits, alloc)
+        , l1(other.l1, alloc)
+        , l0(other.l0, alloc)
+        , totalLength{other.totalLength}
+    {}
+
+    // maps a file written by saveBinary (MappedStorage only)
+    explicit FlattenedBitvectors2L(std::filesystem::path const& path) requires mapped
+        : FlattenedBitvectors2L{std::make_shared<MappedFile const>(path)}
+    {}
+
+    // view on an already mapped archive (e.g. shared memory, see attachShared), keeps the mapping alive
+    explicit FlattenedBitvectors2L(std::shared_ptr<MappedFile const> _file) requires mapped
+        : FlattenedBitvectors2L{_file->data(), _file->size()}
+    {
+        file = std::move(_file);
+        detail::advise_sections(*file, l0, l1, bits);
+    }
+
+    // view on an archive in memory, the memory must outlive the view
+    FlattenedBitvectors2L(std::byte const* data, size_t size) requires mapped {
+        auto reader = BulkMemoryReader{data, size};
+        bulk::validate_type(reader.typeTag(), bulk_tag(), "FlattenedBitvectors2L");
+        serialize(reader);
+    }
+
 private:
     struct internal_tag{};
 
     template <std::ranges::range range_t>
         requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
-    FlattenedBitvectors2L(internal_tag, range_t&& _symbols) {
+    FlattenedBitvectors2L(internal_tag, range_t&& _symbols, TAllocator const& alloc)
+        : bits(1, InBits{}, alloc)
+        , l1(1, BlockL1{}, alloc)
+        , l0(1, BlockL0{}, alloc)
+    {
 
         if constexpr (requires() { _symbols.size(); }) {
             auto const _length = _symbols.size();
@@ -196,6 +329,8 @@ private:
             }
         }
 
+        check_l0_counter<TL0>(totalLength, "FlattenedBitvectors2L");
+
         // fill l0/l1 structure
         {
             size_t l0BlockCt = (totalLength / l0_bits_ct) + 1;
@@ -248,10 +383,12 @@ public:
     }
 
     uint64_t symbol(uint64_t idx) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx < totalLength);
         auto bitId = idx % l1_bits_ct;
         auto l1Id  = idx / l1_bits_ct;
         assert(l1Id < bits.size());
+        stats::readBlock(&bits[l1Id]);
 
         auto symb = bits[l1Id].symbol(bitId);
         assert(symb < Sigma);
@@ -260,6 +397,7 @@ public:
 public:
 
     uint64_t rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         assert(symb < Sigma);
         auto bitId = idx % (l1_bits_ct);
@@ -267,6 +405,9 @@ public:
         auto l0Id = idx / l0_bits_ct;
         assert(l1Id < bits.size());
         assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
 
         auto count = bits[l1Id].rank(bitId, symb);
 
@@ -276,6 +417,7 @@ public:
     }
 
     uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         assert(symb <= Sigma);
         auto bitId = idx % (l1_bits_ct);
@@ -283,6 +425,9 @@ public:
         auto l0Id = idx / l0_bits_ct;
         assert(l1Id < bits.size());
         assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
 
         size_t r = bits[l1Id].prefix_rank(bitId, symb);
         r += l0[l0Id][symb] + l1[l1Id][symb];
@@ -290,7 +435,54 @@ public:
         return r;
     }
 
+    template <uint64_t symb>
+    uint64_t rank(uint64_t idx) const {
+        static_assert(symb < Sigma);
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto bitId = idx % (l1_bits_ct);
+        auto l1Id = idx / l1_bits_ct;
+        auto l0Id = idx / l0_bits_ct;
+        assert(l1Id < bits.size());
+        assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
+
+        auto count = bits[l1Id].template rank<symb>(bitId);
+
+        auto r =  l0[l0Id][symb+1] + l1[l1Id][symb+1] + count - l0[l0Id][symb] - l1[l1Id][symb];
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    uint64_t prefix_rank(uint64_t idx) const {
+        static_assert(symb <= Sigma);
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto bitId = idx % (l1_bits_ct);
+        auto l1Id = idx / l1_bits_ct;
+        auto l0Id = idx / l0_bits_ct;
+        assert(l1Id < bits.size());
+        assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
+
+        size_t r = bits[l1Id].template prefix_rank<symb>(bitId);
+        r += l0[l0Id][symb] + l1[l1Id][symb];
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    auto bind() const -> BoundSymbol<FlattenedBitvectors2L, symb> {
+        return {this};
+    }
+
     auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+        [[maybe_unused]] auto query = stats::Query{};
         auto r = std::array<uint64_t, TSigma>{};
         for (size_t symb{0}; symb < TSigma; ++symb) {
             r[symb] = rank(idx, symb);
@@ -299,6 +491,7 @@ public:
     }
 
     auto all_ranks_and_prefix_ranks(uint64_t idx) const -> std::tuple<std::array<uint64_t, TSigma>, std::array<uint64_t, TSigma>> {
+        [[maybe_unused]] auto query = stats::Query{};
         auto rs = all_ranks(idx);
         auto prs = std::array<uint64_t, TSigma>{};
         for (size_t i{1}; i < prs.size(); ++i) {
@@ -307,10 +500,55 @@ public:
         return {rs, prs};
     }
 
+    // heap memory of this string (the mapped sections for MappedStorage), see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage {
+        auto s   = SpaceUsage{};
+        s.l0     = detail::used_bytes(l0);
+        s.l1     = detail::used_bytes(l1);
+        s.bits   = detail::used_bytes(bits);
+        s.slack  = detail::slack_bytes(l0) + detail::slack_bytes(l1) + detail::slack_bytes(bits);
+        s.tables = table_bytes;
+        return s;
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    auto get_allocator() const -> TAllocator requires (!mapped) {
+        return TAllocator{bits.get_allocator()};
+    }
+
+    // hint for the bit planes of a view, e.g. Advice::WillNeed to page in the whole index
+    void advise(Advice advice) const requires mapped {
+        if (file) file->advise(bits, advice);
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("FlattenedBitvectors2L", TSigma, l1_bits_ct, l0_bits_ct, Align, bulk::bitset_name<TBitset>, bulk::integral_tag<TL1>, bulk::integral_tag<TL0>);
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(l0, l1, bits, totalLength);
     }
 };
 
+// same as FlattenedBitvectors2L, but the bit planes are stored as plain uint64_t words
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using FlattenedBitvectors2LWord = FlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, WordBitset>;
+
+// same as FlattenedBitvectors2L, with 32bit l0 counters (for less than 2^32 symbols)
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using FlattenedBitvectors2L32 = FlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint32_t>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as FlattenedBitvectors2L, allocating from a std::pmr::memory_resource
+    template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+    using FlattenedBitvectors2L = seqan::pfb::FlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint64_t, pmr::allocator>;
+}
+#endif
+
 }
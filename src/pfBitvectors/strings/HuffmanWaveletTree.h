@@ -0,0 +1,293 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
+#include "../bitvectors/Bitvector.h"
+#include "../bitvectors/PairedBitvector.h"
+#include "../utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if __has_include(<cereal/types/array.hpp>) \
+    && __has_include(<cereal/types/vector.hpp>)
+#include <cereal/types/array.hpp>
+#include <cereal/types/vector.hpp>
+#endif
+
+namespace seqan::pfb {
+
+/**
+ * HuffmanWaveletTree a string with rank support for skewed symbol distributions
+ *
+ * Wavelet tree whose shape follows the symbol frequencies of the text, like an
+ * alphabetic Huffman code: the occurring symbols, in alphabetic order, are split
+ * recursively where both halves carry about the same number of characters.
+ * Frequent symbols sit close to the root, the average rank cost is
+ * proportional to the entropy of the text instead of log Sigma.
+ * Keeping the leaves in alphabetic order lets prefix_rank walk a single
+ * root-to-leaf path.
+ * Symbols that do not occur in the text have no leaf, their rank is always 0.
+ */
+template <size_t TSigma, typename TBitvector = Bitvector<512, 65536>>
+struct HuffmanWaveletTree {
+    static constexpr size_t Sigma = TSigma;
+
+    // child entries with this bit set are leaves, the remaining bits are the symbol
+    static constexpr uint64_t leafBit = uint64_t{1} << 63;
+
+    // one bitvector per inner node, root is node 0 (if it isn't a leaf)
+    std::vector<TBitvector> nodes;
+    std::vector<std::array<uint64_t, 2>> children;
+    // smallest symbol below the right child of each inner node
+    std::vector<uint64_t> splits;
+    // code of each symbol (most significant bit first) and its length
+    std::vector<uint64_t> codes;
+    std::vector<uint8_t> codeLengths;
+    uint64_t root{leafBit};
+    size_t totalLength{};
+
+    HuffmanWaveletTree() = default;
+
+    HuffmanWaveletTree(std::span<uint8_t const> _symbols)
+        : HuffmanWaveletTree{internal_tag{}, _symbols}
+    {}
+
+    HuffmanWaveletTree(std::span<uint64_t const> _symbols)
+        : HuffmanWaveletTree{internal_tag{}, _symbols}
+    {}
+
+    template <std::ranges::range range_t>
+        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
+    HuffmanWaveletTree(range_t&& _symbols)
+        : HuffmanWaveletTree{internal_tag{}, _symbols}
+    {}
+
+private:
+    struct internal_tag{};
+
+    template <std::ranges::range range_t>
+        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
+    HuffmanWaveletTree(internal_tag, range_t&& _symbols) {
+        if constexpr (!std::ranges::forward_range<range_t>) {
+            // text is needed twice, once for counting and once for filling the nodes
+            auto text = std::vector<uint64_t>{};
+            for (auto c : _symbols) {
+                text.push_back(c);
+            }
+            *this = HuffmanWaveletTree{internal_tag{}, text};
+            return;
+        } else {
+            auto counts = std::vector<uint64_t>(Sigma, 0);
+            for (auto c : _symbols) {
+                assert(c < Sigma);
+                counts[c] += 1;
+                totalLength += 1;
+            }
+            codes.resize(Sigma, 0);
+            codeLengths.resize(Sigma, 0);
+            if (totalLength == 0) {
+                return;
+            }
+
+            // occurring symbols in alphabetic order and the prefix sums of their counts
+            auto present = std::vector<uint64_t>{};
+            auto weights = std::vector<uint64_t>{0};
+            for (size_t symb{0}; symb < Sigma; ++symb) {
+                if (counts[symb] > 0) {
+                    present.push_back(symb);
+                    weights.push_back(weights.back() + counts[symb]);
+                }
+            }
+
+            // split present[lo, hi) where both halves have the most similar weight, inner nodes are assigned in preorder
+            auto assign = [&](auto const& self, size_t lo, size_t hi, uint64_t code, size_t depth) -> uint64_t {
+                if (hi - lo == 1) {
+                    if (depth > 64) {
+                        throw std::runtime_error{"HuffmanWaveletTree: code length exceeds 64 bits"};
+                    }
+                    auto symb = present[lo];
+                    codes[symb]       = code;
+                    codeLengths[symb] = depth;
+                    return leafBit | symb;
+                }
+                auto imbalance = [&](size_t mid) {
+                    auto left  = 2 * (weights[mid] - weights[lo]);
+                    auto total = weights[hi] - weights[lo];
+                    return std::max(left, total) - std::min(left, total);
+                };
+                auto mid = lo + 1;
+                for (size_t k{lo + 2}; k < hi; ++k) {
+                    if (imbalance(k) < imbalance(mid)) {
+                        mid = k;
+                    }
+                }
+                auto nodeId = children.size();
+                children.emplace_back();
+                splits.emplace_back(present[mid]);
+                children[nodeId][0] = self(self, lo, mid, code << 1, depth+1);
+                children[nodeId][1] = self(self, mid, hi, (code << 1) | 1, depth+1);
+                return nodeId;
+            };
+            root = assign(assign, 0, present.size(), 0, 0);
+
+            // distribute the text over the inner nodes
+            auto bits = std::vector<std::vector<bool>>(children.size());
+            for (auto c : _symbols) {
+                uint64_t node = root;
+                for (size_t i{codeLengths[c]}; i > 0; --i) {
+                    auto bit = (codes[c] >> (i-1)) & 1;
+                    bits[node].push_back(bit);
+                    node = children[node][bit];
+                }
+            }
+            nodes.reserve(bits.size());
+            for (auto& b : bits) {
+                nodes.emplace_back(TBitvector{b});
+                b = {};
+            }
+        }
+    }
+
+    void all_ranks_impl(uint64_t node, uint64_t idx, std::array<uint64_t, TSigma>& rs) const {
+        if (node & leafBit) {
+            rs[node & ~leafBit] = idx;
+            return;
+        }
+        auto ones = nodes[node].rank(idx);
+        all_ranks_impl(children[node][0], idx - ones, rs);
+        all_ranks_impl(children[node][1], ones, rs);
+    }
+
+public:
+    size_t size() const {
+        return totalLength;
+    }
+
+    // heap memory of all nodes, the tree topology and codes are accounted as other, see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage
+        requires requires(TBitvector const& bv) { { bv.space_breakdown() } -> std::same_as<SpaceUsage>; }
+    {
+        auto s = SpaceUsage{};
+        for (auto const& bv : nodes) {
+            s += bv.space_breakdown();
+        }
+        s.other += detail::used_bytes(nodes) + detail::used_bytes(children) + detail::used_bytes(splits)
+                 + detail::used_bytes(codes) + detail::used_bytes(codeLengths);
+        s.slack += detail::slack_bytes(nodes) + detail::slack_bytes(children) + detail::slack_bytes(splits)
+                 + detail::slack_bytes(codes) + detail::slack_bytes(codeLengths);
+        return s;
+    }
+
+    size_t space_usage() const
+        requires requires(TBitvector const& bv) { { bv.space_breakdown() } -> std::same_as<SpaceUsage>; }
+    {
+        return space_breakdown().total();
+    }
+
+    uint64_t symbol(uint64_t idx) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx < totalLength);
+        auto node = root;
+        while (!(node & leafBit)) {
+            auto bit  = nodes[node].symbol(idx);
+            auto ones = nodes[node].rank(idx);
+            idx  = bit ? ones : idx - ones;
+            node = children[node][bit];
+        }
+        return node & ~leafBit;
+    }
+
+    uint64_t rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        assert(symb < Sigma);
+        if (totalLength == 0) return 0;
+        auto node = root;
+        for (size_t i{codeLengths[symb]}; i > 0; --i) {
+            auto bit  = (codes[symb] >> (i-1)) & 1;
+            auto ones = nodes[node].rank(idx);
+            idx  = bit ? ones : idx - ones;
+            node = children[node][bit];
+        }
+        // symbols without a leaf end up somewhere else
+        if (node != (leafBit | symb)) return 0;
+        return idx;
+    }
+
+    uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        assert(symb <= Sigma);
+        if (totalLength == 0) return 0;
+        // walk towards symb, everything left of the path is smaller
+        uint64_t r{};
+        auto node = root;
+        while (!(node & leafBit)) {
+            auto ones = nodes[node].rank(idx);
+            if (symb < splits[node]) {
+                idx  = idx - ones;
+                node = children[node][0];
+            } else {
+                r   += idx - ones;
+                idx  = ones;
+                node = children[node][1];
+            }
+        }
+        if ((node & ~leafBit) < symb) {
+            r += idx;
+        }
+        return r;
+    }
+
+    auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto rs = std::array<uint64_t, TSigma>{};
+        if (totalLength > 0) {
+            all_ranks_impl(root, idx, rs);
+        }
+        return rs;
+    }
+
+    auto all_ranks_and_prefix_ranks(uint64_t idx) const -> std::tuple<std::array<uint64_t, TSigma>, std::array<uint64_t, TSigma>> {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto rs  = all_ranks(idx);
+        auto prs = std::array<uint64_t, TSigma>{};
+        for (size_t i{1}; i < prs.size(); ++i) {
+            prs[i] = prs[i-1] + rs[i-1];
+        }
+        return {rs, prs};
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("HuffmanWaveletTree", TSigma, bulk::type_tag<TBitvector>());
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        ar(nodes, children, splits, codes, codeLengths, root, totalLength);
+    }
+};
+
+template <size_t TSigma>
+using HuffmanWaveletTreeFixed = HuffmanWaveletTree<TSigma, Bitvector<512, 65536>>;
+
+template <size_t TSigma>
+using HuffmanWaveletTreePaired = HuffmanWaveletTree<TSigma, PairedBitvector<512, 65536>>;
+
+}
@@ -0,0 +1,413 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../Allocator.h"
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
+#include "FlattenedBitvectors2L.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+#if __has_include(<cereal/types/array.hpp>) \
+    && __has_include(<cereal/types/vector.hpp>)
+#include <cereal/types/array.hpp>
+#include <cereal/types/vector.hpp>
+#endif
+
+namespace seqan::pfb {
+
+/**
+ * Same as FlattenedBitvectors2L, but the l1 counters and the bit planes of a block
+ * share one cache line aligned record.
+ *
+ * A record of `record_bits_ct` bits starts with the Sigma-1 in-superblock prefix counts
+ * (count of 0 is always 0, count of Sigma is given by the position of the block)
+ * followed by `bitct` planes of `block_bits` bits each.
+ * If the counters leave no room for a 64bit plane, the record grows by full cache lines.
+ */
+template <size_t TSigma, size_t record_bits_ct, size_t l0_bits_ct, template <size_t> typename TBitset=std::bitset, typename TAllocator=std::allocator<std::byte>>
+struct InterleavedFlattenedBitvectors2L {
+    static constexpr size_t Sigma = TSigma;
+
+    // number of full length bit vectors needed `2^bitct > TSigma`
+    static constexpr auto bitct = std::bit_width(TSigma-1);
+
+    // bits occupied by the l1 counters, rounded up to full words
+    static constexpr size_t ctr_bits = ((TSigma-1) * 16 + 63) / 64 * 64;
+
+    // record size in bits, at least one 64bit word per plane and a multiple of a cache line
+    static constexpr size_t record_bits = std::max(record_bits_ct, (ctr_bits + bitct * 64 + 511) / 512 * 512);
+
+    // number of symbols per record
+    static constexpr size_t block_bits = (record_bits - ctr_bits) / bitct / 64 * 64;
+
+    // number of records per superblock
+    static constexpr size_t l1_block_ct = l0_bits_ct / block_bits;
+    static constexpr size_t superblock_bits = l1_block_ct * block_bits;
+
+    static_assert(record_bits_ct % 512 == 0, "records must be a multiple of a cache line");
+    static_assert(block_bits < l0_bits_ct, "first level must be smaller than second level");
+    static_assert(superblock_bits-block_bits <= std::numeric_limits<uint16_t>::max(), "l0_bits_ct can only hold up to uint16_t bits");
+
+    struct alignas(64) Record {
+        std::array<uint16_t, TSigma-1> l1;
+        std::array<TBitset<block_bits>, bitct> bits;
+
+        // number of symbols smaller than symb in the superblock before this record
+        uint64_t l1Count(uint64_t symb, uint64_t l1Id) const {
+            if (symb == 0) return 0;
+            if (symb == Sigma) return (l1Id % l1_block_ct) * block_bits;
+            return l1[symb-1];
+        }
+
+        uint64_t symbol(uint64_t idx) const {
+            assert(idx < block_bits);
+            uint64_t symb{};
+            for (uint64_t i{bitct}; i > 0; --i) {
+                auto b = bits[i-1].test(idx);
+                symb = (symb<<1) | static_cast<uint64_t>(b);
+            }
+            assert(symb < Sigma);
+            return symb;
+        }
+
+        uint64_t rank(uint64_t idx, uint64_t symb) const {
+            assert(symb < Sigma);
+            assert(idx <= block_bits);
+            auto v = detail::rank(bits, symb);
+            return lshift_and_count(v, block_bits-idx);
+        }
+
+        template <uint64_t symb>
+        uint64_t rank(uint64_t idx) const {
+            static_assert(symb < Sigma);
+            assert(idx <= block_bits);
+            auto v = mark_exact_static<symb>(bits);
+            return lshift_and_count(v, block_bits-idx);
+        }
+
+        uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+            assert(symb <= Sigma);
+            assert(idx <= block_bits);
+            auto v = detail::prefix_rank(bits, symb);
+            return lshift_and_count(v, block_bits-idx);
+        }
+
+        template <uint64_t symb>
+        uint64_t prefix_rank(uint64_t idx) const {
+            static_assert(symb <= Sigma);
+            assert(idx <= block_bits);
+            auto v = mark_less_static<symb>(bits);
+            return lshift_and_count(v, block_bits-idx);
+        }
+
+        auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+            assert(idx <= block_bits);
+
+            auto vs = detail::rank_all<(1ull<<bitct)>(bits);
+            auto v = std::array<uint64_t, TSigma>{};
+            static_assert(v.size() <= vs.size());
+            for (size_t i{0}; i < v.size(); ++i) {
+                v[i] = lshift_and_count(vs[i], block_bits-idx);
+            }
+            return v;
+        }
+
+        void setSymbol(size_t i, uint64_t symb) {
+            assert(i <= block_bits);
+            assert(symb < TSigma);
+            for (size_t j{0}; j < bitct; ++j) {
+                bits[j][i] = (symb>>j) & 1;
+            }
+        }
+
+        template <typename Archive>
+        void load(Archive& ar) {
+            ar(l1);
+            for (auto& v : bits) {
+                loadBV(v, ar);
+            }
+        }
+        template <typename Archive>
+        void save(Archive& ar) const {
+            ar(l1);
+            for (auto const& v : bits) {
+                saveBV(v, ar);
+            }
+        }
+    };
+    static_assert(sizeof(Record)*8 == record_bits, "record does not match the expected size");
+
+    using BlockL0 = std::array<uint64_t, TSigma+1>;
+
+    using allocator_type = TAllocator;
+
+    rebound_vector<Record, TAllocator>  records{{}};
+    rebound_vector<BlockL0, TAllocator> l0{{}};
+    size_t totalLength{};
+
+    InterleavedFlattenedBitvectors2L() = default;
+
+    InterleavedFlattenedBitvectors2L(std::span<uint8_t const> _symbols, TAllocator const& alloc = {})
+        : InterleavedFlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
+    {}
+
+    InterleavedFlattenedBitvectors2L(std::span<uint64_t const> _symbols, TAllocator const& alloc = {})
+        : InterleavedFlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
+    {}
+
+    template <std::ranges::range range_t>
+        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
+    InterleavedFlattenedBitvectors2L(range_t&& _symbols, TAllocator const& alloc = {})
+        : InterleavedFlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
+    {}
+
+    explicit InterleavedFlattenedBitvectors2L(TAllocator const& alloc)
+        : InterleavedFlattenedBitvectors2L{internal_tag{}, std::span<uint8_t const>{}, alloc}
+    {}
+
+    // copy using a different allocator
+    InterleavedFlattenedBitvectors2L(InterleavedFlattenedBitvectors2L const& other, TAllocator const& alloc)
+        : records(other.records, alloc)
+        , l0(other.l0, alloc)
+        , totalLength{other.totalLength}
+    {}
+
+private:
+    struct internal_tag{};
+
+    template <std::ranges::range range_t>
+        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
+    InterleavedFlattenedBitvectors2L(internal_tag, range_t&& _symbols, TAllocator const& alloc)
+        : records(1, Record{}, alloc)
+        , l0(1, BlockL0{}, alloc)
+    {
+
+        if constexpr (requires() { _symbols.size(); }) {
+            auto const _length = _symbols.size();
+            records.reserve(_length/block_bits + 2);
+        }
+
+        // fill all in-block bits
+        for (auto c : _symbols) {
+            auto bitId = totalLength % block_bits;
+            records.back().setSymbol(bitId, c);
+
+            totalLength += 1;
+            if (totalLength % block_bits == 0) { // next bit will require a new record
+                records.emplace_back();
+            }
+        }
+
+        // fill l0/l1 structure
+        {
+            size_t l0BlockCt = (totalLength / superblock_bits) + 1;
+            l0.resize(l0BlockCt);
+            records.resize(l0BlockCt * l1_block_ct);
+
+            BlockL0 l0_acc{};
+            // walk through all superblocks
+            for (size_t l0I{0}; l0I < l0BlockCt; ++l0I) {
+                l0[l0I] = l0_acc;
+
+                BlockL0 acc{};
+                for (size_t i{0}; i < l1_block_ct; ++i) {
+                    auto& r = records[l0I*l1_block_ct + i];
+                    for (size_t symb{1}; symb < TSigma; ++symb) {
+                        r.l1[symb-1] = acc[symb];
+                    }
+
+                    auto counts = r.all_ranks(block_bits);
+
+                    size_t a{};
+                    for (size_t symb{0}; symb < TSigma; ++symb) {
+                        a += counts[symb];
+                        acc[symb+1] += a;
+                    }
+                }
+
+                for (size_t symb{0}; symb <= TSigma; ++symb) {
+                    l0_acc[symb] += acc[symb];
+                }
+            }
+        }
+    }
+public:
+    size_t size() const {
+        return totalLength;
+    }
+
+    uint64_t symbol(uint64_t idx) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx < totalLength);
+        auto bitId = idx % block_bits;
+        auto l1Id  = idx / block_bits;
+        assert(l1Id < records.size());
+        stats::readBlock(&records[l1Id]);
+
+        auto symb = records[l1Id].symbol(bitId);
+        assert(symb < Sigma);
+        return symb;
+    }
+
+    uint64_t rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        assert(symb < Sigma);
+        auto bitId = idx % block_bits;
+        auto l1Id  = idx / block_bits;
+        auto l0Id  = l1Id / l1_block_ct;
+        assert(l1Id < records.size());
+        assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&records[l1Id]);
+
+        auto const& rec = records[l1Id];
+        auto count = rec.rank(bitId, symb);
+
+        auto r = l0[l0Id][symb+1] + rec.l1Count(symb+1, l1Id) + count - l0[l0Id][symb] - rec.l1Count(symb, l1Id);
+        assert(r <= idx);
+        return r;
+    }
+
+    uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        assert(symb <= Sigma);
+        auto bitId = idx % block_bits;
+        auto l1Id  = idx / block_bits;
+        auto l0Id  = l1Id / l1_block_ct;
+        assert(l1Id < records.size());
+        assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&records[l1Id]);
+
+        auto const& rec = records[l1Id];
+        size_t r = rec.prefix_rank(bitId, symb);
+        r += l0[l0Id][symb] + rec.l1Count(symb, l1Id);
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    uint64_t rank(uint64_t idx) const {
+        static_assert(symb < Sigma);
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto bitId = idx % block_bits;
+        auto l1Id  = idx / block_bits;
+        auto l0Id  = l1Id / l1_block_ct;
+        assert(l1Id < records.size());
+        assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&records[l1Id]);
+
+        auto const& rec = records[l1Id];
+        auto count = rec.template rank<symb>(bitId);
+
+        auto r = l0[l0Id][symb+1] + rec.l1Count(symb+1, l1Id) + count - l0[l0Id][symb] - rec.l1Count(symb, l1Id);
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    uint64_t prefix_rank(uint64_t idx) const {
+        static_assert(symb <= Sigma);
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto bitId = idx % block_bits;
+        auto l1Id  = idx / block_bits;
+        auto l0Id  = l1Id / l1_block_ct;
+        assert(l1Id < records.size());
+        assert(l0Id < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&records[l1Id]);
+
+        auto const& rec = records[l1Id];
+        size_t r = rec.template prefix_rank<symb>(bitId);
+        r += l0[l0Id][symb] + rec.l1Count(symb, l1Id);
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    auto bind() const -> BoundSymbol<InterleavedFlattenedBitvectors2L, symb> {
+        return {this};
+    }
+
+    auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+        [[maybe_unused]] auto query = stats::Query{};
+        auto r = std::array<uint64_t, TSigma>{};
+        for (size_t symb{0}; symb < TSigma; ++symb) {
+            r[symb] = rank(idx, symb);
+        }
+        return r;
+    }
+
+    auto all_ranks_and_prefix_ranks(uint64_t idx) const -> std::tuple<std::array<uint64_t, TSigma>, std::array<uint64_t, TSigma>> {
+        [[maybe_unused]] auto query = stats::Query{};
+        auto rs = all_ranks(idx);
+        auto prs = std::array<uint64_t, TSigma>{};
+        for (size_t i{1}; i < prs.size(); ++i) {
+            prs[i] = prs[i-1] + rs[i-1];
+        }
+        return {rs, prs};
+    }
+
+    // heap memory of this string, see SpaceUsage
+    // the l1 counters are stored inside the records
+    auto space_breakdown() const -> SpaceUsage {
+        auto s   = SpaceUsage{};
+        s.l0     = detail::used_bytes(l0);
+        s.l1     = records.size() * sizeof(Record::l1);
+        s.bits   = detail::used_bytes(records) - s.l1;
+        s.slack  = detail::slack_bytes(l0) + detail::slack_bytes(records);
+        s.tables = detail::lshift_table_bytes<block_bits, TBitset>
+                 + detail::ternary_table_bytes<block_bits, TBitset, bitct>;
+        return s;
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    auto get_allocator() const -> TAllocator {
+        return TAllocator{records.get_allocator()};
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("InterleavedFlattenedBitvectors2L", TSigma, record_bits_ct, l0_bits_ct, bulk::bitset_name<TBitset>);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        ar(l0, records, totalLength);
+    }
+};
+
+// same as InterleavedFlattenedBitvectors2L, but the bit planes are stored as plain uint64_t words
+template <size_t TSigma, size_t record_bits_ct, size_t l0_bits_ct>
+using InterleavedFlattenedBitvectors2LWord = InterleavedFlattenedBitvectors2L<TSigma, record_bits_ct, l0_bits_ct, WordBitset>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as InterleavedFlattenedBitvectors2L, allocating from a std::pmr::memory_resource
+    template <size_t TSigma, size_t record_bits_ct, size_t l0_bits_ct>
+    using InterleavedFlattenedBitvectors2L = seqan::pfb::InterleavedFlattenedBitvectors2L<TSigma, record_bits_ct, l0_bits_ct, std::bitset, pmr::allocator>;
+}
+#endif
+
+}
@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../Storage.h"
+#include "FlattenedBitvectors2L.h"
+#include "PairedFlattenedBitvectors2L.h"
+
+/**
+ * Read-only views of FlattenedBitvectors2L and PairedFlattenedBitvectors2L
+ *
+ * The views are the same strings with MappedStorage (see Storage.h), they answer queries directly
+ * on a bulk archive (see saveBinary) that lies in memory, usually a memory mapped file.
+ *
+ * Hints per section: l0 and l1 are small and paged in right away, bits are accessed randomly.
+ */
+namespace seqan::pfb {
+
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TL1=l1_counter_t<l1_bits_ct, l0_bits_ct>, typename TL0=uint64_t>
+using MappedFlattenedBitvectors2L = FlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, Align, TBitset, TL1, TL0, MappedStorage>;
+
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TL1=l1_counter_t<l1_bits_ct, l0_bits_ct>, typename TL0=uint64_t>
+using MappedPairedFlattenedBitvectors2L = PairedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, Align, TBitset, TL1, TL0, MappedStorage>;
+
+// same as MappedFlattenedBitvectors2L, for FlattenedBitvectors2LWord
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedFlattenedBitvectors2LWord = MappedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, WordBitset>;
+
+// same as MappedFlattenedBitvectors2L, for FlattenedBitvectors2L32
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedFlattenedBitvectors2L32 = MappedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint32_t>;
+
+// same as MappedPairedFlattenedBitvectors2L, for PairedFlattenedBitvectors2LWord
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedPairedFlattenedBitvectors2LWord = MappedPairedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, WordBitset>;
+
+// same as MappedPairedFlattenedBitvectors2L, for PairedFlattenedBitvectors2L32
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using MappedPairedFlattenedBitvectors2L32 = MappedPairedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint32_t>;
+
+}
@@ -3,10 +3,14 @@
 // SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
 #include "../bitvectors/Bitvector.h"
 #include "../utils.h"
 
 #include <ranges>
+#include <utility>
 #include <vector>
 
 namespace seqan::pfb {
@@ -28,6 +32,21 @@ struct MultiBitvector {
         }
     }
 
+    // constructs every bit vector with the given allocator (see TAllocator of the bit vectors)
+    template <typename TAllocator>
+        requires requires(TBitvector const& bv) { { bv.get_allocator() } -> std::convertible_to<TAllocator>; }
+    MultiBitvector(std::span<uint8_t const> _symbols, TAllocator const& alloc)
+        : bitvectors{[&]<size_t... I>(std::index_sequence<I...>) {
+            auto mark = [&](size_t sym) {
+                return std::views::iota(size_t{}, _symbols.size())
+                       | std::views::transform([=](size_t idx) {
+                           return _symbols[idx] == sym;
+                       });
+            };
+            return std::array<TBitvector, TSigma>{TBitvector(mark(I), alloc)...};
+        }(std::make_index_sequence<TSigma>{})}
+    {}
+
     void prefetch(uint64_t idx) const {
         if constexpr (requires() { {bitvectors[0].prefetch(idx)}; }) {
             for (auto const& bv : bitvectors) {
@@ -40,7 +59,25 @@ struct MultiBitvector {
         return bitvectors[0].size();
     }
 
+    // heap memory of all bit vectors, see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage
+        requires requires(TBitvector const& bv) { { bv.space_breakdown() } -> std::same_as<SpaceUsage>; }
+    {
+        auto s = SpaceUsage{};
+        for (auto const& bv : bitvectors) {
+            s += bv.space_breakdown();
+        }
+        return s;
+    }
+
+    size_t space_usage() const
+        requires requires(TBitvector const& bv) { { bv.space_breakdown() } -> std::same_as<SpaceUsage>; }
+    {
+        return space_breakdown().total();
+    }
+
     uint8_t symbol(uint64_t idx) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx < size());
         for (size_t sym{0}; sym < Sigma; ++sym) {
             if (bitvectors[sym].symbol(idx)) {
@@ -51,6 +88,7 @@ struct MultiBitvector {
     }
 
     uint64_t rank(uint64_t idx, uint8_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(symb < TSigma);
         assert(idx <= size());
 
@@ -58,6 +96,7 @@ struct MultiBitvector {
     }
 
     uint64_t prefix_rank(uint64_t idx, uint8_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(symb <= TSigma);
         assert(idx <= size());
         size_t a{};
@@ -68,6 +107,7 @@ struct MultiBitvector {
     }
 
     auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= size());
         auto rs = std::array<uint64_t, TSigma>{};
         for (size_t sym{0}; sym < Sigma; ++sym) {
@@ -77,6 +117,7 @@ struct MultiBitvector {
     }
 
     auto all_ranks_and_prefix_ranks(uint64_t idx) const -> std::tuple<std::array<uint64_t, TSigma>, std::array<uint64_t, TSigma>> {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= size());
 
         auto rs  = all_ranks(idx);
@@ -88,6 +129,11 @@ struct MultiBitvector {
     }
 
 
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("MultiBitvector", TSigma, bulk::type_tag<TBitvector>());
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(bitvectors);
@@ -97,6 +143,14 @@ struct MultiBitvector {
 template <size_t TSigma>
 using MultiBitvectorFixed = MultiBitvector<TSigma, Bitvector<512, 65536>>;
 
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as MultiBitvectorFixed, allocating from a std::pmr::memory_resource
+    template <size_t TSigma>
+    using MultiBitvector = seqan::pfb::MultiBitvector<TSigma, pmr::Bitvector2L<512, 65536>>;
+}
+#endif
+
 
 /*template <uint64_t TSigma>
 using MultiBitvector_Bitvector = MultiBitvector<TSigma>;
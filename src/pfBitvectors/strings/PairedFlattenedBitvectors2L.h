@@ -2,12 +2,20 @@
 // SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
+#include "../simd.h"
 #include "../ternarylogic.h"
 #include "../utils.h"
+#include "../Counter.h"
+#include "../Storage.h"
 #include "FlattenedBitvectors2L.h"
 
 #include <bit>
+#include <filesystem>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #if __has_include(<cereal/types/bitset.hpp>)
@@ -18,10 +26,10 @@
 namespace seqan::pfb {
 
 
-template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true>
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct, bool Align=true, template <size_t> typename TBitset=std::bitset, typename TL1=l1_counter_t<l1_bits_ct, l0_bits_ct>, typename TL0=uint64_t, typename TAllocator=std::allocator<std::byte>>
 struct PairedFlattenedBitvectors2L {
     static_assert(l1_bits_ct < l0_bits_ct, "first level must be smaller than second level");
-    static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<uint16_t>::max(), "l0_bits_ct can only hold up to uint16_t bits");
+    static_assert(l0_bits_ct-l1_bits_ct <= std::numeric_limits<TL1>::max(), "TL1 can not hold the counts of a l0 block");
 
     template <size_t TSigma2>
     using String = PairedFlattenedBitvectors2L<TSigma2, l1_bits_ct, l0_bits_ct>;
@@ -30,12 +38,17 @@ struct PairedFlattenedBitvectors2L {
 
     // number of full length bit vectors needed `2^bitct > TSigma`
     static constexpr auto bitct = std::bit_width(TSigma-1);
+
+    // static tables used by the queries, see SpaceUsage
+    static constexpr size_t table_bytes = detail::skip_table_bytes<l1_bits_ct, TBitset>
+                                        + detail::ternary_table_bytes<l1_bits_ct, TBitset, bitct>;
+
     // next full power of 2
     static constexpr auto bvct  = (1ull << bitct);
 
-    static constexpr auto AlignV = Align?alignAsValue(l1_bits_ct):alignof(std::array<std::bitset<l1_bits_ct>, bitct>);
+    static constexpr auto AlignV = Align?alignAsValue(l1_bits_ct):alignof(std::array<TBitset<l1_bits_ct>, bitct>);
     struct alignas(AlignV) InBits {
-        std::array<std::bitset<l1_bits_ct>, bitct> bits;
+        std::array<TBitset<l1_bits_ct>, bitct> bits;
 
         uint64_t symbol(uint64_t idx) const {
             assert(idx < l1_bits_ct);
@@ -51,17 +64,57 @@ struct PairedFlattenedBitvectors2L {
         uint64_t rank(uint64_t idx, uint64_t symb) const {
             assert(idx <= l1_bits_ct*2);
             assert(symb < Sigma);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) {
+                    if (idx <= l1_bits_ct) return simd::count_exact<bitct>(bits, symb, idx, l1_bits_ct);
+                    return simd::count_exact<bitct>(bits, symb, 0, idx - l1_bits_ct);
+                }
+            }
             auto v = detail::rank(bits, symb);
             return skip_first_or_last_n_bits_and_count(v, idx);
         }
 
+        template <uint64_t symb>
+        uint64_t rank(uint64_t idx) const {
+            static_assert(symb < Sigma);
+            assert(idx <= l1_bits_ct*2);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) {
+                    if (idx <= l1_bits_ct) return simd::count_exact<bitct>(bits, symb, idx, l1_bits_ct);
+                    return simd::count_exact<bitct>(bits, symb, 0, idx - l1_bits_ct);
+                }
+            }
+            auto v = mark_exact_static<symb>(bits);
+            return skip_first_or_last_n_bits_and_count(v, idx);
+        }
+
         uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
             assert(idx <= l1_bits_ct*2);
             assert(symb <= Sigma);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) {
+                    if (idx <= l1_bits_ct) return simd::count_less<bitct>(bits, symb, idx, l1_bits_ct);
+                    return simd::count_less<bitct>(bits, symb, 0, idx - l1_bits_ct);
+                }
+            }
             auto v = detail::prefix_rank(bits, symb);
             return skip_first_or_last_n_bits_and_count(v, idx);
         }
 
+        template <uint64_t symb>
+        uint64_t prefix_rank(uint64_t idx) const {
+            static_assert(symb <= Sigma);
+            assert(idx <= l1_bits_ct*2);
+            if constexpr (simd::supported<l1_bits_ct, bitct>) {
+                if (simd::enabled()) {
+                    if (idx <= l1_bits_ct) return simd::count_less<bitct>(bits, symb, idx, l1_bits_ct);
+                    return simd::count_less<bitct>(bits, symb, 0, idx - l1_bits_ct);
+                }
+            }
+            auto v = mark_less_static<symb>(bits);
+            return skip_first_or_last_n_bits_and_count(v, idx);
+        }
+
         auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
             assert(idx <= l1_bits_ct*2);
 
@@ -96,39 +149,105 @@ struct PairedFlattenedBitvectors2L {
         }
     };
 
-    using BlockL1 = std::array<uint16_t, TSigma+1>;
-    using BlockL0 = std::array<uint64_t, TSigma+1>;
+    // counters per symbol, TL1/TL0 see Counter.h
+    using BlockL1 = std::array<TL1, TSigma+1>;
+    using BlockL0 = std::array<TL0, TSigma+1>;
+
+    using allocator_type = TAllocator;
+
+    // read-only view on a bulk archive, see Storage.h
+    static constexpr bool mapped = is_mapped_storage<TAllocator>;
 
-    std::vector<InBits> bits{{}};
-    std::vector<BlockL1> l1{{}};
-    std::vector<BlockL0> l0{{}};
+    storage_vector<InBits, TAllocator>  bits;
+    storage_vector<BlockL1, TAllocator> l1;
+    storage_vector<BlockL0, TAllocator> l0;
     size_t totalLength{};
+    [[no_unique_address]] storage_keep_alive<TAllocator> file{};
+
+    PairedFlattenedBitvectors2L() requires (!mapped)
+        : PairedFlattenedBitvectors2L{internal_tag{}, std::span<uint8_t const>{}, TAllocator{}}
+    {}
 
-    PairedFlattenedBitvectors2L()
-        : PairedFlattenedBitvectors2L{internal_tag{}, std::span<uint8_t const>{}}
+    // an empty view spans the first blocks of an empty owning structure, its zeroed
+    // padding counts as symbol 0 from the center of the l0 block
+    PairedFlattenedBitvectors2L() requires mapped
+        : bits(empty_section<InBits>())
+        , l1([]() -> std::span<BlockL1 const> {
+            static auto const block = empty_block<BlockL1>(l0_bits_ct - l1_bits_ct);
+            return {&block, 1};
+        }())
+        , l0([]() -> std::span<BlockL0 const> {
+            static auto const block = empty_block<BlockL0>(l0_bits_ct);
+            return {&block, 1};
+        }())
     {}
 
-    PairedFlattenedBitvectors2L(std::span<uint8_t const> _symbols)
-        : PairedFlattenedBitvectors2L{internal_tag{}, _symbols}
+    PairedFlattenedBitvectors2L(std::span<uint8_t const> _symbols, TAllocator const& alloc = {}) requires (!mapped)
+        : PairedFlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
     {}
 
-    PairedFlattenedBitvectors2L(std::span<uint64_t const> _symbols)
-        : PairedFlattenedBitvectors2L{internal_tag{}, _symbols}
+    PairedFlattenedBitvectors2L(std::span<uint64_t const> _symbols, TAllocator const& alloc = {}) requires (!mapped)
+        : PairedFlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
     {}
 
     template <std::ranges::range range_t>
-        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
-    PairedFlattenedBitvectors2L(range_t&& _symbols)
-        : PairedFlattenedBitvectors2L{internal_tag{}, _symbols}
+        requires (!mapped && std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>)
+    PairedFlattenedBitvectors2L(range_t&& _symbols, TAllocator const& alloc = {})
+        : PairedFlattenedBitvectors2L{internal_tag{}, _symbols, alloc}
+    {}
+
+    explicit PairedFlattenedBitvectors2L(TAllocator const& alloc) requires (!mapped)
+        : PairedFlattenedBitvectors2L{internal_tag{}, std::span<uint8_t const>{}, alloc}
     {}
 
+    // copy using a different allocator
+    PairedFlattenedBitvectors2L(PairedFlattenedBitvectors2L const& other, TAllocator const& alloc) requires (!mapped)
+        : bits(other.bits, alloc)
+        , l1(other.l1, alloc)
+        , l0(other.l0, alloc)
+        , totalLength{other.totalLength}
+    {}
+
+    // maps a file written by saveBinary (MappedStorage only)
+    explicit PairedFlattenedBitvectors2L(std::filesystem::path const& path) requires mapped
+        : PairedFlattenedBitvectors2L{std::make_shared<MappedFile const>(path)}
+    {}
+
+    // view on an already mapped archive (e.g. shared memory, see attachShared), keeps the mapping alive
+    explicit PairedFlattenedBitvectors2L(std::shared_ptr<MappedFile const> _file) requires mapped
+        : PairedFlattenedBitvectors2L{_file->data(), _file->size()}
+    {
+        file = std::move(_file);
+        detail::advise_sections(*file, l0, l1, bits);
+    }
+
+    // view on an archive in memory, the memory must outlive the view
+    PairedFlattenedBitvectors2L(std::byte const* data, size_t size) requires mapped {
+        auto reader = BulkMemoryReader{data, size};
+        bulk::validate_type(reader.typeTag(), bulk_tag(), "PairedFlattenedBitvectors2L");
+        serialize(reader);
+    }
 
 private:
     struct internal_tag{};
 
+    // prefix counts of a block with `zeros` times symbol 0
+    template <typename Block>
+    static auto empty_block(size_t zeros) -> Block {
+        auto block = Block{};
+        for (size_t symb{1}; symb <= TSigma; ++symb) {
+            block[symb] = zeros;
+        }
+        return block;
+    }
+
     template <std::ranges::range range_t>
         requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
-    PairedFlattenedBitvectors2L(internal_tag, range_t&& _symbols) {
+    PairedFlattenedBitvectors2L(internal_tag, range_t&& _symbols, TAllocator const& alloc)
+        : bits(1, InBits{}, alloc)
+        , l1(1, BlockL1{}, alloc)
+        , l0(1, BlockL0{}, alloc)
+    {
 
         if constexpr (requires() { _symbols.size(); }) {
             auto const _length = _symbols.size();
@@ -146,6 +265,8 @@ private:
             }
         }
 
+        check_l0_counter<TL0>(totalLength, "PairedFlattenedBitvectors2L");
+
         // fill l0/l1 structure
         {
             size_t l0BlockCt = (totalLength / (l0_bits_ct*2)) + 1;
@@ -231,16 +352,19 @@ public:
     }
 
     uint64_t symbol(uint64_t idx) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx < totalLength);
         auto bitId = idx % l1_bits_ct;
         auto l1Id  = idx / l1_bits_ct;
         assert(l1Id < bits.size());
+        stats::readBlock(&bits[l1Id]);
         auto symb = bits[l1Id].symbol(bitId);
         assert(symb < Sigma);
         return symb;
     }
 
     uint64_t rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         assert(symb < Sigma);
         auto bitId = idx % (l1_bits_ct*2);
@@ -249,6 +373,9 @@ public:
         assert(l1Id < bits.size());
         assert(l1Id/2 < l1.size());
         assert(l0Id/2 < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
 
         int64_t right_l1 = (l1Id%2)*2-1;
         int64_t right_l0 = (l0Id%2)*2-1;
@@ -261,6 +388,7 @@ public:
     }
 
     uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         assert(symb <= Sigma);
         auto bitId = idx % (l1_bits_ct*2);
@@ -269,6 +397,9 @@ public:
         assert(l1Id < bits.size());
         assert(l1Id/2 < l1.size());
         assert(l0Id/2 < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
 
         int64_t right_l1 = (l1Id%2)*2-1;
         int64_t right_l0 = (l0Id%2)*2-1;
@@ -279,8 +410,63 @@ public:
         return r;
     }
 
+    template <uint64_t symb>
+    uint64_t rank(uint64_t idx) const {
+        static_assert(symb < Sigma);
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto bitId = idx % (l1_bits_ct*2);
+        auto l1Id = idx / l1_bits_ct;
+        auto l0Id = idx / l0_bits_ct;
+        assert(l1Id < bits.size());
+        assert(l1Id/2 < l1.size());
+        assert(l0Id/2 < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
+
+        int64_t right_l1 = (l1Id%2)*2-1;
+        int64_t right_l0 = (l0Id%2)*2-1;
+
+        auto count = bits[l1Id].template rank<symb>(bitId);
+
+        auto r = (l0[l0Id/2][symb+1] - l0[l0Id/2][symb]) + right_l0 * (l1[l1Id/2][symb+1] - l1[l1Id/2][symb]) + right_l1 * count;
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    uint64_t prefix_rank(uint64_t idx) const {
+        static_assert(symb <= Sigma);
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto bitId = idx % (l1_bits_ct*2);
+        auto l1Id = idx / l1_bits_ct;
+        auto l0Id = idx / l0_bits_ct;
+        assert(l1Id < bits.size());
+        assert(l1Id/2 < l1.size());
+        assert(l0Id/2 < l0.size());
+        stats::readL0();
+        stats::readL1();
+        stats::readBlock(&bits[l1Id]);
+
+        int64_t right_l1 = (l1Id%2)*2-1;
+        int64_t right_l0 = (l0Id%2)*2-1;
+
+        auto count = bits[l1Id].template prefix_rank<symb>(bitId);
+        auto r = l0[l0Id/2][symb] + right_l0 * l1[l1Id/2][symb] + right_l1 * count;
+        assert(r <= idx);
+        return r;
+    }
+
+    template <uint64_t symb>
+    auto bind() const -> BoundSymbol<PairedFlattenedBitvectors2L, symb> {
+        return {this};
+    }
+
 
     auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         auto r = std::array<uint64_t, TSigma>{};
         for (size_t symb{0}; symb < TSigma; ++symb) {
@@ -290,6 +476,7 @@ public:
     }
 
     auto all_ranks_and_prefix_ranks(uint64_t idx) const -> std::tuple<std::array<uint64_t, TSigma>, std::array<uint64_t, TSigma>> {
+        [[maybe_unused]] auto query = stats::Query{};
         assert(idx <= totalLength);
         auto rs = all_ranks(idx);
         auto prs = std::array<uint64_t, TSigma>{};
@@ -299,10 +486,55 @@ public:
         return {rs, prs};
     }
 
+    // heap memory of this string (the mapped sections for MappedStorage), see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage {
+        auto s   = SpaceUsage{};
+        s.l0     = detail::used_bytes(l0);
+        s.l1     = detail::used_bytes(l1);
+        s.bits   = detail::used_bytes(bits);
+        s.slack  = detail::slack_bytes(l0) + detail::slack_bytes(l1) + detail::slack_bytes(bits);
+        s.tables = table_bytes;
+        return s;
+    }
+
+    size_t space_usage() const {
+        return space_breakdown().total();
+    }
+
+    auto get_allocator() const -> TAllocator requires (!mapped) {
+        return TAllocator{bits.get_allocator()};
+    }
+
+    // hint for the bit planes of a view, e.g. Advice::WillNeed to page in the whole index
+    void advise(Advice advice) const requires mapped {
+        if (file) file->advise(bits, advice);
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("PairedFlattenedBitvectors2L", TSigma, l1_bits_ct, l0_bits_ct, Align, bulk::bitset_name<TBitset>, bulk::integral_tag<TL1>, bulk::integral_tag<TL0>);
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(l0, l1, bits, totalLength);
     }
 };
 
+// same as PairedFlattenedBitvectors2L, but the bit planes are stored as plain uint64_t words
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using PairedFlattenedBitvectors2LWord = PairedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, WordBitset>;
+
+// same as PairedFlattenedBitvectors2L, with 32bit l0 counters (for less than 2^32 symbols)
+template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+using PairedFlattenedBitvectors2L32 = PairedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint32_t>;
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr {
+    // same as PairedFlattenedBitvectors2L, allocating from a std::pmr::memory_resource
+    template <size_t TSigma, size_t l1_bits_ct, size_t l0_bits_ct>
+    using PairedFlattenedBitvectors2L = seqan::pfb::PairedFlattenedBitvectors2L<TSigma, l1_bits_ct, l0_bits_ct, true, std::bitset, l1_counter_t<l1_bits_ct, l0_bits_ct>, uint64_t, pmr::allocator>;
+}
+#endif
+
 }
@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: BSD-3-Clause
+#pragma once
+
+#include "../SpaceUsage.h"
+#include "../Stats.h"
+#include "../TypeTag.h"
+#include "../bitvectors/Bitvector.h"
+#include "../bitvectors/PairedBitvector.h"
+#include "../utils.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#if __has_include(<cereal/types/array.hpp>) \
+    && __has_include(<cereal/types/vector.hpp>)
+#include <cereal/types/array.hpp>
+#include <cereal/types/vector.hpp>
+#endif
+
+namespace seqan::pfb {
+
+/**
+ * WaveletMatrix a string with rank support for large alphabets
+ *
+ * Uses one bit vector per bit of the symbol (`bit_width(Sigma-1)` levels). On each level
+ * the symbols are stably partitioned by the current bit, zeros first.
+ * A rank query runs one rank per level, independent of Sigma.
+ */
+template <size_t TSigma, typename TBitvector = Bitvector<512, 65536>>
+struct WaveletMatrix {
+    static constexpr size_t Sigma = TSigma;
+
+    // number of levels needed `2^bitct >= TSigma`
+    static constexpr size_t bitct = std::max<size_t>(1, std::bit_width(TSigma-1));
+
+    std::array<TBitvector, bitct> levels{};
+    // number of zeros on each level
+    std::array<uint64_t, bitct> zeros{};
+    // start position of each symbol after the last level
+    std::vector<uint64_t> starts;
+    size_t totalLength{};
+
+    WaveletMatrix() = default;
+
+    WaveletMatrix(std::span<uint8_t const> _symbols)
+        : WaveletMatrix{internal_tag{}, _symbols}
+    {}
+
+    WaveletMatrix(std::span<uint64_t const> _symbols)
+        : WaveletMatrix{internal_tag{}, _symbols}
+    {}
+
+    template <std::ranges::range range_t>
+        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
+    WaveletMatrix(range_t&& _symbols)
+        : WaveletMatrix{internal_tag{}, _symbols}
+    {}
+
+private:
+    struct internal_tag{};
+
+    template <std::ranges::range range_t>
+        requires std::convertible_to<std::ranges::range_value_t<range_t>, uint64_t>
+    WaveletMatrix(internal_tag, range_t&& _symbols) {
+        auto text = std::vector<uint64_t>{};
+        if constexpr (requires() { _symbols.size(); }) {
+            text.reserve(_symbols.size());
+        }
+        for (auto c : _symbols) {
+            assert(c < Sigma);
+            text.push_back(c);
+        }
+        totalLength = text.size();
+
+        // fill levels, starting with the most significant bit
+        auto next = std::vector<uint64_t>(text.size());
+        auto bits = std::vector<bool>(text.size());
+        for (size_t level{0}; level < bitct; ++level) {
+            auto shift = bitct - level - 1;
+            for (size_t i{0}; i < text.size(); ++i) {
+                bits[i] = (text[i] >> shift) & 1;
+            }
+            levels[level] = TBitvector{bits};
+
+            // stable partition, zeros to the front
+            size_t z{0};
+            for (auto c : text) {
+                z += !((c >> shift) & 1);
+            }
+            zeros[level] = z;
+            size_t zi{0}, oi{z};
+            for (auto c : text) {
+                if ((c >> shift) & 1) next[oi++] = c;
+                else                  next[zi++] = c;
+            }
+            std::swap(text, next);
+        }
+
+        // text is now sorted by the bit reversed symbols
+        starts.resize(Sigma+1);
+        for (size_t symb{0}; symb < Sigma; ++symb) {
+            starts[symb] = forward(0, symb);
+        }
+        starts[Sigma] = totalLength;
+    }
+
+    // follows position idx through all levels, assuming all symbols are equal to symb
+    uint64_t forward(uint64_t idx, uint64_t symb) const {
+        for (size_t level{0}; level < bitct; ++level) {
+            auto ones = levels[level].rank(idx);
+            if ((symb >> (bitct - level - 1)) & 1) {
+                idx = zeros[level] + ones;
+            } else {
+                idx = idx - ones;
+            }
+        }
+        return idx;
+    }
+
+public:
+    size_t size() const {
+        return totalLength;
+    }
+
+    // heap memory of all levels, `starts` is accounted as other, see SpaceUsage
+    auto space_breakdown() const -> SpaceUsage
+        requires requires(TBitvector const& bv) { { bv.space_breakdown() } -> std::same_as<SpaceUsage>; }
+    {
+        auto s = SpaceUsage{};
+        for (auto const& bv : levels) {
+            s += bv.space_breakdown();
+        }
+        s.other += detail::used_bytes(starts);
+        s.slack += detail::slack_bytes(starts);
+        return s;
+    }
+
+    size_t space_usage() const
+        requires requires(TBitvector const& bv) { { bv.space_breakdown() } -> std::same_as<SpaceUsage>; }
+    {
+        return space_breakdown().total();
+    }
+
+    uint64_t symbol(uint64_t idx) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx < totalLength);
+        uint64_t symb{};
+        for (size_t level{0}; level < bitct; ++level) {
+            auto bit = levels[level].symbol(idx);
+            auto ones = levels[level].rank(idx);
+            symb = (symb << 1) | static_cast<uint64_t>(bit);
+            if (bit) {
+                idx = zeros[level] + ones;
+            } else {
+                idx = idx - ones;
+            }
+        }
+        assert(symb < Sigma);
+        return symb;
+    }
+
+    uint64_t rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        assert(symb < Sigma);
+        auto r = forward(idx, symb) - starts[symb];
+        assert(r <= idx);
+        return r;
+    }
+
+    uint64_t prefix_rank(uint64_t idx, uint64_t symb) const {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        assert(symb <= Sigma);
+        if (symb >= (uint64_t{1} << bitct)) {
+            return idx;
+        }
+        // walks down the interval [0, idx), collecting all entries that are smaller
+        uint64_t start{0};
+        uint64_t end{idx};
+        uint64_t r{};
+        for (size_t level{0}; level < bitct; ++level) {
+            auto startOnes = levels[level].rank(start);
+            auto endOnes   = levels[level].rank(end);
+            if ((symb >> (bitct - level - 1)) & 1) {
+                r += (end - endOnes) - (start - startOnes);
+                start = zeros[level] + startOnes;
+                end   = zeros[level] + endOnes;
+            } else {
+                start = start - startOnes;
+                end   = end - endOnes;
+            }
+        }
+        assert(r <= idx);
+        return r;
+    }
+
+    auto all_ranks(uint64_t idx) const -> std::array<uint64_t, TSigma> {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto rs = std::array<uint64_t, TSigma>{};
+        for (size_t symb{0}; symb < Sigma; ++symb) {
+            rs[symb] = rank(idx, symb);
+        }
+        return rs;
+    }
+
+    auto all_ranks_and_prefix_ranks(uint64_t idx) const -> std::tuple<std::array<uint64_t, TSigma>, std::array<uint64_t, TSigma>> {
+        [[maybe_unused]] auto query = stats::Query{};
+        assert(idx <= totalLength);
+        auto rs  = all_ranks(idx);
+        auto prs = std::array<uint64_t, TSigma>{};
+        for (size_t i{1}; i < prs.size(); ++i) {
+            prs[i] = prs[i-1] + rs[i-1];
+        }
+        return {rs, prs};
+    }
+
+    // layout of the serialized members, see bulk::type_tag
+    static constexpr auto bulk_tag() -> uint64_t {
+        return bulk::make_tag("WaveletMatrix", TSigma, bulk::type_tag<TBitvector>());
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar) {
+        ar(levels, zeros, starts, totalLength);
+    }
+};
+
+template <size_t TSigma>
+using WaveletMatrixFixed = WaveletMatrix<TSigma, Bitvector<512, 65536>>;
+
+template <size_t TSigma>
+using WaveletMatrixPaired = WaveletMatrix<TSigma, PairedBitvector<512, 65536>>;
+
+}
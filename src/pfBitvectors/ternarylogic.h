@@ -2,17 +2,28 @@
 //SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
+#include "Stats.h"
+#include "WordBitset.h"
+#include "simd.h"
+
 #include <array>
 #include <bitset>
 #include <cassert>
+#include <concepts>
 #include <cstdint>
 #include <functional>
+#include <utility>
 
 namespace seqan::pfb {
 
 template <size_t R, size_t N, typename T=std::bitset<N>>
 auto ternarylogic_impl(T const& a, T const& b, T const& c) -> T {
     static_assert(0x00 <= R && R <= 0xff);
+#if PFBITVECTORS_SIMD
+    if constexpr (simd::supported_ternarylogic<N> && (std::same_as<T, std::bitset<N>> || std::same_as<T, WordBitset<N>>)) {
+        if (simd::ternarylogic_enabled()) return simd::ternarylogic<R>(a, b, c);
+    }
+#endif
     if constexpr (R == 0x00) return T{};
     if constexpr (R == 0x01) return ~(a | b | c);
     if constexpr (R == 0x02) return c & ~(a | b);
@@ -575,6 +586,7 @@ auto ternarylogic_v2(size_t R, T const& a, T const& b, T const& c) -> T {
 }
 template <size_t N, typename T=std::bitset<N>>
 auto ternarylogic_v3(size_t R, T const& a, T const& b, T const& c) -> T {
+    stats::readTable();
     return lut_ternarylogic2<N, T>[R](a, b, c);
 }
 
@@ -676,6 +688,7 @@ static std::array<T(*)(T const&, T const&, T const&), 8> lut_mark_exact = []() {
 template <size_t N>
 auto mark_exact_v4(size_t value, std::bitset<N> const& _a, std::bitset<N> const& _b, std::bitset<N> const& _c) -> std::bitset<N> {
     assert(value < 8);
+    stats::readTable();
     return lut_mark_exact<N>[value](_a, _b, _c);
 };
 
@@ -699,6 +712,11 @@ static std::array<std::bitset<N>, 2> mask_positive_or_negative = []() {
  */
 template <size_t N1, size_t N2>
 auto mark_exact_large(size_t value, std::array<std::bitset<N1>, N2> const& _arr) -> std::bitset<N1> {
+#if PFBITVECTORS_SIMD
+    if constexpr (simd::supported_ternarylogic<N1>) {
+        if (simd::ternarylogic_enabled()) return simd::mark_exact(value, _arr);
+    }
+#endif
     if constexpr (N2 == 3) {
         return mark_exact_v3(value, _arr[2], _arr[1], _arr[0]);
     } else {
@@ -827,12 +845,14 @@ static std::array<T(*)(T const&, T const&, T const&), 9> lut_mark_less = []() {
 template <size_t N>
 auto mark_exact_or_less_v4(size_t value, std::bitset<N> const& _a, std::bitset<N> const& _b, std::bitset<N> const& _c) -> std::bitset<N> {
     assert(value < 8);
+    stats::readTable();
     return lut_mark_exact_or_less<N>[value](_a, _b, _c);
 };
 
 template <size_t N>
 auto mark_less_v4(size_t value, std::bitset<N> const& _a, std::bitset<N> const& _b, std::bitset<N> const& _c) -> std::bitset<N> {
     assert(value < 9);
+    stats::readTable();
     return lut_mark_less<N>[value](_a, _b, _c);
 };
 
@@ -870,6 +890,11 @@ auto mark_exact_or_less_all(std::bitset<N> const& _a, std::bitset<N> const& _b,
  */
 template <size_t N1, size_t N2>
 auto mark_exact_or_less_large(size_t value, std::array<std::bitset<N1>, N2> const& _arr) -> std::bitset<N1> {
+#if PFBITVECTORS_SIMD
+    if constexpr (simd::supported_ternarylogic<N1>) {
+        if (simd::ternarylogic_enabled()) return simd::mark_exact_or_less(value, _arr);
+    }
+#endif
     if constexpr (N2 == 1) {
         if (!value) return ~_arr[0];
         return mask_positive_or_negative<N1>[0];
@@ -1004,4 +1029,43 @@ auto mark_less_large(size_t value, std::array<std::bitset<N1>, N2> const& _arr)
 
 }
 
+/** Compile-time variant of mark_exact_large, Value is known at compile time
+ *  resolves the ternary logic function without going through lut_mark_exact
+ */
+template <size_t Value, size_t N1, size_t N2, template <size_t> typename TBitset>
+auto mark_exact_static(std::array<TBitset<N1>, N2> const& _arr) -> TBitset<N1> {
+    static_assert(Value < (1ull << N2));
+    if constexpr (N2 == 3) {
+        return ternarylogic_impl<(1ull << Value), N1, TBitset<N1>>(_arr[2], _arr[1], _arr[0]);
+    } else {
+        auto r = ((Value & 1) ? _arr[0] : ~_arr[0]);
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((r &= (((Value >> (I+1)) & 1) ? _arr[I+1] : ~_arr[I+1])), ...);
+        }(std::make_index_sequence<N2-1>{});
+        return r;
+    }
+}
+
+/** Compile-time variant of mark_less_large, Value is known at compile time
+ *  resolves the ternary logic function without going through lut_mark_less
+ */
+template <size_t Value, size_t N1, size_t N2, template <size_t> typename TBitset>
+auto mark_less_static(std::array<TBitset<N1>, N2> const& _arr) -> TBitset<N1> {
+    static_assert(Value <= (1ull << N2));
+    if constexpr (Value == 0) {
+        return TBitset<N1>{};
+    } else if constexpr (Value == (1ull << N2)) {
+        return ~TBitset<N1>{};
+    } else if constexpr (N2 == 3) {
+        return ternarylogic_impl<(1ull << Value) - 1, N1, TBitset<N1>>(_arr[2], _arr[1], _arr[0]);
+    } else {
+        // from least to most significant bit: smaller if this bit is smaller, or equal and the lower bits are smaller
+        auto r = ((Value & 1) ? ~_arr[0] : TBitset<N1>{});
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((r = (((Value >> (I+1)) & 1) ? (~_arr[I+1] | r) : (~_arr[I+1] & r))), ...);
+        }(std::make_index_sequence<N2-1>{});
+        return r;
+    }
+}
+
 }
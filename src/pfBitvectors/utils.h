@@ -2,6 +2,8 @@
 //SPDX-License-Identifier: BSD-3-Clause
 #pragma once
 
+#include "Stats.h"
+
 #include <array>
 #include <bitset>
 #include <cassert>
@@ -48,18 +50,21 @@ std::array<std::bitset<N>, N*2+1> const signed_rightshift_masks = []() {
 
 template <size_t N>
 size_t lshift_and_count(std::bitset<N> const& b, size_t shift) {
+    stats::readTable();
     auto const& mask = leftshift_masks<N>[shift];
     return (b & mask).count();
 }
 
 template <size_t N>
 size_t rshift_and_count(std::bitset<N> const& b, size_t shift) {
+    stats::readTable();
     auto const& mask = rightshift_masks<N>[shift];
     return (b & mask).count();
 }
 
 template <size_t N>
 size_t signed_rshift_and_count(std::bitset<N> const& b, size_t shift) {
+    stats::readTable();
     auto const& mask = signed_rightshift_masks<N>[shift];
     return (b & mask).count();
 }
@@ -106,6 +111,7 @@ std::array<std::bitset<N>, N*2+1> const skip_first_or_last_n_bits_masks = []() {
  */
 template <size_t N>
 size_t skip_first_or_last_n_bits_and_count(std::bitset<N> const& b, size_t idx) {
+    stats::readTable();
     auto const& mask = skip_first_or_last_n_bits_masks<N>[idx];
     return (b & mask).count();
 }
@@ -5,6 +5,7 @@
 #include <pasta/bit_vector/bit_vector.hpp>
 #include <pasta/bit_vector/support/rank.hpp>
 #include <pasta/bit_vector/support/wide_rank.hpp>
+#include <pfBitvectors/SpaceUsage.h>
 
 #include <ranges>
 
@@ -48,8 +49,16 @@ struct WideRank {
         return bv.size();
     }
 
+    // the rank support is accounted as l1
+    auto space_breakdown() const -> SpaceUsage {
+        auto s = SpaceUsage{};
+        s.bits = bv.space_usage();
+        s.l1   = rs.space_usage();
+        return s;
+    }
+
     auto space_usage() const -> size_t {
-        return bv.space_usage() + rs.space_usage();
+        return space_breakdown().total();
     }
 };
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <sdsl/bit_vectors.hpp>
+#include <pfBitvectors/SpaceUsage.h>
 
 namespace seqan::pfb {
 
@@ -45,6 +46,18 @@ struct SDSL_V5 {
         return bv.size();
     }
 
+    // the rank support is accounted as l1
+    auto space_breakdown() const -> SpaceUsage {
+        auto s = SpaceUsage{};
+        s.bits = sdsl::size_in_bytes(bitvector);
+        s.l1   = sdsl::size_in_bytes(bv);
+        return s;
+    }
+
+    auto space_usage() const -> size_t {
+        return space_breakdown().total();
+    }
+
     template <typename Archive>
     void serialize(Archive& ar) {
         ar(bitvector, bv);
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <rank9.h>
+#include <pfBitvectors/SpaceUsage.h>
 
 namespace seqan::pfb {
 
@@ -54,9 +55,18 @@ struct Rank9 {
         return totalSize;
     }
 
+    // the rank9 counts (one 64bit word per 512 bits) are accounted as l1
+    auto space_breakdown() const -> SpaceUsage {
+        auto s  = SpaceUsage{};
+        s.bits  = detail::used_bytes(bitvector);
+        s.slack = detail::slack_bytes(bitvector);
+        //hack, since rank9 is not const correct
+        s.l1    = const_cast<rank9&>(bv).bit_count() / 8;
+        return s;
+    }
+
     auto space_usage() const -> size_t {
-        return 0;
-//        bitvector.size() * 8 + rank9.
+        return space_breakdown().total();
     }
 };
 
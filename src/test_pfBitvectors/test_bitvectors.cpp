@@ -7,6 +7,8 @@
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/tuple.hpp>
 #include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <pfBitvectors/pfBitvectors.h>
 #include <pfBitvectors_externalLibsAdapter/all.h>
 #include <pfBitvectors_test_utils/utils.h>
@@ -37,6 +39,16 @@ using SerializableBitvectors = std::variant<
     seqan::pfb::PairedBitvector< 512, 65536>,
     seqan::pfb::PairedBitvector<1024, 65536>,
     seqan::pfb::PairedBitvector<2048, 65536>,
+    seqan::pfb::Bitvector1LWord< 512>,
+    seqan::pfb::PairedBitvector1LWord< 512>,
+    seqan::pfb::Bitvector2LWord<  64, 65536>,
+    seqan::pfb::Bitvector2LWord< 512, 65536>,
+    seqan::pfb::Bitvector2LWord<2048, 65536>,
+    seqan::pfb::PairedBitvector2LWord<  64, 65536>,
+    seqan::pfb::PairedBitvector2LWord< 512, 65536>,
+    seqan::pfb::PairedBitvector2LWord<2048, 65536>,
+    seqan::pfb::Bitvector2L<  64,   256>, // uint8_t l1 counters
+    seqan::pfb::Bitvector2L32< 512, 65536>,
     std::monostate /*delimiter, is ignored*/
 >;
 
@@ -461,4 +473,452 @@ TEST_CASE("check bit vectors are working", "[bitvector]") {
             }
         }, SerializableBitvectors{});
     }
+
+    SECTION("bulk serialization/deserialization") {
+        call_with_templates([&]<typename Vector>() {
+            auto vector_name = getName<Vector>();
+            INFO(vector_name);
+
+            srand(0);
+            auto input = std::vector<uint8_t>{};
+            for (size_t i{}; i < 200'000; ++i) {
+                input.push_back(rand()%2);
+            }
+            auto check = [&](Vector const& vec) {
+                REQUIRE(input.size() == vec.size());
+                size_t count{};
+                for (size_t i{0}; i != input.size(); ++i) {
+                    CHECK((bool)input[i] == vec.symbol(i));
+                    CHECK(count == vec.rank(i));
+                    count += input[i];
+                }
+                CHECK(count == vec.rank(input.size()));
+            };
+
+            // via stream
+            {
+                auto ss = std::stringstream{};
+                seqan::pfb::saveBinary(Vector{input}, ss);
+                auto vec = Vector{};
+                seqan::pfb::loadBinary(vec, ss);
+                check(vec);
+            }
+            // via file, using small chunks and multiple threads
+            {
+                auto path = std::filesystem::temp_directory_path() / "pfBitvectors_test_bulk.bin";
+                seqan::pfb::saveBinary(Vector{input}, path, 3, 4096);
+                auto vec = Vector{};
+                seqan::pfb::loadBinary(vec, path, 3, 4096);
+                std::filesystem::remove(path);
+                check(vec);
+            }
+        }, SerializableBitvectors{});
+    }
+}
+
+TEST_CASE("check word storage produces the same archives as std::bitset storage", "[bitvector][word]") {
+    srand(0);
+    auto input = std::vector<uint8_t>{};
+    for (size_t i{}; i < 100'000; ++i) {
+        input.push_back(rand()%2);
+    }
+
+    auto save = [](auto const& vec) {
+        auto ss = std::stringstream{};
+        auto archive = cereal::BinaryOutputArchive{ss};
+        archive(vec);
+        return ss.str();
+    };
+
+    auto bitsetArchive = save(seqan::pfb::Bitvector2L<512, 65536>{input});
+    CHECK(bitsetArchive == save(seqan::pfb::Bitvector2LWord<512, 65536>{input}));
+
+    // archives can be loaded by either storage
+    auto ss = std::stringstream{bitsetArchive};
+    auto vec = seqan::pfb::Bitvector2LWord<512, 65536>{};
+    {
+        auto archive = cereal::BinaryInputArchive{ss};
+        archive(vec);
+    }
+    REQUIRE(vec.size() == input.size());
+    size_t count{};
+    for (size_t i{0}; i != input.size(); ++i) {
+        CHECK((bool)input[i] == vec.symbol(i));
+        CHECK(count == vec.rank(i));
+        count += input[i];
+    }
+    CHECK(count == vec.rank(input.size()));
+}
+
+TEST_CASE("check bulk archives reject foreign or broken input", "[bitvector][bulk]") {
+    auto input = std::vector<uint8_t>(10'000, 1);
+    auto ss = std::stringstream{};
+    seqan::pfb::saveBinary(seqan::pfb::Bitvector<512, 65536>{input}, ss);
+    auto archive = ss.str();
+
+    SECTION("wrong magic") {
+        auto broken = archive;
+        broken[0] = 'X';
+        auto is = std::stringstream{broken};
+        auto vec = seqan::pfb::Bitvector<512, 65536>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(vec, is), std::runtime_error);
+    }
+    SECTION("truncated") {
+        auto is = std::stringstream{archive.substr(0, archive.size()/2)};
+        auto vec = seqan::pfb::Bitvector<512, 65536>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(vec, is), std::runtime_error);
+    }
+    SECTION("corrupt element count") {
+        auto nested = std::vector<std::vector<uint64_t>>{{1, 2}, {3}};
+        auto out = seqan::pfb::BulkOutputArchive{};
+        out(nested);
+        auto os = std::stringstream{};
+        out.write(os);
+        // the count of the outer vector follows the header
+        auto broken = os.str();
+        auto count  = uint64_t{1} << 60;
+        std::memcpy(broken.data() + sizeof(seqan::pfb::bulk::Header), &count, sizeof(count));
+        auto is = std::stringstream{broken};
+        auto in = seqan::pfb::BulkInputArchive{is};
+        auto loaded = std::vector<std::vector<uint64_t>>{};
+        CHECK_THROWS_AS(in(loaded), std::runtime_error);
+    }
+    SECTION("different type") {
+        auto is = std::stringstream{archive};
+        auto vec = seqan::pfb::Bitvector<1024, 65536>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(vec, is), std::runtime_error);
+    }
+    SECTION("different l0 block size, same element sizes") {
+        auto is = std::stringstream{archive};
+        auto vec = seqan::pfb::Bitvector2L<512, 4096>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(vec, is), std::runtime_error);
+    }
+    SECTION("different storage or counter type") {
+        auto is = std::stringstream{archive};
+        auto word = seqan::pfb::Bitvector2LWord<512, 65536>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(word, is), std::runtime_error);
+        is = std::stringstream{archive};
+        auto narrow = seqan::pfb::Bitvector2L32<512, 65536>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(narrow, is), std::runtime_error);
+    }
+    SECTION("mapped view of a different type") {
+        auto path = std::filesystem::temp_directory_path() / "pfBitvectors_test_bulk_type.bin";
+        seqan::pfb::saveBinary(seqan::pfb::Bitvector<512, 65536>{input}, path);
+        CHECK_THROWS_AS((seqan::pfb::MappedBitvector<512, 4096>{path}), std::runtime_error);
+        CHECK_NOTHROW((seqan::pfb::MappedBitvector<512, 65536>{path}));
+        std::filesystem::remove(path);
+    }
+}
+
+TEST_CASE("check mapped and shared bit vectors", "[bitvector][mmap]") {
+    srand(0);
+    auto input = std::vector<uint8_t>{};
+    for (size_t i{0}; i < 300'000; ++i) {
+        input.push_back(rand()%2);
+    }
+
+    auto test = [&]<typename Vector, typename View>() {
+        INFO(getName<Vector>());
+        auto expected = Vector{input};
+        auto check = [&](View const& view) {
+            REQUIRE(view.size() == input.size());
+            for (size_t i{0}; i < input.size(); i += 7) {
+                CHECK(view.symbol(i) == expected.symbol(i));
+                CHECK(view.rank(i) == expected.rank(i));
+            }
+            CHECK(view.rank(input.size()) == expected.rank(input.size()));
+        };
+
+        // a default constructed view is empty, but can be queried like an empty bit vector
+        {
+            auto view = View{};
+            CHECK(view.size() == 0);
+            CHECK(view.rank(0) == 0);
+        }
+
+        // mapped file
+        {
+            auto path = std::filesystem::temp_directory_path() / "pfBitvectors_test_mmap.bin";
+            seqan::pfb::saveBinary(expected, path);
+            check(View{path});
+            std::filesystem::remove(path);
+        }
+        #if PFBITVECTORS_SHM
+        // shared memory
+        {
+            auto name = "/pfBitvectors_test_shm_" + std::to_string(::getpid());
+            auto view = View{};
+            {
+                auto owner = seqan::pfb::publishShared(expected, name);
+                CHECK_THROWS_AS(seqan::pfb::publishShared(expected, name), std::runtime_error);
+                view = View{seqan::pfb::attachShared(name)};
+            }
+            // the name is removed, but the mapping stays valid
+            CHECK_THROWS_AS(seqan::pfb::attachShared(name), std::runtime_error);
+            check(view);
+        }
+        #endif
+    };
+    test.template operator()<seqan::pfb::Bitvector<512, 65536>,      seqan::pfb::MappedBitvector<512, 65536>>();
+    test.template operator()<seqan::pfb::Bitvector<64, 4096>,        seqan::pfb::MappedBitvector<64, 4096>>();
+    test.template operator()<seqan::pfb::Bitvector2LWord<512, 65536>, seqan::pfb::MappedBitvector2LWord<512, 65536>>();
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("check bit vectors with std::pmr allocators", "[bitvector][allocator]") {
+    srand(0);
+    auto input = std::vector<uint8_t>{};
+    for (size_t i{0}; i < 100'000; ++i) {
+        input.push_back(rand()%2);
+    }
+
+    // any allocation not going through the given resource throws
+    struct DefaultGuard {
+        std::pmr::memory_resource* old = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        ~DefaultGuard() { std::pmr::set_default_resource(old); }
+    };
+
+    auto test = [&]<typename Vector, typename Expected>() {
+        INFO(getName<Vector>());
+        auto expected = Expected{input};
+        auto pool = std::pmr::unsynchronized_pool_resource{std::pmr::new_delete_resource()};
+        auto alloc = seqan::pfb::pmr::allocator{&pool};
+
+        auto check = [&](Vector const& vec) {
+            CHECK(vec.get_allocator() == alloc);
+            REQUIRE(vec.size() == input.size());
+            for (size_t i{0}; i < input.size(); i += 3) {
+                CHECK(vec.symbol(i) == expected.symbol(i));
+                CHECK(vec.rank(i) == expected.rank(i));
+            }
+            CHECK(vec.rank(input.size()) == expected.rank(input.size()));
+        };
+
+        auto ss = std::stringstream{};
+        {
+            auto guard = DefaultGuard{};
+            auto vec = Vector{input, alloc};
+            check(vec);
+            check(Vector{vec, alloc});
+            seqan::pfb::saveBinary(vec, ss);
+        }
+        auto archive = ss.str();
+        {
+            auto guard = DefaultGuard{};
+            auto vec = Vector{alloc};
+            auto is = std::stringstream{archive};
+            seqan::pfb::loadBinary(vec, is);
+            check(vec);
+        }
+    };
+    test.template operator()<seqan::pfb::pmr::Bitvector1L<512>,              seqan::pfb::Bitvector1L<512>>();
+    test.template operator()<seqan::pfb::pmr::Bitvector2L<512, 65536>,       seqan::pfb::Bitvector2L<512, 65536>>();
+    test.template operator()<seqan::pfb::pmr::PairedBitvector1L<512>,        seqan::pfb::PairedBitvector1L<512>>();
+    test.template operator()<seqan::pfb::pmr::PairedBitvector2L<512, 65536>, seqan::pfb::PairedBitvector2L<512, 65536>>();
+}
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("check bit vectors placed in huge pages and per NUMA node", "[bitvector][placement]") {
+    srand(0);
+    auto input = std::vector<uint8_t>{};
+    for (size_t i{0}; i < 10'000'000; ++i) {
+        input.push_back(rand()%2);
+    }
+    using Vector = seqan::pfb::pmr::Bitvector2L<512, 65536>;
+    auto expected = seqan::pfb::Bitvector2L<512, 65536>{input};
+
+    auto check = [&](Vector const& vec) {
+        REQUIRE(vec.size() == input.size());
+        for (size_t i{0}; i <= input.size(); i += 31) {
+            CHECK(vec.rank(i) == expected.rank(i));
+        }
+    };
+
+    SECTION("huge pages") {
+        auto vec = Vector{input, seqan::pfb::pmr::allocator{seqan::pfb::hugePageResource()}};
+        check(vec);
+        // large arrays start at a huge page boundary
+        REQUIRE(vec.bits.size() * sizeof(vec.bits[0]) >= seqan::pfb::HugePageResource::hugePageSize / 2);
+        CHECK(reinterpret_cast<uintptr_t>(vec.bits.data()) % seqan::pfb::HugePageResource::hugePageSize == 0);
+        // the process wide resource is not bound to a node
+        CHECK_FALSE(seqan::pfb::hugePageResource()->bound());
+    }
+
+    SECTION("replicated per NUMA node") {
+        auto& topology = seqan::pfb::NumaTopology::get();
+        REQUIRE(topology.nodes() >= 1);
+        REQUIRE(topology.ids.size() == topology.nodes());
+        CHECK(topology.currentNode() < topology.nodes());
+
+        auto replicas = seqan::pfb::NumaReplicated<Vector>{Vector{input}};
+        REQUIRE(replicas.nodes() == topology.nodes());
+        for (size_t node{0}; node < replicas.nodes(); ++node) {
+            check(replicas.replica(node));
+        }
+        check(replicas.local());
+        CHECK(replicas.rank(input.size()) == expected.rank(input.size()));
+    }
+
+    SECTION("replicated with a given topology") {
+        // two nodes with the same cpus, every cpu belongs to the second one
+        auto const& system = seqan::pfb::NumaTopology::get();
+        auto topology = seqan::pfb::NumaTopology{};
+        topology.ids       = {system.ids[0], system.ids[0]};
+        topology.cpus      = {system.cpus[0], system.cpus[0]};
+        topology.nodeOfCpu = std::vector<size_t>(system.nodeOfCpu.size(), 1);
+
+        auto replicas = seqan::pfb::NumaReplicated<Vector>{Vector{input}, topology};
+        REQUIRE(replicas.nodes() == 2);
+        CHECK(&replicas.local() == &replicas.replica(1));
+        check(replicas.local());
+    }
+}
+#endif
+
+TEST_CASE("check counter types of bit vectors", "[bitvector][counter]") {
+    static_assert(std::same_as<seqan::pfb::l1_counter_t<  64,   256>, uint8_t>);
+    static_assert(std::same_as<seqan::pfb::l1_counter_t< 512,  4096>, uint16_t>);
+    static_assert(std::same_as<seqan::pfb::l1_counter_t< 512, 65536>, uint16_t>);
+    static_assert(std::same_as<seqan::pfb::l1_counter_t<2048, 1ull<<20>, uint32_t>);
+
+    auto test = [&]<typename Vector>() {
+        INFO(getName<Vector>());
+        // full l0 blocks do not fit into the l1 counter type
+        auto text = std::vector<uint8_t>(100'000, 1);
+        auto vec1 = Vector{text};
+        auto vec2 = Vector{};
+        for (auto c : text) {
+            vec2.push_back(c);
+        }
+        for (size_t i{0}; i <= text.size(); ++i) {
+            CHECK(vec1.rank(i) == i);
+            CHECK(vec2.rank(i) == i);
+        }
+    };
+    test.template operator()<seqan::pfb::Bitvector2L<64, 256>>();
+    test.template operator()<seqan::pfb::Bitvector2L<512, 65536>>();
+    test.template operator()<seqan::pfb::Bitvector2L32<512, 65536>>();
+
+    SECTION("too long for the l0 counter type") {
+        using Vector = seqan::pfb::Bitvector2L<64, 256, false, true, std::bitset, uint8_t, uint16_t>;
+        CHECK_NOTHROW(Vector{std::vector<uint8_t>(60'000, 1)});
+        CHECK_THROWS_AS(Vector{std::vector<uint8_t>(70'000, 1)}, std::length_error);
+
+        // the last block is padded to 64 bits, only the real length counts
+        auto text = std::vector<uint8_t>(65'535, 1);
+        auto vec  = Vector{text};
+        CHECK(vec.rank(text.size()) == text.size());
+        CHECK_THROWS_AS(Vector{std::vector<uint8_t>(65'536, 1)}, std::length_error);
+    }
+
+    SECTION("runtime choice of the l0 counter type") {
+        auto width = [](size_t length) {
+            return seqan::pfb::dispatch_l0_counter(length, []<typename TL0>() { return sizeof(TL0); });
+        };
+        CHECK(width(1'000) == 4);
+        CHECK(width(std::numeric_limits<uint32_t>::max()) == 4);
+        CHECK(width(size_t{1} << 32) == 8);
+    }
+}
+
+TEST_CASE("check space usage of bit vectors", "[bitvector][space]") {
+    auto text = std::vector<uint8_t>(100'000);
+    for (size_t i{0}; i < text.size(); ++i) {
+        text[i] = (i % 3) == 0;
+    }
+
+    call_with_templates([&]<typename Vector>() {
+        INFO(getName<Vector>());
+        auto vec = Vector{text};
+        auto s = vec.space_breakdown();
+        CHECK(s.total() == vec.space_usage());
+        CHECK(s.bits * 8 >= text.size());
+        CHECK(s.l0 + s.l1 > 0);
+        CHECK(s.other == 0);
+    }, SerializableBitvectors{});
+
+    SECTION("tables are shared, they are only counted once") {
+        auto a = seqan::pfb::SpaceUsage{.l0 = 1, .l1 = 2, .bits = 3, .tables = 4, .slack = 5, .other = 6};
+        auto b = a + a;
+        CHECK(b.l0 == 2);
+        CHECK(b.bits == 6);
+        CHECK(b.tables == 4);
+        CHECK(b.total() == 2 * a.total() - 4);
+    }
+}
+
+TEST_CASE("check runtime selected bit vectors", "[bitvector][any]") {
+    srand(0);
+    auto input = std::vector<uint8_t>{};
+    for (size_t i{0}; i < 100'000; ++i) {
+        input.push_back(rand()%2);
+    }
+    auto positions = std::vector<uint64_t>{};
+    for (size_t i{0}; i <= input.size(); i += 7) {
+        positions.push_back(i);
+    }
+
+    for (auto config : seqan::pfb::AnyBitvector::configs()) {
+        INFO(config);
+        auto vec = seqan::pfb::AnyBitvector{config, input};
+        CHECK(vec.config() == config);
+        REQUIRE(vec.size() == input.size());
+        CHECK(vec.space_usage() == vec.space_breakdown().total());
+
+        auto ranks = std::vector<uint64_t>(positions.size());
+        vec.rank_batch(positions, ranks);
+        auto symbols = std::vector<uint64_t>(positions.size() - 1);
+        vec.symbol_batch(std::span{positions}.first(symbols.size()), symbols);
+
+        size_t count{};
+        for (size_t i{0}, j{0}; i <= input.size(); ++i) {
+            if (i < input.size()) {
+                CHECK((bool)input[i] == vec.symbol(i));
+            }
+            CHECK(count == vec.rank(i));
+            if (j < positions.size() && positions[j] == i) {
+                CHECK(count == ranks[j]);
+                if (j < symbols.size()) {
+                    CHECK(input[i] == symbols[j]);
+                }
+                ++j;
+            }
+            if (i < input.size()) {
+                count += input[i];
+            }
+        }
+
+        // archives remember the configuration
+        auto ss = std::stringstream{};
+        {
+            auto archive = cereal::BinaryOutputArchive{ss};
+            archive(vec);
+        }
+        auto loaded = seqan::pfb::AnyBitvector{};
+        {
+            auto archive = cereal::BinaryInputArchive{ss};
+            archive(loaded);
+        }
+        CHECK(loaded.config() == config);
+        auto bulk = std::stringstream{};
+        seqan::pfb::saveBinary(vec, bulk);
+        auto bulkLoaded = seqan::pfb::AnyBitvector{};
+        seqan::pfb::loadBinary(bulkLoaded, bulk);
+        CHECK(bulkLoaded.config() == config);
+        for (size_t i{0}; i <= input.size(); i += 13) {
+            CHECK(loaded.rank(i) == vec.rank(i));
+            CHECK(bulkLoaded.rank(i) == vec.rank(i));
+        }
+    }
+
+    SECTION("unknown configurations are rejected") {
+        CHECK_THROWS_AS((seqan::pfb::AnyBitvector{"Bitvector2L<3, 7>", input}), std::runtime_error);
+
+        using Other = seqan::pfb::AnyBitvectorOf<seqan::pfb::Named<"other", seqan::pfb::Bitvector2L<512, 4096>>>;
+        auto ss = std::stringstream{};
+        seqan::pfb::saveBinary(Other{"other", input}, ss);
+        auto vec = seqan::pfb::AnyBitvector{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(vec, ss), std::runtime_error);
+    }
 }
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2025 Knut Reinert & Freie Universität Berlin
+// SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
+// SPDX-License-Identifier: CC0-1.0
+
+// compiled as its own executable with PFBITVECTORS_STATS=1
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <pfBitvectors/pfBitvectors.h>
+#include <thread>
+#include <vector>
+
+static_assert(seqan::pfb::stats::enabled, "test_stats must be compiled with PFBITVECTORS_STATS=1");
+
+TEST_CASE("check query instrumentation of bit vectors", "[bitvector][stats]") {
+    auto text = std::vector<uint8_t>(10'000);
+    for (size_t i{0}; i < text.size(); ++i) {
+        text[i] = (i % 3) == 0;
+    }
+
+    SECTION("sequential rank queries") {
+        auto vec = seqan::pfb::Bitvector2L<512, 65536>{text};
+        seqan::pfb::stats::reset();
+        for (size_t i{0}; i <= text.size(); ++i) {
+            CHECK(vec.rank(i) == (i+2) / 3);
+        }
+        auto c = seqan::pfb::stats::local();
+        auto n = text.size() + 1;
+        CHECK(c.queries == n);
+        CHECK(c.l0 == n);
+        CHECK(c.l1 == n);
+        CHECK(c.blocks == n);
+        CHECK(c.tables == n);
+        // every block is read 512 times in a row
+        auto blockCt = text.size() / 512 + 1;
+        CHECK(c.coldBlocks == blockCt);
+        CHECK(c.reuse[0] == n - blockCt);
+        CHECK(std::abs(c.reuseBelow(0) - double(n - blockCt) / n) < 1e-9);
+    }
+
+    SECTION("one level bit vectors do not read l1 counters") {
+        auto vec = seqan::pfb::Bitvector1L<512>{text};
+        seqan::pfb::stats::reset();
+        for (size_t i{0}; i < text.size(); ++i) {
+            CHECK(vec.symbol(i) == text[i]);
+        }
+        auto c = seqan::pfb::stats::local();
+        CHECK(c.queries == text.size());
+        CHECK(c.l0 == 0);
+        CHECK(c.l1 == 0);
+        CHECK(c.blocks == text.size());
+    }
+
+    SECTION("alternating between two blocks") {
+        auto vec = seqan::pfb::Bitvector2L<512, 65536>{text};
+        seqan::pfb::stats::reset();
+        for (size_t i{0}; i < 100; ++i) {
+            (void)vec.rank(i % 2 == 0 ? 0 : 5000);
+        }
+        auto c = seqan::pfb::stats::local();
+        CHECK(c.coldBlocks == 2);
+        CHECK(c.reuse[1] == 98); // one other block read in between
+    }
+
+    SECTION("counters of multiple threads are merged") {
+        auto vec = seqan::pfb::Bitvector2L<512, 65536>{text};
+        seqan::pfb::stats::reset();
+        auto threads = std::vector<std::thread>{};
+        for (size_t t{0}; t < 4; ++t) {
+            threads.emplace_back([&]() {
+                for (size_t i{0}; i < 1000; ++i) {
+                    (void)vec.rank(i);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        // exited threads keep their counts
+        auto c = seqan::pfb::stats::collect();
+        CHECK(c.queries == 4000);
+        CHECK(c.blocks == 4000);
+        CHECK(seqan::pfb::stats::local().queries == 0);
+    }
+}
+
+TEST_CASE("check query instrumentation of strings", "[string][stats]") {
+    auto text = std::vector<uint8_t>(10'000);
+    for (size_t i{0}; i < text.size(); ++i) {
+        text[i] = i % 5;
+    }
+
+    SECTION("nested queries are counted once") {
+        auto str = seqan::pfb::FlattenedBitvectors2L<5, 512, 65536>{text};
+        seqan::pfb::stats::reset();
+        auto rs = str.all_ranks(1234);
+        CHECK(rs[0] == 247);
+        auto c = seqan::pfb::stats::local();
+        CHECK(c.queries == 1);
+        CHECK(c.l0 == 5);
+        CHECK(c.l1 == 5);
+        CHECK(c.blocks == 5);
+        CHECK(c.coldBlocks == 1);
+    }
+
+    SECTION("composite strings count the blocks of their bit vectors") {
+        auto str = seqan::pfb::WaveletMatrix<5>{text};
+        seqan::pfb::stats::reset();
+        CHECK(str.rank(1234, 3) == 247);
+        auto c = seqan::pfb::stats::local();
+        CHECK(c.queries == 1);
+        CHECK(c.blocks == str.bitct);
+    }
+}
@@ -2,9 +2,12 @@
 // SPDX-FileCopyrightText: 2025 Knut Reinert & MPI für molekulare Genetik
 // SPDX-License-Identifier: CC0-1.0
 
+#include <algorithm>
 #include <catch2/catch_all.hpp>
 #include <cereal/archives/binary.hpp>
 #include <cstdlib>
+#include <filesystem>
+#include <numeric>
 #include <pfBitvectors/pfBitvectors.h>
 #include <pfBitvectors_externalLibsAdapter/all.h>
 #include <pfBitvectors_test_utils/utils.h>
@@ -28,7 +31,23 @@ using AllStrings = Variant<
     Instance<seqan::pfb::PairedFlattenedBitvectors2L,  512, 65536>::Type,
     Instance<seqan::pfb::PairedFlattenedBitvectors2L, 1024, 65536>::Type,
     Instance<seqan::pfb::PairedFlattenedBitvectors2L, 2048, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,  512, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L, 1024, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2L, 2048, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2LWord,              64, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2LWord,             512, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2LWord,            2048, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2LWord,       512, 65536>::Type,
+    Instance<seqan::pfb::InterleavedFlattenedBitvectors2LWord,  512, 65536>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L,          64,   256>::Type, // uint8_t l1 counters
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L,    64,   256>::Type,
+    Instance<seqan::pfb::FlattenedBitvectors2L32,       512, 65536>::Type,
+    Instance<seqan::pfb::PairedFlattenedBitvectors2L32, 512, 65536>::Type,
     seqan::pfb::MultiBitvectorFixed,
+    seqan::pfb::WaveletMatrixFixed,
+    seqan::pfb::WaveletMatrixPaired,
+    seqan::pfb::HuffmanWaveletTreeFixed,
+    seqan::pfb::HuffmanWaveletTreePaired,
 #ifdef PFBITVECTORS_USE_SDSL
     seqan::pfb::Sdsl_wt_bldc,
     seqan::pfb::Sdsl_wt_epr,
@@ -446,3 +465,750 @@ TEST_CASE("check symbol vectors construction on text longer than 255 characters"
         }, AllStrings{});
     }
 }
+
+TEST_CASE("check simd kernels against the portable implementation", "[string][simd]") {
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<0, Sigma>(10'000);
+
+        auto detected = seqan::pfb::simd::level;
+        auto levels = std::vector<seqan::pfb::simd::Level>{seqan::pfb::simd::Level::None};
+        if (detected >= seqan::pfb::simd::Level::AVX2)   levels.push_back(seqan::pfb::simd::Level::AVX2);
+        if (detected >= seqan::pfb::simd::Level::AVX512) levels.push_back(seqan::pfb::simd::Level::AVX512);
+        if constexpr (!seqan::pfb::simd::runtime_dispatch) {
+            // the kernel is selected by the compile flags, simd::level has no effect
+            levels = {seqan::pfb::simd::compiled};
+        }
+
+        auto flattened = seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>{text};
+        auto paired    = seqan::pfb::PairedFlattenedBitvectors2L<Sigma, 512, 65536>{text};
+        auto word      = seqan::pfb::FlattenedBitvectors2LWord<Sigma, 512, 65536>{text};
+
+        for (auto level : levels) {
+            INFO("level " << static_cast<int>(level));
+            seqan::pfb::simd::level = level;
+            auto rs = std::array<size_t, Sigma+1>{};
+            for (size_t idx{0}; idx <= text.size(); ++idx) {
+                if (idx > 0) {
+                    rs[text[idx-1]] += 1;
+                }
+                size_t prs{};
+                for (size_t symb{0}; symb <= Sigma; ++symb) {
+                    INFO(idx);
+                    INFO(symb);
+                    if (symb < Sigma) {
+                        CHECK(flattened.rank(idx, symb) == rs[symb]);
+                        CHECK(paired.rank(idx, symb) == rs[symb]);
+                        CHECK(word.rank(idx, symb) == rs[symb]);
+                    }
+                    CHECK(flattened.prefix_rank(idx, symb) == prs);
+                    CHECK(paired.prefix_rank(idx, symb) == prs);
+                    CHECK(word.prefix_rank(idx, symb) == prs);
+                    prs += rs[symb];
+                }
+            }
+        }
+        seqan::pfb::simd::level = detected;
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<3>();
+        testSigma.operator()<4>();
+        testSigma.operator()<5>();
+        testSigma.operator()<8>();
+    }
+}
+
+TEST_CASE("check vpternlog backend against the portable implementation", "[string][ternlog]") {
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<0, Sigma>(20'000);
+
+        auto detected = seqan::pfb::simd::ternarylogic_active;
+        auto backends = std::vector<bool>{false};
+        if (detected) backends.push_back(true);
+        if constexpr (seqan::pfb::simd::ternarylogic_compiled) {
+            // the backend is selected by the compile flags, simd::ternarylogic_active has no effect
+            backends = {true};
+        }
+
+        auto flattened512  = seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>{text};
+        auto flattened1024 = seqan::pfb::FlattenedBitvectors2L<Sigma, 1024, 65536>{text};
+        auto paired        = seqan::pfb::PairedFlattenedBitvectors2L<Sigma, 512, 65536>{text};
+        auto word          = seqan::pfb::FlattenedBitvectors2LWord<Sigma, 1024, 65536>{text};
+
+        for (auto active : backends) {
+            INFO("vpternlog " << active);
+            seqan::pfb::simd::ternarylogic_active = active;
+            auto rs = std::array<size_t, Sigma+1>{};
+            for (size_t idx{0}; idx <= text.size(); ++idx) {
+                if (idx > 0) {
+                    rs[text[idx-1]] += 1;
+                }
+                if (idx % 7 != 0) continue;
+                size_t prs{};
+                for (size_t symb{0}; symb <= Sigma; ++symb) {
+                    INFO(idx);
+                    INFO(symb);
+                    if (symb < Sigma) {
+                        CHECK(flattened512.rank(idx, symb) == rs[symb]);
+                        CHECK(flattened1024.rank(idx, symb) == rs[symb]);
+                        CHECK(paired.rank(idx, symb) == rs[symb]);
+                        CHECK(word.rank(idx, symb) == rs[symb]);
+                    }
+                    CHECK(flattened512.prefix_rank(idx, symb) == prs);
+                    CHECK(flattened1024.prefix_rank(idx, symb) == prs);
+                    CHECK(paired.prefix_rank(idx, symb) == prs);
+                    CHECK(word.prefix_rank(idx, symb) == prs);
+                    prs += rs[symb];
+                }
+            }
+        }
+        seqan::pfb::simd::ternarylogic_active = detected;
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<16>();
+        testSigma.operator()<21>();
+        testSigma.operator()<255>();
+    }
+}
+
+TEST_CASE("check compile-time symbol rank against runtime symbol rank", "[string][static]") {
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<0, Sigma>(200'000);
+
+        using StaticStrings = Variant<
+            Instance<seqan::pfb::FlattenedBitvectors2L,             64, 65536>::Type,
+            Instance<seqan::pfb::FlattenedBitvectors2L,            512, 65536>::Type,
+            Instance<seqan::pfb::PairedFlattenedBitvectors2L,       64, 65536>::Type,
+            Instance<seqan::pfb::PairedFlattenedBitvectors2L,      512, 65536>::Type,
+            Instance<seqan::pfb::InterleavedFlattenedBitvectors2L, 512, 65536>::Type,
+            Instance<seqan::pfb::FlattenedBitvectors2LWord,        512, 65536>::Type,
+            Delimiter /*delimiter, is ignored*/
+        >;
+
+        call_with_templates([&]<template <size_t> typename _String>() {
+            using String = _String<Sigma>;
+            INFO(getName<String>());
+
+            auto vec = String{text};
+            for (size_t idx{0}; idx <= text.size(); idx += 97) {
+                for (size_t symb{0}; symb <= Sigma; ++symb) {
+                    INFO(idx);
+                    INFO(symb);
+                    if (symb < Sigma) {
+                        auto r = seqan::pfb::dispatch_symbol<Sigma>(symb, [&]<size_t Symb>() {
+                            CHECK(vec.template bind<Symb>().rank(idx) == vec.rank(idx, Symb));
+                            return vec.template rank<Symb>(idx);
+                        });
+                        CHECK(r == vec.rank(idx, symb));
+                    }
+                    auto pr = seqan::pfb::dispatch_symbol<Sigma+1>(symb, [&]<size_t Symb>() {
+                        return vec.template prefix_rank<Symb>(idx);
+                    });
+                    CHECK(pr == vec.prefix_rank(idx, symb));
+                }
+            }
+        }, StaticStrings{});
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<4>();
+        testSigma.operator()<5>();
+        testSigma.operator()<16>();
+        testSigma.operator()<21>();
+    }
+}
+
+TEST_CASE("check bulk serialization of strings", "[string][bulk]") {
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<0, Sigma>(100'000);
+
+        using BulkStrings = Variant<
+            Instance<seqan::pfb::FlattenedBitvectors2L,                  64, 65536>::Type,
+            Instance<seqan::pfb::FlattenedBitvectors2L,                 512, 65536>::Type,
+            Instance<seqan::pfb::PairedFlattenedBitvectors2L,           512, 65536>::Type,
+            Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,      512, 65536>::Type,
+            Instance<seqan::pfb::FlattenedBitvectors2LWord,             512, 65536>::Type,
+            seqan::pfb::MultiBitvectorFixed,
+            seqan::pfb::WaveletMatrixFixed,
+            seqan::pfb::HuffmanWaveletTreePaired,
+            Delimiter /*delimiter, is ignored*/
+        >;
+
+        call_with_templates([&]<template <size_t> typename _String>() {
+            using String = _String<Sigma>;
+            INFO(getName<String>());
+
+            auto expected = String{text};
+            auto check = [&](String const& vec) {
+                REQUIRE(vec.size() == text.size());
+                for (size_t idx{0}; idx <= text.size(); idx += 31) {
+                    if (idx < text.size()) {
+                        CHECK(vec.symbol(idx) == text[idx]);
+                    }
+                    for (size_t symb{0}; symb < Sigma; ++symb) {
+                        CHECK(vec.rank(idx, symb) == expected.rank(idx, symb));
+                        CHECK(vec.prefix_rank(idx, symb) == expected.prefix_rank(idx, symb));
+                    }
+                }
+            };
+
+            // via stream
+            {
+                auto ss = std::stringstream{};
+                seqan::pfb::saveBinary(expected, ss);
+                auto vec = String{};
+                seqan::pfb::loadBinary(vec, ss);
+                check(vec);
+            }
+            // via file, using small chunks and multiple threads
+            {
+                auto path = std::filesystem::temp_directory_path() / "pfBitvectors_test_bulk_string.bin";
+                seqan::pfb::saveBinary(expected, path, 4, 1000);
+                auto vec = String{};
+                seqan::pfb::loadBinary(vec, path, 4, 1000);
+                std::filesystem::remove(path);
+                check(vec);
+            }
+        }, BulkStrings{});
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<4>();
+        testSigma.operator()<21>();
+        testSigma.operator()<255>();
+    }
+
+    SECTION("archives of a different type are rejected") {
+        auto text = generateText<0, 5>(100'000);
+        auto ss = std::stringstream{};
+        seqan::pfb::saveBinary(seqan::pfb::FlattenedBitvectors2L<5, 512, 65536>{text}, ss);
+        auto archive = ss.str();
+
+        auto reject = [&]<typename String>() {
+            INFO(getName<String>());
+            auto is = std::stringstream{archive};
+            auto vec = String{};
+            CHECK_THROWS_AS(seqan::pfb::loadBinary(vec, is), std::runtime_error);
+        };
+        // same element sizes as the saved string
+        reject.template operator()<seqan::pfb::PairedFlattenedBitvectors2L<5, 512, 65536>>();
+        reject.template operator()<seqan::pfb::FlattenedBitvectors2LWord<5, 512, 65536>>();
+        // different sizes of the blocks or the alphabet
+        reject.template operator()<seqan::pfb::FlattenedBitvectors2L<5, 512, 4096>>();
+        reject.template operator()<seqan::pfb::FlattenedBitvectors2L<4, 512, 65536>>();
+        reject.template operator()<seqan::pfb::FlattenedBitvectors2L32<5, 512, 65536>>();
+    }
+}
+
+TEST_CASE("check mapped strings", "[string][mmap]") {
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<0, Sigma>(200'000);
+        auto path = std::filesystem::temp_directory_path() / "pfBitvectors_test_mmap_string.bin";
+
+        auto check = [&]<typename String, typename View>() {
+            INFO(getName<String>());
+            auto expected = String{text};
+            seqan::pfb::saveBinary(expected, path);
+            auto view = View{path};
+            REQUIRE(view.size() == text.size());
+            for (size_t idx{0}; idx <= text.size(); idx += 29) {
+                if (idx < text.size()) {
+                    CHECK(view.symbol(idx) == text[idx]);
+                }
+                for (size_t symb{0}; symb < Sigma; ++symb) {
+                    CHECK(view.rank(idx, symb) == expected.rank(idx, symb));
+                    CHECK(view.prefix_rank(idx, symb) == expected.prefix_rank(idx, symb));
+                }
+                CHECK(view.all_ranks(idx) == expected.all_ranks(idx));
+                CHECK(view.template rank<Sigma-1>(idx) == expected.rank(idx, Sigma-1));
+                CHECK(view.template prefix_rank<Sigma-1>(idx) == expected.prefix_rank(idx, Sigma-1));
+            }
+            // copies share the mapping
+            auto copy = view;
+            view = View{};
+            CHECK(copy.rank(text.size(), 0) == expected.rank(text.size(), 0));
+
+            // a default constructed view is empty, but can be queried like an empty string
+            CHECK(view.size() == 0);
+            for (size_t symb{0}; symb < Sigma; ++symb) {
+                CHECK(view.rank(0, symb) == 0);
+                CHECK(view.prefix_rank(0, symb) == 0);
+            }
+        };
+        check.template operator()<seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>,
+                                  seqan::pfb::MappedFlattenedBitvectors2L<Sigma, 512, 65536>>();
+        check.template operator()<seqan::pfb::FlattenedBitvectors2L<Sigma, 64, 4096>,
+                                  seqan::pfb::MappedFlattenedBitvectors2L<Sigma, 64, 4096>>();
+        check.template operator()<seqan::pfb::FlattenedBitvectors2LWord<Sigma, 512, 65536>,
+                                  seqan::pfb::MappedFlattenedBitvectors2LWord<Sigma, 512, 65536>>();
+        check.template operator()<seqan::pfb::PairedFlattenedBitvectors2L<Sigma, 512, 65536>,
+                                  seqan::pfb::MappedPairedFlattenedBitvectors2L<Sigma, 512, 65536>>();
+        check.template operator()<seqan::pfb::PairedFlattenedBitvectors2LWord<Sigma, 512, 65536>,
+                                  seqan::pfb::MappedPairedFlattenedBitvectors2LWord<Sigma, 512, 65536>>();
+
+        #if PFBITVECTORS_SHM
+        // shared memory
+        {
+            auto expected = seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>{text};
+            auto name = "/pfBitvectors_test_shm_string_" + std::to_string(::getpid());
+            auto owner = seqan::pfb::publishShared(expected, name);
+            auto view = seqan::pfb::MappedFlattenedBitvectors2L<Sigma, 512, 65536>{seqan::pfb::attachShared(name)};
+            REQUIRE(view.size() == text.size());
+            for (size_t idx{0}; idx <= text.size(); idx += 97) {
+                CHECK(view.all_ranks(idx) == expected.all_ranks(idx));
+            }
+        }
+        #endif
+
+        // a file of a different alphabet size is rejected
+        seqan::pfb::saveBinary(seqan::pfb::FlattenedBitvectors2L<Sigma+1, 512, 65536>{}, path);
+        CHECK_THROWS_AS((seqan::pfb::MappedFlattenedBitvectors2L<Sigma, 512, 65536>{path}), std::runtime_error);
+        // same element sizes, but a different structure
+        seqan::pfb::saveBinary(seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>{text}, path);
+        CHECK_THROWS_AS((seqan::pfb::MappedPairedFlattenedBitvectors2L<Sigma, 512, 65536>{path}), std::runtime_error);
+        std::filesystem::remove(path);
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<4>();
+        testSigma.operator()<5>();
+        testSigma.operator()<21>();
+    }
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("check strings with std::pmr allocators", "[string][allocator]") {
+    auto text = generateText<0, 5>(100'000);
+
+    // any allocation not going through the given resource throws
+    struct DefaultGuard {
+        std::pmr::memory_resource* old = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        ~DefaultGuard() { std::pmr::set_default_resource(old); }
+    };
+
+    auto test = [&]<typename String, typename Expected>() {
+        INFO(getName<String>());
+        auto expected = Expected{text};
+        auto pool = std::pmr::unsynchronized_pool_resource{std::pmr::new_delete_resource()};
+        auto alloc = seqan::pfb::pmr::allocator{&pool};
+
+        auto check = [&](String const& vec) {
+            REQUIRE(vec.size() == text.size());
+            for (size_t idx{0}; idx <= text.size(); idx += 31) {
+                for (size_t symb{0}; symb < 5; ++symb) {
+                    CHECK(vec.rank(idx, symb) == expected.rank(idx, symb));
+                    CHECK(vec.prefix_rank(idx, symb) == expected.prefix_rank(idx, symb));
+                }
+            }
+        };
+
+        auto ss = std::stringstream{};
+        {
+            auto guard = DefaultGuard{};
+            auto vec = String{text, alloc};
+            check(vec);
+            seqan::pfb::saveBinary(vec, ss);
+            if constexpr (requires() { vec.get_allocator(); }) {
+                CHECK(vec.get_allocator() == alloc);
+                check(String{vec, alloc});
+            }
+        }
+        auto archive = ss.str();
+        {
+            auto guard = DefaultGuard{};
+            auto vec = String{std::span<uint8_t const>{}, alloc};
+            auto is = std::stringstream{archive};
+            seqan::pfb::loadBinary(vec, is);
+            check(vec);
+        }
+    };
+    test.template operator()<seqan::pfb::pmr::FlattenedBitvectors2L<5, 512, 65536>,            seqan::pfb::FlattenedBitvectors2L<5, 512, 65536>>();
+    test.template operator()<seqan::pfb::pmr::PairedFlattenedBitvectors2L<5, 512, 65536>,      seqan::pfb::PairedFlattenedBitvectors2L<5, 512, 65536>>();
+    test.template operator()<seqan::pfb::pmr::InterleavedFlattenedBitvectors2L<5, 512, 65536>, seqan::pfb::InterleavedFlattenedBitvectors2L<5, 512, 65536>>();
+    test.template operator()<seqan::pfb::pmr::MultiBitvector<5>,                               seqan::pfb::MultiBitvectorFixed<5>>();
+}
+#endif
+
+TEST_CASE("check l0 counter types of strings", "[string][counter]") {
+    auto text = generateText<0, 5>(70'000);
+    CHECK_NOTHROW(seqan::pfb::FlattenedBitvectors2L<5, 64, 256, true, std::bitset, uint8_t, uint32_t>{text});
+    CHECK_THROWS_AS((seqan::pfb::FlattenedBitvectors2L<5, 64, 256, true, std::bitset, uint8_t, uint16_t>{text}), std::length_error);
+    CHECK_THROWS_AS((seqan::pfb::PairedFlattenedBitvectors2L<5, 64, 256, true, std::bitset, uint8_t, uint16_t>{text}), std::length_error);
+}
+
+TEST_CASE("check space usage of strings", "[string][space]") {
+    auto text = generateText<0, 5>(100'000);
+
+    call_with_templates([&]<template <size_t> typename _String>() {
+        using String = _String<5>;
+        INFO(getName<String>());
+        auto str = String{text};
+        if constexpr (requires() { str.space_breakdown(); }) {
+            auto s = str.space_breakdown();
+            CHECK(s.total() == str.space_usage());
+            CHECK(s.bits * 8 >= text.size());
+            CHECK(s.l0 + s.l1 > 0);
+        }
+    }, AllStrings{});
+}
+
+TEST_CASE("check runtime selected strings", "[string][any]") {
+    constexpr size_t Sigma = 5;
+    auto text = generateText<0, Sigma>(100'000);
+    auto positions = std::vector<uint64_t>{};
+    auto symbols   = std::vector<uint64_t>{};
+    for (size_t i{0}; i <= text.size(); i += 7) {
+        positions.push_back(i);
+        symbols.push_back(i % Sigma);
+    }
+    auto inText = std::span{positions}.first(positions.size() - 1);
+
+    using String = seqan::pfb::AnyString<Sigma>;
+    static_assert(String::Sigma == Sigma);
+    for (auto config : String::configs()) {
+        INFO(config);
+        auto str = String{config, text};
+        auto expected = seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>{text};
+        CHECK(str.config() == config);
+        REQUIRE(str.size() == text.size());
+
+        auto out = std::vector<uint64_t>(positions.size());
+        str.symbol_batch(inText, out);
+        for (size_t j{0}; j < inText.size(); ++j) {
+            CHECK(out[j] == text[inText[j]]);
+            CHECK(str.symbol(inText[j]) == text[inText[j]]);
+        }
+        str.rank_batch(positions, symbols, out);
+        for (size_t j{0}; j < positions.size(); ++j) {
+            CHECK(out[j] == expected.rank(positions[j], symbols[j]));
+            CHECK(str.rank(positions[j], symbols[j]) == out[j]);
+        }
+        str.rank_batch(positions, 3, out);
+        for (size_t j{0}; j < positions.size(); ++j) {
+            CHECK(out[j] == expected.rank(positions[j], 3));
+        }
+        str.prefix_rank_batch(positions, symbols, out);
+        for (size_t j{0}; j < positions.size(); ++j) {
+            CHECK(out[j] == expected.prefix_rank(positions[j], symbols[j]));
+            CHECK(str.prefix_rank(positions[j], symbols[j]) == out[j]);
+        }
+        auto all = std::vector<std::array<uint64_t, Sigma>>(positions.size());
+        str.all_ranks_batch(positions, all);
+        for (size_t j{0}; j < positions.size(); ++j) {
+            CHECK(all[j] == expected.all_ranks(positions[j]));
+            CHECK(str.all_ranks(positions[j]) == all[j]);
+        }
+
+        // archives remember the configuration
+        auto ss = std::stringstream{};
+        seqan::pfb::saveBinary(str, ss);
+        auto loaded = String{};
+        seqan::pfb::loadBinary(loaded, ss);
+        CHECK(loaded.config() == config);
+        for (size_t j{0}; j < positions.size(); ++j) {
+            CHECK(loaded.rank(positions[j], symbols[j]) == expected.rank(positions[j], symbols[j]));
+        }
+    }
+
+    // same configuration names, but a different alphabet size
+    {
+        auto ss = std::stringstream{};
+        seqan::pfb::saveBinary(String{String::configs()[0], text}, ss);
+        auto other = seqan::pfb::AnyString<Sigma-1>{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(other, ss), std::runtime_error);
+    }
+    // same name and element sizes, but a different l0 block size
+    {
+        using A = seqan::pfb::AnyStringOf<seqan::pfb::Named<"str", seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>>>;
+        using B = seqan::pfb::AnyStringOf<seqan::pfb::Named<"str", seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 4096>>>;
+        auto ss = std::stringstream{};
+        seqan::pfb::saveBinary(A{"str", text}, ss);
+        auto other = B{};
+        CHECK_THROWS_AS(seqan::pfb::loadBinary(other, ss), std::runtime_error);
+    }
+}
+
+TEST_CASE("check suffix array construction", "[string][fmindex]") {
+    auto naive = [](std::vector<uint8_t> const& text) {
+        auto sa = std::vector<uint64_t>(text.size()+1);
+        std::iota(sa.begin(), sa.end(), uint64_t{0});
+        std::ranges::sort(sa, [&](uint64_t a, uint64_t b) {
+            return std::lexicographical_compare(text.begin()+a, text.end(), text.begin()+b, text.end());
+        });
+        return sa;
+    };
+    CHECK(seqan::pfb::suffix_array({}) == std::vector<uint64_t>{0});
+    CHECK(seqan::pfb::suffix_array(std::vector<uint8_t>(100, 1)) == naive(std::vector<uint8_t>(100, 1)));
+    for (size_t len : {1, 2, 17, 1000}) {
+        auto text = generateText<1, 2>(len);
+        CHECK(seqan::pfb::suffix_array(text) == naive(text));
+        text = generateText<0, 255>(len);
+        CHECK(seqan::pfb::suffix_array(text) == naive(text));
+    }
+    CHECK_THROWS_AS(seqan::pfb::bwt_from_text(std::vector<uint8_t>{1, 0, 1}), std::runtime_error);
+}
+
+TEST_CASE("check fm index backward search", "[string][fmindex]") {
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<1, Sigma-1>(20'000);
+        auto bwt  = seqan::pfb::bwt_from_text(text);
+
+        auto naiveCount = [&](std::span<uint8_t const> pattern) {
+            uint64_t ct{};
+            for (size_t i{0}; i + pattern.size() <= text.size(); ++i) {
+                ct += std::equal(pattern.begin(), pattern.end(), text.begin()+i);
+            }
+            return ct;
+        };
+
+        // substrings of the text and random patterns (mostly not occurring)
+        auto patterns = std::vector<std::vector<uint8_t>>{};
+        for (size_t i{0}; i < 100; ++i) {
+            auto len = 1 + rand() % 12;
+            auto pos = rand() % (text.size() - len);
+            patterns.emplace_back(text.begin() + pos, text.begin() + pos + len);
+            auto random = std::vector<uint8_t>(len);
+            for (auto& c : random) {
+                c = 1 + rand() % (Sigma-1);
+            }
+            patterns.push_back(random);
+        }
+        auto expected = std::vector<uint64_t>{};
+        for (auto const& p : patterns) {
+            expected.push_back(naiveCount(p));
+        }
+
+        using FMStrings = Variant<
+            Instance<seqan::pfb::FlattenedBitvectors2L,                  64, 65536>::Type,
+            Instance<seqan::pfb::FlattenedBitvectors2L,                 512, 65536>::Type,
+            Instance<seqan::pfb::PairedFlattenedBitvectors2L,           512, 65536>::Type,
+            Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,      512, 65536>::Type,
+            seqan::pfb::MultiBitvectorFixed,
+            seqan::pfb::WaveletMatrixFixed,
+            seqan::pfb::HuffmanWaveletTreePaired,
+            Delimiter /*delimiter, is ignored*/
+        >;
+
+        call_with_templates([&]<template <size_t> typename _String>() {
+            using String = _String<Sigma>;
+            INFO(getName<String>());
+
+            auto index = seqan::pfb::FMIndex<String>{seqan::pfb::from_bwt, bwt};
+            REQUIRE(index.size() == text.size() + 1);
+            CHECK(index.count({}) == text.size() + 1);
+            for (size_t i{0}; i < patterns.size(); ++i) {
+                INFO(i);
+                CHECK(index.count(patterns[i]) == expected[i]);
+            }
+
+            // extending by all symbols is the same as extending by each symbol
+            auto interval = index.search(patterns[0]);
+            auto all = index.extend_left_all(interval);
+            CHECK(all[0].empty());
+            for (size_t s{1}; s < Sigma; ++s) {
+                CHECK(all[s] == index.extend_left(interval, s));
+            }
+
+            // patterns with the sentinel or symbols outside of the alphabet do not occur
+            auto invalid = patterns[0];
+            invalid.back() = 0;
+            CHECK(index.search(invalid).empty());
+            invalid.back() = Sigma;
+            CHECK(index.search(invalid).empty());
+
+            // the constructor from the text builds the same index
+            auto fromText = seqan::pfb::FMIndex<String>{text};
+            CHECK(fromText.C == index.C);
+            CHECK(fromText.count(patterns[0]) == expected[0]);
+        }, FMStrings{});
+
+        // archives
+        using String = seqan::pfb::FlattenedBitvectors2L<Sigma, 512, 65536>;
+        auto index = seqan::pfb::FMIndex<String>{seqan::pfb::from_bwt, bwt};
+        auto ss = std::stringstream{};
+        seqan::pfb::saveBinary(index, ss);
+        auto loaded = seqan::pfb::FMIndex<String>{};
+        seqan::pfb::loadBinary(loaded, ss);
+        CHECK(loaded.C == index.C);
+        for (size_t i{0}; i < patterns.size(); ++i) {
+            CHECK(loaded.count(patterns[i]) == expected[i]);
+        }
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<3>();
+        testSigma.operator()<5>();
+        testSigma.operator()<21>();
+    }
+}
+
+TEST_CASE("check bidirectional fm index and search schemes", "[string][fmindex][bidirectional]") {
+    SECTION("schemes cover all error distributions") {
+        // every distribution of at most k errors over the parts is accepted by at least one search
+        auto covers = [](seqan::pfb::SearchScheme const& scheme, size_t k) {
+            auto parts = scheme[0].pi.size();
+            auto errors = std::vector<size_t>(parts);
+            while (true) {
+                size_t total{};
+                for (auto e : errors) total += e;
+                if (total <= k) {
+                    auto found = std::ranges::any_of(scheme, [&](seqan::pfb::Search const& s) {
+                        size_t sum{};
+                        for (size_t j{0}; j < parts; ++j) {
+                            sum += errors[s.pi[j]];
+                            if (sum < s.l[j] || sum > s.u[j]) return false;
+                        }
+                        return true;
+                    });
+                    if (!found) return false;
+                }
+                // next distribution
+                size_t i{0};
+                while (i < parts && errors[i] == k) {
+                    errors[i] = 0;
+                    ++i;
+                }
+                if (i == parts) return true;
+                errors[i] += 1;
+            }
+        };
+        for (size_t k{0}; k <= 4; ++k) {
+            INFO(k);
+            CHECK(covers(seqan::pfb::backtracking_scheme(k), k));
+            CHECK(covers(seqan::pfb::pigeonhole_scheme(k), k));
+            CHECK(covers(seqan::pfb::kucherov_scheme(k), k));
+        }
+    }
+
+    auto testSigma = []<size_t Sigma>() {
+        INFO("Sigma " << Sigma);
+        auto text = generateText<1, Sigma-1>(5'000);
+        auto reversed = std::vector<uint8_t>(text.rbegin(), text.rend());
+        auto bwt    = seqan::pfb::bwt_from_text(text);
+        auto bwtRev = seqan::pfb::bwt_from_text(reversed);
+
+        // occurrences with at most k substitutions
+        auto naiveCount = [&](std::span<uint8_t const> pattern, size_t k) {
+            uint64_t ct{};
+            for (size_t i{0}; i + pattern.size() <= text.size(); ++i) {
+                size_t errors{};
+                for (size_t j{0}; j < pattern.size() && errors <= k; ++j) {
+                    errors += pattern[j] != text[i+j];
+                }
+                ct += errors <= k;
+            }
+            return ct;
+        };
+        auto patterns = std::vector<std::vector<uint8_t>>{};
+        for (size_t i{0}; i < 20; ++i) {
+            auto len = 1 + rand() % 10;
+            auto pos = rand() % (text.size() - len);
+            patterns.emplace_back(text.begin() + pos, text.begin() + pos + len);
+            patterns.back()[rand() % len] = 1 + rand() % (Sigma-1);
+        }
+
+        using BiStrings = Variant<
+            Instance<seqan::pfb::FlattenedBitvectors2L,             512, 65536>::Type,
+            Instance<seqan::pfb::PairedFlattenedBitvectors2L,       512, 65536>::Type,
+            Instance<seqan::pfb::InterleavedFlattenedBitvectors2L,  512, 65536>::Type,
+            seqan::pfb::MultiBitvectorFixed,
+            seqan::pfb::WaveletMatrixFixed,
+            Delimiter /*delimiter, is ignored*/
+        >;
+
+        call_with_templates([&]<template <size_t> typename _String>() {
+            using String = _String<Sigma>;
+            INFO(getName<String>());
+
+            auto index    = seqan::pfb::BiFMIndex<String>{seqan::pfb::from_bwt, bwt, bwtRev};
+            auto fwdIndex = seqan::pfb::FMIndex<String>{seqan::pfb::from_bwt, bwt};
+            auto revIndex = seqan::pfb::FMIndex<String>{seqan::pfb::from_bwt, bwtRev};
+
+            for (auto const& pattern : patterns) {
+                auto revPattern = std::vector<uint8_t>(pattern.rbegin(), pattern.rend());
+                auto expected = seqan::pfb::BiSAInterval{
+                    fwdIndex.search(pattern).lb,
+                    revIndex.search(revPattern).lb,
+                    fwdIndex.count(pattern)
+                };
+                if (expected.empty()) continue;
+
+                // extending right only, left only and alternating
+                auto right = index.all();
+                for (auto c : pattern) {
+                    right = index.extend_right(right, c);
+                }
+                CHECK(right == expected);
+                CHECK(index.search(pattern) == expected);
+
+                auto alternating = index.all();
+                size_t lb{pattern.size() / 2}, ub{pattern.size() / 2};
+                for (size_t i{0}; i < pattern.size(); ++i) {
+                    if (i % 2 == 0 && ub < pattern.size()) {
+                        auto all = index.extend_right_all(alternating);
+                        alternating = index.extend_right(alternating, pattern[ub]);
+                        CHECK(all[pattern[ub]] == alternating);
+                        ub += 1;
+                    } else {
+                        auto all = index.extend_left_all(alternating);
+                        alternating = index.extend_left(alternating, pattern[lb-1]);
+                        CHECK(all[pattern[lb-1]] == alternating);
+                        lb -= 1;
+                    }
+                }
+                CHECK(alternating == expected);
+            }
+
+            // symbols outside of the alphabet are only matched by substitutions
+            auto invalid = patterns[0];
+            invalid.back() = Sigma;
+            CHECK(index.search(invalid).empty());
+            for (auto const& scheme : {seqan::pfb::kucherov_scheme(1), seqan::pfb::backtracking_scheme(1)}) {
+                auto found = std::vector<seqan::pfb::BiSAInterval>{};
+                seqan::pfb::search_hamming(index, invalid, scheme, [&](seqan::pfb::BiSAInterval interval, size_t errors) {
+                    CHECK(errors == 1);
+                    found.push_back(interval);
+                });
+                std::ranges::sort(found, {}, &seqan::pfb::BiSAInterval::lb);
+                auto [first, last] = std::ranges::unique(found, {}, &seqan::pfb::BiSAInterval::lb);
+                found.erase(first, last);
+                uint64_t ct{};
+                for (auto const& i : found) ct += i.size();
+                CHECK(ct == naiveCount(invalid, 1));
+            }
+
+            // approximate search, intervals of the same string found by different searches are counted once
+            for (size_t k{0}; k <= 2; ++k) {
+                INFO("k " << k);
+                for (auto const& scheme : {seqan::pfb::kucherov_scheme(k), seqan::pfb::pigeonhole_scheme(k), seqan::pfb::backtracking_scheme(k)}) {
+                    for (auto const& pattern : patterns) {
+                        auto found = std::vector<seqan::pfb::BiSAInterval>{};
+                        seqan::pfb::search_hamming(index, pattern, scheme, [&](seqan::pfb::BiSAInterval interval, size_t errors) {
+                            CHECK(errors <= k);
+                            found.push_back(interval);
+                        });
+                        std::ranges::sort(found, {}, &seqan::pfb::BiSAInterval::lb);
+                        auto [first, last] = std::ranges::unique(found, {}, &seqan::pfb::BiSAInterval::lb);
+                        found.erase(first, last);
+                        uint64_t ct{};
+                        for (auto const& i : found) ct += i.size();
+                        CHECK(ct == naiveCount(pattern, k));
+                    }
+                }
+            }
+        }, BiStrings{});
+    };
+
+    SECTION("test different sizes of alphabets") {
+        testSigma.operator()<3>();
+        testSigma.operator()<5>();
+        testSigma.operator()<21>();
+    }
+}